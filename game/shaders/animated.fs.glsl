@@ -5,6 +5,11 @@ in vec2 texcoord;
 
 // Application data
 uniform sampler2D sampler0;
+uniform vec4 uv_rect; // where the texture is on its atlas page, xy offset and zw size
+
+vec2 atlasCoords(vec2 uv) {
+	return uv_rect.xy + uv * uv_rect.zw;
+}
 uniform vec3 fcolor;
 
 uniform float current_frame;
@@ -30,7 +35,7 @@ vec2 getFrameTexcoords() {
 void main()
 {
 	vec2 frame_coords = getFrameTexcoords();
-	color = vec4(fcolor, 1.0) * texture(sampler0, frame_coords);
+	color = vec4(fcolor, 1.0) * texture(sampler0, atlasCoords(frame_coords));
 
 	if (is_hitflash) {
 		color.xyz = vec3(1.0, 1.0, 1.0);
@@ -5,6 +5,11 @@ in vec2 texcoord;
 
 // Application data
 uniform sampler2D sampler0;
+uniform vec4 uv_rect; // where the texture is on its atlas page, xy offset and zw size
+
+vec2 atlasCoords(vec2 uv) {
+	return uv_rect.xy + uv * uv_rect.zw;
+}
 uniform vec3 fcolor;
 
 uniform float current_frame;
@@ -18,17 +23,17 @@ bool is_outline(vec2 frame_coords) {
 
     // Munn: The following code was taken from: http://blogs.love2d.org/content/let-it-glow-dynamically-adding-outlines-characters
 	bool is_transparent = true;
-    float alpha = 4*texture( sampler0, frame_coords ).a;
+    float alpha = 4*texture( sampler0, atlasCoords(frame_coords)).a;
     if (alpha > 0.0) {
         is_transparent = false;
     }
 
     float outline_size_x = 1.0f / texture_size.x; // TODO: maybe also add an outline size parameter?
     float outline_size_y = 1.0f / texture_size.y;
-    alpha += texture( sampler0, frame_coords + vec2( outline_size_x, 0.0f ) ).a;
-    alpha += texture( sampler0, frame_coords + vec2( -outline_size_x, 0.0f ) ).a;
-    alpha += texture( sampler0, frame_coords + vec2( 0.0f, outline_size_y ) ).a;
-    alpha += texture( sampler0, frame_coords + vec2( 0.0f, -outline_size_y ) ).a;
+    alpha += texture( sampler0, atlasCoords(frame_coords + vec2( outline_size_x, 0.0f ))).a;
+    alpha += texture( sampler0, atlasCoords(frame_coords + vec2( -outline_size_x, 0.0f ))).a;
+    alpha += texture( sampler0, atlasCoords(frame_coords + vec2( 0.0f, outline_size_y ))).a;
+    alpha += texture( sampler0, atlasCoords(frame_coords + vec2( 0.0f, -outline_size_y ))).a;
     
     return is_transparent && alpha > 0.0;
 }
@@ -50,7 +55,7 @@ vec2 getFrameTexcoords() {
 void main()
 {
 	vec2 frame_coords = getFrameTexcoords();
-	color = vec4(fcolor, 1.0) * texture(sampler0, frame_coords);
+	color = vec4(fcolor, 1.0) * texture(sampler0, atlasCoords(frame_coords));
 
     if (is_outline(frame_coords) && is_outline_active) { // if it is part of the outline
         color = vec4(1.0, 1.0, 1.0, 1.0);
@@ -6,6 +6,11 @@ in vec2 tilecoord;
 
 // Application data
 uniform sampler2D sampler0;
+uniform vec4 uv_rect; // where the texture is on its atlas page, xy offset and zw size
+
+vec2 atlasCoords(vec2 uv) {
+	return uv_rect.xy + uv * uv_rect.zw;
+}
 
 // Output color
 uniform float h_tiles;
@@ -25,5 +30,5 @@ vec2 getRandomTexcoords() {
 void main()
 {
 	vec2 rand_texcoord = getRandomTexcoords();
-	color = texture(sampler0, vec2(rand_texcoord.x, rand_texcoord.y));
+	color = texture(sampler0, atlasCoords(vec2(rand_texcoord.x, rand_texcoord.y)));
 }
@@ -5,7 +5,7 @@ layout (location = 0) in vec3 in_position;
 layout (location = 1) in vec2 in_texcoord;
 layout (location = 2) in mat3 instance_matrix;
 
-in vec2 in_tilecoord;
+layout (location = 5) in vec2 in_tilecoord;
 
 // Passed to fragment shader
 out vec2 texcoord;
@@ -6,6 +6,11 @@ in vec2 texcoord;
 // Application data
 uniform float health_percent;
 uniform sampler2D sampler0;
+uniform vec4 uv_rect; // where the texture is on its atlas page, xy offset and zw size
+
+vec2 atlasCoords(vec2 uv) {
+	return uv_rect.xy + uv * uv_rect.zw;
+}
 uniform vec3 fcolor;
 
 // Output color
@@ -13,5 +18,5 @@ layout(location = 0) out  vec4 color;
 
 void main()
 {
-	color = vec4(fcolor, 1.0) * texture(sampler0, vec2(texcoord.x * health_percent, texcoord.y));
+	color = vec4(fcolor, 1.0) * texture(sampler0, atlasCoords(vec2(texcoord.x * health_percent, texcoord.y)));
 }
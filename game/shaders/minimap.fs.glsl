@@ -5,31 +5,43 @@ in vec2 texcoord;
 
 // Application data
 uniform sampler2D sampler0;
+uniform vec4 uv_rect; // where the texture is on its atlas page, xy offset and zw size
+
+vec2 atlasCoords(vec2 uv) {
+	return uv_rect.xy + uv * uv_rect.zw;
+}
 uniform vec3 fcolor;
 
-#define MAX_WALLS 1000
-uniform vec2 revealed_walls[MAX_WALLS];
-uniform float num_x_tiles;
-uniform float num_y_tiles;
-uniform float num_revealed_walls;
+// One texel per tile of the map, red is 1 once the tile has been revealed
+uniform sampler2D revealed_tiles;
+uniform float num_tiles;
 
 // Output color
 layout(location = 0) out vec4 color;
 
+// Revealed walls are drawn as a dot this big around the corner of their tile, in tiles
+const float WALL_RADIUS = 0.75;
 
-const float RANGE_DIFF = 0.0075;
+float isRevealed(ivec2 tile) {
+	if (tile.x < 0 || tile.y < 0 || tile.x >= int(num_tiles) || tile.y >= int(num_tiles)) {
+		return 0.0;
+	}
+	return texelFetch(revealed_tiles, tile, 0).r;
+}
 
 void main()
 {
-	color = vec4(fcolor, 0.0) * texture(sampler0, vec2(texcoord.x, texcoord.y));
-
-	for (int i = 0; i < num_revealed_walls; i++) {
-		vec2 wall = revealed_walls[i];
-
-		vec2 tex_pos = vec2(wall.x / num_x_tiles, wall.y / num_y_tiles);
-
-		if (distance(tex_pos, texcoord) < RANGE_DIFF) {
-			color.a = 1.0;
+	color = vec4(fcolor, 0.0) * texture(sampler0, atlasCoords(vec2(texcoord.x, texcoord.y)));
+
+	// The dot is smaller than a tile, so only the 4 tile corners around this pixel can reach it
+	vec2 pos = texcoord * num_tiles;
+	ivec2 corner = ivec2(floor(pos));
+	for (int y = 0; y <= 1; y++) {
+		for (int x = 0; x <= 1; x++) {
+			ivec2 tile = corner + ivec2(x, y);
+			if (distance(vec2(tile), pos) < WALL_RADIUS && isRevealed(tile) > 0.5) {
+				color.a = 1.0;
+			}
 		}
 	}
 }
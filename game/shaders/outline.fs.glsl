@@ -5,6 +5,11 @@ in vec2 texcoord;
 
 // Application data
 uniform sampler2D sampler0;
+uniform vec4 uv_rect; // where the texture is on its atlas page, xy offset and zw size
+
+vec2 atlasCoords(vec2 uv) {
+	return uv_rect.xy + uv * uv_rect.zw;
+}
 uniform vec3 fcolor;
 uniform vec2 texture_size;
 uniform bool is_outline_active;
@@ -19,17 +24,17 @@ bool is_outline() {
 
     // Munn: The following code was taken from: http://blogs.love2d.org/content/let-it-glow-dynamically-adding-outlines-characters
 	bool is_transparent = true;
-    float alpha = 4*texture( sampler0, texcoord ).a;
+    float alpha = 4*texture( sampler0, atlasCoords(texcoord)).a;
     if (alpha > 0.0) {
         is_transparent = false;
     }
 
     float outline_size_x = 1.0f / texture_size.x; // TODO: maybe also add an outline size parameter?
     float outline_size_y = 1.0f / texture_size.y;
-    alpha += texture( sampler0, texcoord + vec2( outline_size_x, 0.0f ) ).a;
-    alpha += texture( sampler0, texcoord + vec2( -outline_size_x, 0.0f ) ).a;
-    alpha += texture( sampler0, texcoord + vec2( 0.0f, outline_size_y ) ).a;
-    alpha += texture( sampler0, texcoord + vec2( 0.0f, -outline_size_y ) ).a;
+    alpha += texture( sampler0, atlasCoords(texcoord + vec2( outline_size_x, 0.0f ))).a;
+    alpha += texture( sampler0, atlasCoords(texcoord + vec2( -outline_size_x, 0.0f ))).a;
+    alpha += texture( sampler0, atlasCoords(texcoord + vec2( 0.0f, outline_size_y ))).a;
+    alpha += texture( sampler0, atlasCoords(texcoord + vec2( 0.0f, -outline_size_y ))).a;
     
     return is_transparent && alpha > 0.0;
 }
@@ -42,7 +47,7 @@ bool is_outline() {
 
 void main()
 {
-    color = texture(sampler0, texcoord);
+    color = texture(sampler0, atlasCoords(texcoord));
 
 
     if (is_outline() && is_outline_active) { // if it is part of the outline
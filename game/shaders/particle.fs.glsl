@@ -13,4 +13,4 @@ layout(location = 0) out  vec4 color;
 void main()
 {
 	color = texture(sampler0, texcoord) * fcolor;
-}
+}
\ No newline at end of file
@@ -2,10 +2,13 @@
 #version 330
 
 // Input attributes
-in vec3 in_position;
-in vec2 in_texcoord;
-in mat3 in_transform_matrix;
-in vec4 in_color;
+layout (location = 0) in vec3 in_position;
+layout (location = 1) in vec2 in_texcoord;
+
+// Per instance, see ParticleInfo
+layout (location = 2) in mat3 in_transform_matrix;
+layout (location = 5) in vec4 in_color;
+layout (location = 6) in vec4 in_uv_rect; // where the texture is on its atlas page, xy offset and zw size
 
 // Passed to fragment shader
 out vec2 texcoord;
@@ -16,7 +19,7 @@ uniform mat3 projection;
 
 void main()
 {
-    texcoord = in_texcoord;
+    texcoord = in_uv_rect.xy + in_texcoord * in_uv_rect.zw;
 	fcolor = in_color;
 	vec3 pos = projection * in_transform_matrix * vec3(in_position.xy, 1.0);
 	gl_Position = vec4(pos.xy, in_position.z, 1.0);
@@ -0,0 +1,21 @@
+#version 330
+
+// From vertex shader
+in vec2 texcoord;
+in vec3 fcolor;
+flat in int is_hitflash;
+
+// Application data
+uniform sampler2D sampler0;
+
+// Output color
+layout(location = 0) out  vec4 color;
+
+void main()
+{
+	color = vec4(fcolor, 1.0) * texture(sampler0, texcoord);
+
+	if (is_hitflash != 0) {
+		color.xyz = vec3(1.0, 1.0, 1.0);
+	}
+}
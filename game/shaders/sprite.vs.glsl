@@ -0,0 +1,38 @@
+#version 330
+
+// Input attributes
+layout (location = 0) in vec3 in_position;
+layout (location = 1) in vec2 in_texcoord;
+
+// Per instance, see SpriteInfo
+layout (location = 2) in mat3 in_transform_matrix;
+layout (location = 5) in vec3 in_color;
+layout (location = 6) in vec4 in_frame; // h_frames, v_frames, current_frame, is_hitflash
+layout (location = 7) in vec4 in_uv_rect; // where the texture is on its atlas page, xy offset and zw size
+
+// Passed to fragment shader
+out vec2 texcoord;
+out vec3 fcolor;
+flat out int is_hitflash;
+
+// Application data
+uniform mat3 projection;
+
+void main()
+{
+	float h_frames = in_frame.x;
+	float v_frames = in_frame.y;
+	float current_frame = in_frame.z;
+
+	// Same frame math as the animated shader, a plain textured sprite is a single frame
+	float current_h = float(int(current_frame) % int(h_frames));
+	float current_v = float(int(current_frame) / int(h_frames));
+	vec2 frame_texcoord = vec2((in_texcoord.x + current_h) / h_frames, (in_texcoord.y + current_v) / v_frames);
+	texcoord = in_uv_rect.xy + frame_texcoord * in_uv_rect.zw;
+
+	fcolor = in_color;
+	is_hitflash = int(in_frame.w);
+
+	vec3 pos = projection * in_transform_matrix * vec3(in_position.x / h_frames, in_position.y / v_frames, 1.0);
+	gl_Position = vec4(pos.xy, in_position.z, 1.0);
+}
@@ -5,6 +5,11 @@ in vec2 texcoord;
 
 // Application data
 uniform sampler2D sampler0;
+uniform vec4 uv_rect; // where the texture is on its atlas page, xy offset and zw size
+
+vec2 atlasCoords(vec2 uv) {
+	return uv_rect.xy + uv * uv_rect.zw;
+}
 uniform vec3 fcolor;
 
 uniform bool is_hitflash;
@@ -14,7 +19,7 @@ layout(location = 0) out  vec4 color;
 
 void main()
 {
-	color = vec4(fcolor, 1.0) * texture(sampler0, vec2(texcoord.x, texcoord.y));
+	color = vec4(fcolor, 1.0) * texture(sampler0, atlasCoords(vec2(texcoord.x, texcoord.y)));
 
 	if (is_hitflash) {
 		color.xyz = vec3(1.0, 1.0, 1.0);
@@ -5,6 +5,11 @@ in vec2 texcoord;
 
 // Application data
 uniform sampler2D sampler0;
+uniform vec4 uv_rect; // where the texture is on its atlas page, xy offset and zw size
+
+vec2 atlasCoords(vec2 uv) {
+	return uv_rect.xy + uv * uv_rect.zw;
+}
 
 // Output color
 uniform float h_tiles;
@@ -26,7 +31,7 @@ vec2 getTileTexcoords() {
 void main()
 {
 	vec2 tile_texcoord = getTileTexcoords();
-	color = texture(sampler0, tile_texcoord);
+	color = texture(sampler0, atlasCoords(tile_texcoord));
 
 	if (is_hitflash) {
 		color.xyz = vec3(1.0, 1.0, 1.0);
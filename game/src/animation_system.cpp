@@ -4,24 +4,29 @@
 #include "tinyECS/tiny_ecs.hpp"
 #include "tinyECS/components.hpp"
 #include "tinyECS/registry.hpp"
+#include "job_system.hpp"
 #include <iostream>
 
-void AnimationSystem::step(float elapsed_ms) {
-	for (Entity animated_entity : registry.animation_managers.entities) {
-		if (!registry.renderRequests.has(animated_entity)) {
-			continue;
-		}
+const int ANIMATION_JOB_SIZE = 256; // entities per job
 
-		float stepSeconds = elapsed_ms / 1000.0f;
+SystemAccess AnimationSystem::getAccess() const {
+	SystemAccess access;
+	access.writes = { &registry.animation_managers, &registry.renderRequests };
+	return access;
+}
+
+void AnimationSystem::step(float elapsed_ms) {
+	float stepSeconds = elapsed_ms / 1000.0f;
 
-		AnimationManager& animation_manager = registry.animation_managers.get(animated_entity);
+	// Every entity only touches its own animation, so the entities are split over the job threads
+	auto view = registry.view<AnimationManager, RenderRequest>();
+	auto step_animation = [&](Entity animated_entity, AnimationManager& animation_manager, RenderRequest& render_request) {
 		Animation& animation = animation_manager.current_animation;
-		RenderRequest& render_request = registry.renderRequests.get(animated_entity);
 
 		render_request.used_texture = animation.asset_id;
 
 		if (animation.is_paused) {
-			continue;
+			return;
 		}
 
 		animation.current_time += stepSeconds * animation.frame_rate;
@@ -34,5 +39,8 @@ void AnimationSystem::step(float elapsed_ms) {
 				animation.current_time = animation.num_frames - 1;
 			}
 		}
-	}
-}
\ No newline at end of file
+	};
+	job_system.parallel_for((int)view.size(), ANIMATION_JOB_SIZE, [&](int begin, int end) {
+		view.each_in_range(begin, end, step_animation);
+	});
+}
@@ -4,10 +4,13 @@
 #include "tinyECS/tiny_ecs.hpp"
 #include "tinyECS/components.hpp"
 #include "tinyECS/registry.hpp"
+#include "system_scheduler.hpp"
 
 class AnimationSystem {
 public: 
 	void step(float elapsed_ms);
 
+	SystemAccess getAccess() const;
+
 	AnimationSystem() {}
 };
\ No newline at end of file
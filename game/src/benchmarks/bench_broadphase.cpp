@@ -0,0 +1,87 @@
+#include "bench_common.hpp"
+
+// stdlib
+#include <cmath>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+// internal
+#include "broadphase.hpp"
+
+namespace {
+	// The loop PhysicsSystem::step had before the grid, every hitbox against every later one
+	void findPairsAllPairs(const std::vector<BroadphaseProxy>& proxies, std::vector<std::pair<int, int>>& out_pairs) {
+		out_pairs.clear();
+		for (int a = 0; a < (int)proxies.size(); a++) {
+			const BroadphaseProxy& proxy_a = proxies[a];
+			for (int b = a + 1; b < (int)proxies.size(); b++) {
+				const BroadphaseProxy& proxy_b = proxies[b];
+				if ((proxy_a.layer & proxy_b.mask) == 0 && (proxy_b.layer & proxy_a.mask) == 0) {
+					continue;
+				}
+				if (proxy_a.max.x < proxy_b.min.x || proxy_b.max.x < proxy_a.min.x ||
+					proxy_a.max.y < proxy_b.min.y || proxy_b.max.y < proxy_a.min.y) {
+					continue;
+				}
+				out_pairs.push_back({ a, b });
+			}
+		}
+	}
+
+	// Boxes of half a tile to two tiles over a square with room for about 4 tiles per box, so the density (and the
+	// number of pairs per box) is the same at every size. Layers and masks are random single bits out of the first 4
+	void makeBoxes(int num_boxes, std::mt19937& random, std::vector<BroadphaseProxy>& out_proxies) {
+		std::uniform_real_distribution<float> unit(0.f, 1.f);
+		float side = std::sqrt((float)num_boxes * 4.f) * TILE_SIZE;
+		out_proxies.clear();
+		for (int i = 0; i < num_boxes; i++) {
+			vec2 size = vec2(0.5f + 1.5f * unit(random), 0.5f + 1.5f * unit(random)) * (float)TILE_SIZE;
+			vec2 min = vec2(unit(random), unit(random)) * side;
+			int layer = 1 << (int)(unit(random) * 4);
+			int mask = (1 << (int)(unit(random) * 4)) | (1 << (int)(unit(random) * 4));
+			out_proxies.push_back({ Entity(0), min, min + size, layer, mask });
+		}
+	}
+}
+
+bool benchBroadphase(const BenchOptions& options) {
+	const int sizes[] = { 100, 1000, 10000 };
+	const int default_reps[] = { 1000, 50, 3 };
+
+	std::mt19937 random(options.seed);
+	std::vector<BroadphaseProxy> proxies;
+	std::vector<std::pair<int, int>> grid_pairs;
+	std::vector<std::pair<int, int>> all_pairs;
+	BroadphaseGrid grid;
+	bool is_matching = true;
+
+	std::printf("%8s %8s %14s %14s %8s\n", "boxes", "pairs", "grid ms", "all pairs ms", "match");
+	for (int s = 0; s < 3; s++) {
+		makeBoxes(sizes[s], random, proxies);
+		int reps = options.repsOr(default_reps[s]);
+
+		// Rebuilt from scratch every rep, same as every physics step
+		auto start = BenchClock::now();
+		for (int rep = 0; rep < reps; rep++) {
+			grid.clear();
+			for (const BroadphaseProxy& proxy : proxies) {
+				grid.insert(proxy.entity, proxy.min, proxy.max, proxy.layer, proxy.mask);
+			}
+			grid.build();
+			grid.findPairs(grid_pairs);
+		}
+		double grid_ms = msSince(start) / reps;
+
+		start = BenchClock::now();
+		for (int rep = 0; rep < reps; rep++) {
+			findPairsAllPairs(proxies, all_pairs);
+		}
+		double all_pairs_ms = msSince(start) / reps;
+
+		bool is_same = grid_pairs == all_pairs;
+		is_matching = is_matching && is_same;
+		std::printf("%8d %8zu %14.4f %14.4f %8s\n", sizes[s], all_pairs.size(), grid_ms, all_pairs_ms, is_same ? "yes" : "NO");
+	}
+	return is_matching;
+}
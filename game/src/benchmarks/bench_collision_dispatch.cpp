@@ -0,0 +1,227 @@
+#include "bench_common.hpp"
+
+// stdlib
+#include <algorithm>
+#include <cstdio>
+#include <set>
+#include <vector>
+
+// internal
+#include "collision_events.hpp"
+#include "tinyECS/registry.hpp"
+
+// Collision handling before the event queue: every collision was a component added with emplace_with_duplicates, and
+// handle_collisions found the handler by probing component containers until one matched. Against the event queue and
+// the layer table WorldSystem uses now. The handlers only count what they were called with, so this is the cost of
+// recording and routing the collisions, not of handling them.
+namespace {
+	enum HANDLER {
+		PROJECTILE_ENEMY, PROJECTILE_PLAYER, PROJECTILE_WALL, WALL_ENEMY, WALL_PLAYER, PLAYER_ENEMY, NUM_HANDLERS
+	};
+
+	// Calls per handler, and a sum over the entities it got in which order
+	struct HandlerCounts {
+		long long calls[NUM_HANDLERS] = {};
+		long long order_sum[NUM_HANDLERS] = {};
+
+		void count(HANDLER handler, Entity first, Entity second) {
+			calls[handler]++;
+			order_sum[handler] += (long long)first.index() * 3 + second.index();
+		}
+		bool operator==(const HandlerCounts& other) const {
+			for (int i = 0; i < NUM_HANDLERS; i++) {
+				if (calls[i] != other.calls[i] || order_sum[i] != other.order_sum[i]) {
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	struct OldCollision {
+		Entity other = 0;
+		OldCollision(Entity other) : other(other) {}
+	};
+
+	// The if/else chain handle_collisions had, cut down to the pairs generated here but in the same order
+	void dispatchByChain(ComponentContainer<OldCollision>& collisions, HandlerCounts& counts) {
+		for (uint i = 0; i < collisions.size(); i++) {
+			Entity collision_entity = collisions.entities[i];
+			Entity other_entity = collisions.components[i].other;
+
+			if (registry.projectiles.has(collision_entity) && registry.enemies.has(other_entity))
+				counts.count(PROJECTILE_ENEMY, collision_entity, other_entity);
+			else if (registry.enemies.has(collision_entity) && registry.projectiles.has(other_entity))
+				counts.count(PROJECTILE_ENEMY, other_entity, collision_entity);
+			else if (registry.projectiles.has(collision_entity) && registry.players.has(other_entity))
+				counts.count(PROJECTILE_PLAYER, collision_entity, other_entity);
+			else if (registry.players.has(collision_entity) && registry.projectiles.has(other_entity))
+				counts.count(PROJECTILE_PLAYER, other_entity, collision_entity);
+			else if (registry.projectiles.has(collision_entity) && registry.wallCollisions.has(other_entity))
+				counts.count(PROJECTILE_WALL, collision_entity, other_entity);
+			else if (registry.wallCollisions.has(collision_entity) && registry.projectiles.has(other_entity))
+				counts.count(PROJECTILE_WALL, other_entity, collision_entity);
+			else if (registry.projectiles.has(collision_entity) && registry.chests.has(other_entity))
+				continue;
+			else if (registry.chests.has(collision_entity) && registry.projectiles.has(other_entity))
+				continue;
+			else if (registry.wallCollisions.has(collision_entity) && registry.enemies.has(other_entity))
+				counts.count(WALL_ENEMY, collision_entity, other_entity);
+			else if (registry.enemies.has(collision_entity) && registry.wallCollisions.has(other_entity))
+				counts.count(WALL_ENEMY, other_entity, collision_entity);
+			else if (registry.wallCollisions.has(collision_entity) && registry.players.has(other_entity))
+				counts.count(WALL_PLAYER, collision_entity, other_entity);
+			else if (registry.players.has(collision_entity) && registry.wallCollisions.has(other_entity))
+				counts.count(WALL_PLAYER, other_entity, collision_entity);
+			else if (registry.players.has(collision_entity) && registry.enemies.has(other_entity))
+				counts.count(PLAYER_ENEMY, collision_entity, other_entity);
+			else if (registry.enemies.has(collision_entity) && registry.players.has(other_entity))
+				counts.count(PLAYER_ENEMY, other_entity, collision_entity);
+		}
+	}
+
+	// Same shape as WorldSystem::collision_handlers, including the has() the handlers of shared layers make
+	struct Dispatch {
+		HANDLER handler = NUM_HANDLERS;
+		bool is_swapped = false;
+		ComponentContainer<Enemy*, SparseEntityIndex>* enemies_only = nullptr;
+	};
+	Dispatch dispatch_table[NUM_COLLISION_LAYER_SLOTS][NUM_COLLISION_LAYER_SLOTS];
+
+	void setDispatch(COLLISION_LAYER first_layer, COLLISION_LAYER second_layer, HANDLER handler, bool is_enemy_checked) {
+		int first = collisionLayerIndex((int)first_layer);
+		int second = collisionLayerIndex((int)second_layer);
+		ComponentContainer<Enemy*, SparseEntityIndex>* enemies_only = is_enemy_checked ? &registry.enemies : nullptr;
+		dispatch_table[first][second] = { handler, false, enemies_only };
+		dispatch_table[second][first] = { handler, true, enemies_only };
+	}
+
+	void dispatchByTable(const CollisionEventQueue& queue, HandlerCounts& counts) {
+		for (const CollisionEvent& event : queue.getEvents()) {
+			const Dispatch& dispatch = dispatch_table[collisionLayerIndex(event.layer_a)][collisionLayerIndex(event.layer_b)];
+			if (dispatch.handler == NUM_HANDLERS) {
+				continue;
+			}
+			Entity first = dispatch.is_swapped ? event.b : event.a;
+			Entity second = dispatch.is_swapped ? event.a : event.b;
+			if (dispatch.enemies_only != nullptr && !dispatch.enemies_only->has(second)) {
+				continue;
+			}
+			counts.count(dispatch.handler, first, second);
+		}
+	}
+}
+
+bool benchCollisionDispatch(const BenchOptions& options) {
+	const int NUM_EVENTS = 10000;
+	const int NUM_PROJECTILES = 2000;
+	const int NUM_ENEMIES = 500;
+	const int NUM_WALLS = 2000;
+	int reps = options.repsOr(200);
+
+	for (COLLISION_LAYER projectile_layer : { COLLISION_LAYER::P_PROJECTILE, COLLISION_LAYER::E_PROJECTILE }) {
+		setDispatch(projectile_layer, COLLISION_LAYER::ENEMY, PROJECTILE_ENEMY, true);
+		setDispatch(projectile_layer, COLLISION_LAYER::PLAYER, PROJECTILE_PLAYER, false);
+		setDispatch(projectile_layer, COLLISION_LAYER::WALL, PROJECTILE_WALL, false);
+	}
+	setDispatch(COLLISION_LAYER::WALL, COLLISION_LAYER::ENEMY, WALL_ENEMY, true);
+	setDispatch(COLLISION_LAYER::WALL, COLLISION_LAYER::PLAYER, WALL_PLAYER, false);
+	setDispatch(COLLISION_LAYER::PLAYER, COLLISION_LAYER::ENEMY, PLAYER_ENEMY, true);
+
+	struct Body {
+		Entity entity;
+		int layer;
+	};
+	std::vector<Body> projectiles, enemies, walls;
+	std::vector<Entity> created;
+	for (int i = 0; i < NUM_PROJECTILES; i++) {
+		Entity entity = Entity();
+		registry.projectiles.emplace(entity);
+		projectiles.push_back({ entity, (int)(i % 4 == 0 ? COLLISION_LAYER::E_PROJECTILE : COLLISION_LAYER::P_PROJECTILE) });
+		created.push_back(entity);
+	}
+	for (int i = 0; i < NUM_ENEMIES; i++) {
+		Entity entity = Entity();
+		registry.enemies.insert(entity, nullptr);
+		enemies.push_back({ entity, (int)COLLISION_LAYER::ENEMY });
+		created.push_back(entity);
+	}
+	for (int i = 0; i < NUM_WALLS; i++) {
+		Entity entity = Entity();
+		registry.wallCollisions.emplace(entity);
+		walls.push_back({ entity, (int)COLLISION_LAYER::WALL });
+		created.push_back(entity);
+	}
+	Entity player_entity = Entity();
+	registry.players.emplace(player_entity);
+	Body player = { player_entity, (int)COLLISION_LAYER::PLAYER };
+	created.push_back(player_entity);
+
+	// A mix of what a busy fight produces, each pair in a random order
+	std::mt19937 random(options.seed);
+	std::uniform_int_distribution<int> pick(0, 1 << 30);
+	std::vector<std::pair<Body, Body>> pairs;
+	std::set<std::pair<unsigned int, unsigned int>> pair_keys;	// every pair only once, like within one physics step
+	while ((int)pairs.size() < NUM_EVENTS) {
+		const Body& projectile = projectiles[pick(random) % NUM_PROJECTILES];
+		const Body& enemy = enemies[pick(random) % NUM_ENEMIES];
+		const Body& wall = walls[pick(random) % NUM_WALLS];
+		std::pair<Body, Body> pair;
+		switch (pick(random) % 5) {
+		case 0: pair = { projectile, enemy }; break;
+		case 1: pair = { enemy, wall }; break;
+		case 2: pair = { projectile, wall }; break;
+		case 3: pair = { projectile, player }; break;
+		default: pair = { player, enemy }; break;
+		}
+		if (pick(random) % 2) {
+			std::swap(pair.first, pair.second);
+		}
+		unsigned int a = pair.first.entity.id();
+		unsigned int b = pair.second.entity.id();
+		if (pair_keys.insert({ std::min(a, b), std::max(a, b) }).second) {
+			pairs.push_back(pair);
+		}
+	}
+
+	ComponentContainer<OldCollision> collisions;
+	CollisionEventQueue queue;
+	HandlerCounts chain_counts, table_counts;
+	double chain_record_ms = 0, chain_dispatch_ms = 0, queue_record_ms = 0, table_dispatch_ms = 0;
+	for (int rep = 0; rep < reps; rep++) {
+		auto start = BenchClock::now();
+		collisions.clear();
+		for (const auto& pair : pairs) {
+			collisions.emplace_with_duplicates(pair.first.entity, pair.second.entity);
+		}
+		chain_record_ms += msSince(start);
+
+		start = BenchClock::now();
+		dispatchByChain(collisions, chain_counts);
+		chain_dispatch_ms += msSince(start);
+
+		start = BenchClock::now();
+		queue.clear();
+		for (const auto& pair : pairs) {
+			queue.push(pair.first.entity, pair.first.layer, pair.second.entity, pair.second.layer);
+		}
+		queue_record_ms += msSince(start);
+
+		start = BenchClock::now();
+		dispatchByTable(queue, table_counts);
+		table_dispatch_ms += msSince(start);
+	}
+
+	bool is_same = queue.size() == pairs.size() && chain_counts == table_counts;
+	std::printf("%d collisions per frame, ms per frame:\n", NUM_EVENTS);
+	std::printf("  components + if/else chain   record %.4f  dispatch %.4f  total %.4f\n", chain_record_ms / reps,
+		chain_dispatch_ms / reps, (chain_record_ms + chain_dispatch_ms) / reps);
+	std::printf("  event queue + layer table    record %.4f  dispatch %.4f  total %.4f\n", queue_record_ms / reps,
+		table_dispatch_ms / reps, (queue_record_ms + table_dispatch_ms) / reps);
+	std::printf("  same handler calls           %s\n", is_same ? "yes" : "NO");
+
+	for (Entity entity : created) {
+		registry.remove_all_components_of(entity);
+	}
+	return is_same;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+// Shared by the benchmarks in this folder, see benchmarks.hpp
+
+// stdlib
+#include <chrono>
+#include <random>
+
+using BenchClock = std::chrono::high_resolution_clock;
+
+struct BenchOptions {
+	int reps = 0;	// 0 is each benchmark's own default
+	unsigned int seed = 1;
+
+	int repsOr(int default_reps) const { return reps > 0 ? reps : default_reps; }
+};
+
+inline double msSince(BenchClock::time_point start) {
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+// Every benchmark prints its own table and returns false if the versions it compares disagreed
+bool benchBroadphase(const BenchOptions& options);
+bool benchEntityIndex(const BenchOptions& options);
+bool benchEntityRecycling(const BenchOptions& options);
+bool benchView(const BenchOptions& options);
+bool benchCollisionDispatch(const BenchOptions& options);
+bool benchParticles(const BenchOptions& options);
+bool benchTimers(const BenchOptions& options);
+bool benchSpellCache(const BenchOptions& options);
+bool benchSeeking(const BenchOptions& options);
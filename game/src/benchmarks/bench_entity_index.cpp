@@ -0,0 +1,92 @@
+#include "bench_common.hpp"
+
+// stdlib
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+// internal
+#include "tinyECS/components.hpp"
+#include "tinyECS/tiny_ecs.hpp"
+
+namespace {
+	struct IndexTimes {
+		double has_ns = 0;
+		double get_ns = 0;
+		double remove_ns = 0;
+		double checksum = 0;	// has to be the same for both indices
+	};
+
+	// Fill a container with every entity, then look them up and remove them in the shuffled order
+	template <typename EntityIndex>
+	IndexTimes timeIndex(const std::vector<Entity>& entities, const std::vector<Entity>& shuffled, int reps) {
+		IndexTimes times;
+		ComponentContainer<Transformation, EntityIndex> container;
+		for (int rep = 0; rep < reps; rep++) {
+			for (Entity e : entities) {
+				Transformation& transformation = container.emplace(e);
+				transformation.position = vec2((float)e.index(), 0);
+			}
+
+			int num_found = 0;
+			auto start = BenchClock::now();
+			for (Entity e : shuffled) {
+				num_found += container.has(e);
+			}
+			times.has_ns += msSince(start) * 1e6 / shuffled.size();
+
+			float sum = 0;
+			start = BenchClock::now();
+			for (Entity e : shuffled) {
+				sum += container.get(e).position.x;
+			}
+			times.get_ns += msSince(start) * 1e6 / shuffled.size();
+
+			start = BenchClock::now();
+			for (Entity e : shuffled) {
+				container.remove(e);
+			}
+			times.remove_ns += msSince(start) * 1e6 / shuffled.size();
+
+			times.checksum += num_found + (double)sum + container.size();
+		}
+		times.has_ns /= reps;
+		times.get_ns /= reps;
+		times.remove_ns /= reps;
+		return times;
+	}
+}
+
+bool benchEntityIndex(const BenchOptions& options) {
+	const int sizes[] = { 10000, 100000, 1000000 };
+	const int default_reps[] = { 50, 10, 3 };
+
+	std::mt19937 random(options.seed);
+	bool is_matching = true;
+
+	std::printf("%8s %18s %18s %18s %8s\n", "entities", "has hash/sparse", "get hash/sparse", "remove hash/sparse", "match");
+	for (int s = 0; s < 3; s++) {
+		std::vector<Entity> entities;
+		for (int i = 0; i < sizes[s]; i++) {
+			entities.push_back(Entity());
+		}
+		std::vector<Entity> shuffled = entities;
+		std::shuffle(shuffled.begin(), shuffled.end(), random);
+
+		int reps = options.repsOr(default_reps[s]);
+		IndexTimes hash = timeIndex<HashEntityIndex>(entities, shuffled, reps);
+		IndexTimes sparse = timeIndex<SparseEntityIndex>(entities, shuffled, reps);
+
+		bool is_same = hash.checksum == sparse.checksum;
+		is_matching = is_matching && is_same;
+		std::printf("%8d %8.1f / %7.1f %8.1f / %7.1f %8.1f / %7.1f %8s\n", sizes[s], hash.has_ns, sparse.has_ns,
+			hash.get_ns, sparse.get_ns, hash.remove_ns, sparse.remove_ns, is_same ? "yes" : "NO");
+
+		// Hand the ids back, so the next size (and the next benchmark) doesn't run out
+		for (Entity e : entities) {
+			Entity::release(e);
+		}
+	}
+	std::printf("(ns per operation, lookups in shuffled order)\n");
+	return is_matching;
+}
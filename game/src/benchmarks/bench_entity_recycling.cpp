@@ -0,0 +1,77 @@
+#include "bench_common.hpp"
+
+// stdlib
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+// internal
+#include "tinyECS/registry.hpp"
+
+// Soak test for entity id recycling: projectiles are spawned and destroyed through the registry over and over with a
+// steady number alive, like a long fight. The number of indices ever handed out has to level off instead of growing
+// with the number of spawns, and handles kept from destroyed projectiles have to read as dead even once their index
+// has been given to a new one.
+bool benchEntityRecycling(const BenchOptions& options) {
+	const int NUM_ALIVE = 2000;
+	const int STALE_SAMPLE_EVERY = 997;	// keep a handle to every n-th destroyed projectile
+	const int MAX_STALE_SAMPLES = 4096;
+	int num_cycles = options.repsOr(1000000);
+
+	unsigned int indices_before = Entity::num_indices();
+	std::deque<Entity> alive;
+	std::vector<Entity> stale;
+	int num_stale_checked = 0;
+	int num_stale_missed = 0;
+
+	auto spawn = [&]() {
+		Entity entity = Entity();
+		registry.transforms.emplace(entity);
+		registry.motions.emplace(entity);
+		Projectile& projectile = registry.projectiles.emplace(entity);
+		projectile.lifetime = 1000.f;
+		alive.push_back(entity);
+	};
+
+	for (int i = 0; i < NUM_ALIVE; i++) {
+		spawn();
+	}
+
+	unsigned int peak_indices = 0;
+	auto start = BenchClock::now();
+	for (int cycle = 0; cycle < num_cycles; cycle++) {
+		Entity oldest = alive.front();
+		alive.pop_front();
+		registry.remove_all_components_of(oldest);
+		if (cycle % STALE_SAMPLE_EVERY == 0) {
+			if (stale.size() == MAX_STALE_SAMPLES) {
+				stale.clear();
+			}
+			stale.push_back(oldest);
+		}
+
+		spawn();
+
+		// Every once in a while, every kept handle has to miss, whatever its index is used by now
+		if (cycle % 100000 == 0) {
+			for (Entity e : stale) {
+				num_stale_checked++;
+				if (registry.is_alive(e) || registry.transforms.has(e) || registry.projectiles.has(e)) {
+					num_stale_missed++;
+				}
+			}
+		}
+		peak_indices = std::max(peak_indices, Entity::num_indices() - indices_before);
+	}
+	double run_ms = msSince(start);
+
+	bool is_matching = num_stale_missed == 0;
+	std::printf("%d spawn/destroy cycles with %d alive: %.1f ns per cycle\n", num_cycles, NUM_ALIVE, run_ms * 1e6 / num_cycles);
+	std::printf("indices handed out: %u (%d alive + %u free at most before reuse)\n", peak_indices, NUM_ALIVE, Entity::MIN_FREE_INDICES);
+	std::printf("stale handles checked: %d, seen as alive: %d\n", num_stale_checked, num_stale_missed);
+
+	for (Entity e : alive) {
+		registry.remove_all_components_of(e);
+	}
+	return is_matching;
+}
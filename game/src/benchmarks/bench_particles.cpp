@@ -0,0 +1,251 @@
+#include "bench_common.hpp"
+
+// stdlib
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// internal
+#include "common.hpp"
+#include "particle_system.hpp"
+#include "tinyECS/registry.hpp"
+
+// One frame of particles as the game does it: spawn, update, then pack the alive ones into instance data for drawing.
+// The structure of arrays pool with packed alive ranges (through ParticleSystem::step) against a copy of what it
+// replaced, an array of Particle structs per emitter with a scan for a dead slot on every spawn, an update that skips
+// the dead ones and a pack pass that counts the alive ones first.
+namespace {
+	const float STEP_MS = 16.f;
+	const int WARMUP_FRAMES = 120;	// particles live for a second, so the emitters are full by then
+	const int PARTICLES_PER_EMITTER = 100;
+
+	// The old per emitter particle, see the Particle struct before the pool
+	struct OldParticle {
+		vec2 position = vec2(0, 0);
+		vec2 velocity = vec2(0, 0);
+		vec2 scale = vec2(1, 1);
+		vec4 color = vec4(1, 0, 0, 1);
+		float lifetime = 0;
+	};
+
+	struct OldEmitter {
+		Entity parent_entity = -1;
+		const ParticleEmitterDescriptor* descriptor = nullptr;
+		std::vector<OldParticle> particles;
+		float loop_duration = 1.0;
+		float current_respawn_time = 0.0;
+	};
+
+	int getFirstUnusedParticle(OldEmitter& emitter) {
+		for (int i = 0; i < emitter.descriptor->max_particles; i++) {
+			if (emitter.particles[i].lifetime <= 0) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	void respawnOld(OldEmitter& emitter, OldParticle& particle) {
+		const ParticleEmitterDescriptor& d = *emitter.descriptor;
+		vec2 random_position = vec2((uniform_dist(rng) - 0.5) * (d.random_position_max.x - d.random_position_min.x),
+			(uniform_dist(rng) - 0.5) * (d.random_position_max.y - d.random_position_min.y));
+		vec2 random_velocity = vec2((uniform_dist(rng) - 0.5) * (d.random_velocity_max.x - d.random_velocity_min.x),
+			(uniform_dist(rng) - 0.5) * (d.random_velocity_max.y - d.random_velocity_max.y));
+
+		vec2 parent_position = vec2(0, 0);
+		vec2 parent_scale = vec2(1, 1);
+		if (emitter.parent_entity != -1) {
+			Transformation parent_transform = registry.transforms.get(emitter.parent_entity);
+			parent_position = parent_transform.position;
+			parent_scale = parent_transform.scale;
+		}
+
+		particle.position = parent_position + d.position_i + random_position;
+		particle.velocity = d.velocity_i + random_velocity;
+		particle.scale = vec2(parent_scale.x * d.scale_i.x, parent_scale.y * d.scale_i.y);
+		particle.color = d.color_i;
+		particle.lifetime = emitter.loop_duration;
+	}
+
+	void stepOld(std::vector<OldEmitter>& emitters, float elapsed_ms) {
+		float stepSeconds = elapsed_ms / 1000.0f;
+		for (OldEmitter& emitter : emitters) {
+			emitter.current_respawn_time += stepSeconds;
+			int unused = getFirstUnusedParticle(emitter);
+			if (unused >= 0 && emitter.current_respawn_time > emitter.loop_duration / emitter.descriptor->max_particles) {
+				respawnOld(emitter, emitter.particles[unused]);
+				emitter.current_respawn_time = 0;
+			}
+		}
+		for (OldEmitter& emitter : emitters) {
+			for (OldParticle& particle : emitter.particles) {
+				if (particle.lifetime <= 0) {
+					continue;
+				}
+				particle.lifetime -= stepSeconds;
+				particle.position += particle.velocity * stepSeconds;
+				particle.color.w -= (emitter.descriptor->color_i.w / particle.lifetime) * stepSeconds;
+			}
+		}
+	}
+
+	// Returns the number of instances and adds up their positions, so both versions can be compared
+	int packOld(std::vector<OldEmitter>& emitters, double& position_sum) {
+		int num_packed = 0;
+		for (OldEmitter& emitter : emitters) {
+			int num_alive = 0;
+			for (const OldParticle& particle : emitter.particles) {
+				if (particle.lifetime > 0) {
+					num_alive++;
+				}
+			}
+			if (num_alive == 0) {
+				continue;
+			}
+
+			std::vector<ParticleInfo> particle_info(num_alive);
+			int alive_index = 0;
+			for (const OldParticle& particle : emitter.particles) {
+				if (particle.lifetime > 0) {
+					Transform transform;
+					transform.translate(particle.position);
+					transform.scale(vec2(particle.scale.x * PIXEL_SCALE_FACTOR, particle.scale.y * PIXEL_SCALE_FACTOR));
+					particle_info[alive_index].transform_matrix = transform.mat;
+					particle_info[alive_index].color = particle.color;
+					alive_index++;
+				}
+			}
+			for (const ParticleInfo& info : particle_info) {
+				position_sum += info.transform_matrix[2][0] + info.transform_matrix[2][1];
+			}
+			num_packed += num_alive;
+		}
+		return num_packed;
+	}
+
+	// The fill loop of RenderSystem::drawParticles, into a vector instead of a mapped buffer
+	int packPool(std::vector<ParticleInfo>& particle_info, double& position_sum) {
+		auto& containers = registry.particle_emitter_containers.components;
+		int num_alive = 0;
+		for (ParticleEmitterContainer& container : containers) {
+			for (ParticleEmitter& emitter : container.emitters) {
+				if (emitter.descriptor != nullptr) {
+					num_alive += emitter.particles.num_alive;
+				}
+			}
+		}
+		particle_info.resize(num_alive);
+
+		const float* position_x = particle_pool.field(ParticlePool::POSITION_X);
+		const float* position_y = particle_pool.field(ParticlePool::POSITION_Y);
+		const float* scale_x = particle_pool.field(ParticlePool::SCALE_X);
+		const float* scale_y = particle_pool.field(ParticlePool::SCALE_Y);
+		const float* color_r = particle_pool.field(ParticlePool::COLOR_R);
+		const float* color_g = particle_pool.field(ParticlePool::COLOR_G);
+		const float* color_b = particle_pool.field(ParticlePool::COLOR_B);
+		const float* color_a = particle_pool.field(ParticlePool::COLOR_A);
+		int next = 0;
+		for (ParticleEmitterContainer& container : containers) {
+			for (ParticleEmitter& emitter : container.emitters) {
+				if (emitter.descriptor == nullptr || emitter.particles.num_alive == 0) {
+					continue;
+				}
+				int end = emitter.particles.offset + emitter.particles.num_alive;
+				for (int i = emitter.particles.offset; i < end; i++) {
+					Transform transform;
+					transform.translate(vec2(position_x[i], position_y[i]));
+					transform.scale(vec2(scale_x[i] * PIXEL_SCALE_FACTOR, scale_y[i] * PIXEL_SCALE_FACTOR));
+					ParticleInfo& info = particle_info[next++];
+					info.transform_matrix = transform.mat;
+					info.color = vec4(color_r[i], color_g[i], color_b[i], color_a[i]);
+				}
+			}
+		}
+		for (const ParticleInfo& info : particle_info) {
+			position_sum += info.transform_matrix[2][0] + info.transform_matrix[2][1];
+		}
+		return num_alive;
+	}
+}
+
+bool benchParticles(const BenchOptions& options) {
+	const int SLOT_COUNTS[] = { 1000, 100000, 1000000 };
+	int num_frames = options.repsOr(20);
+
+	ParticleEmitterDescriptor descriptor(PARTICLES_PER_EMITTER, vec4(1, 1, 1, 1), vec2(-10, -10), vec2(10, 10), vec2(-40, -40), vec2(40, 40));
+
+	bool is_matching = true;
+	std::printf("ms per frame, step (spawn + update) and pack\n");
+	std::printf("%-10s %10s %12s %12s %12s %12s\n", "slots", "alive", "AoS step", "AoS pack", "pool step", "pool pack");
+	for (int num_slots : SLOT_COUNTS) {
+		int num_emitters = num_slots / PARTICLES_PER_EMITTER;
+
+		// Emitters follow an entity, like the ones on the player and the projectiles
+		std::vector<Entity> entities;
+		for (int i = 0; i < num_emitters; i++) {
+			Entity entity = Entity();
+			registry.transforms.emplace(entity).position = vec2((float)(i % 100), (float)(i / 100)) * (float)TILE_SIZE;
+			entities.push_back(entity);
+		}
+
+		// Old: every emitter owns max_particles structs
+		std::vector<OldEmitter> old_emitters(num_emitters);
+		for (int i = 0; i < num_emitters; i++) {
+			OldEmitter& emitter = old_emitters[i];
+			emitter.parent_entity = entities[i];
+			emitter.descriptor = &descriptor;
+			emitter.loop_duration = descriptor.loop_duration;
+			emitter.particles.resize(descriptor.max_particles);
+		}
+		rng.seed(options.seed);
+		for (int frame = 0; frame < WARMUP_FRAMES; frame++) {
+			stepOld(old_emitters, STEP_MS);
+		}
+		double old_sum = 0;
+		int old_alive = 0;
+		double old_step_ms = 0, old_pack_ms = 0;
+		for (int frame = 0; frame < num_frames; frame++) {
+			auto start = BenchClock::now();
+			stepOld(old_emitters, STEP_MS);
+			old_step_ms += msSince(start);
+			start = BenchClock::now();
+			old_sum = 0;
+			old_alive = packOld(old_emitters, old_sum);
+			old_pack_ms += msSince(start);
+		}
+		old_emitters.clear();
+
+		// Pool: the same entities get an emitter container, stepped by the game's own system
+		ParticleSystem particle_system;
+		for (Entity entity : entities) {
+			registry.particle_emitter_containers.emplace(entity).add(PARTICLE_EMITTER_ID::PLAYER_FOOTSTEPS, descriptor).start_emitting();
+		}
+		rng.seed(options.seed);
+		for (int frame = 0; frame < WARMUP_FRAMES; frame++) {
+			particle_system.step(STEP_MS);
+		}
+		std::vector<ParticleInfo> particle_info;
+		double pool_sum = 0;
+		int pool_alive = 0;
+		double pool_step_ms = 0, pool_pack_ms = 0;
+		for (int frame = 0; frame < num_frames; frame++) {
+			auto start = BenchClock::now();
+			particle_system.step(STEP_MS);
+			pool_step_ms += msSince(start);
+			start = BenchClock::now();
+			pool_sum = 0;
+			pool_alive = packPool(particle_info, pool_sum);
+			pool_pack_ms += msSince(start);
+		}
+		for (Entity entity : entities) {
+			registry.remove_all_components_of(entity);
+		}
+
+		// Same spawns from the same rng, only the order inside an emitter differs, so the sums match up to rounding
+		bool is_same = old_alive == pool_alive && std::abs(old_sum - pool_sum) <= 1e-4 * (1.0 + std::abs(old_sum));
+		is_matching = is_matching && is_same;
+		std::printf("%-10d %10d %12.3f %12.3f %12.3f %12.3f%s\n", num_slots, pool_alive, old_step_ms / num_frames, old_pack_ms / num_frames,
+			pool_step_ms / num_frames, pool_pack_ms / num_frames, is_same ? "" : "  MISMATCH");
+	}
+	return is_matching;
+}
@@ -0,0 +1,116 @@
+#include "bench_common.hpp"
+
+// stdlib
+#include <cstdio>
+#include <vector>
+
+// internal
+#include "common.hpp"
+#include "spatial_index.hpp"
+#include "tinyECS/registry.hpp"
+
+// Every seeking projectile looking for its nearest enemy in the same frame, the worst case (a projectile only looks
+// when it has no target). The scan over every enemy that findNearestEnemy does against keeping a spatial index of the
+// enemies up to date and asking it. Half the enemies move a little every frame, so the index has some cells to move
+// entities between. Both have to find an enemy at the same distance (ties can pick different ones).
+namespace {
+	// findNearestEnemy in spells.cpp
+	Entity scanNearestEnemy(vec2 position) {
+		float nearest_dist = 9999999;
+		Entity nearest_enemy = -1;
+		for (Entity enemy_entity : registry.enemies.entities) {
+			Transformation* enemy_transform = registry.transforms.try_get(enemy_entity);
+			if (enemy_transform == nullptr) {
+				continue;
+			}
+			float dist = glm::distance(enemy_transform->position, position);
+			if (dist < nearest_dist) {
+				nearest_dist = dist;
+				nearest_enemy = enemy_entity;
+			}
+		}
+		return nearest_enemy;
+	}
+}
+
+bool benchSeeking(const BenchOptions& options) {
+	const int NUM_PROJECTILES = 1000;
+	const int NUM_ENEMIES = 500;
+	const float ARENA_SIZE = 40.f * TILE_SIZE;
+	int num_frames = options.repsOr(100);
+
+	std::mt19937 random(options.seed);
+	std::uniform_real_distribution<float> coord(0.f, ARENA_SIZE);
+	std::uniform_real_distribution<float> step(-0.1f * TILE_SIZE, 0.1f * TILE_SIZE);
+
+	std::vector<Entity> enemies;
+	for (int i = 0; i < NUM_ENEMIES; i++) {
+		Entity entity = Entity();
+		registry.enemies.insert(entity, nullptr);
+		registry.transforms.emplace(entity).position = vec2(coord(random), coord(random));
+		enemies.push_back(entity);
+	}
+	std::vector<vec2> projectiles(NUM_PROJECTILES);
+	for (vec2& position : projectiles) {
+		position = vec2(coord(random), coord(random));
+	}
+
+	SpatialIndex index;
+	const vec2 enemy_half_extent = vec2(0.5f * TILE_SIZE);
+	std::vector<Entity> nearest;
+	double scan_ms = 0, sync_ms = 0, query_ms = 0;
+	int num_mismatches = 0;
+	for (int frame = 0; frame < num_frames; frame++) {
+		for (int i = 0; i < NUM_ENEMIES; i += 2) {
+			Transformation& transform = registry.transforms.get(enemies[i]);
+			transform.position = glm::clamp(transform.position + vec2(step(random), step(random)), vec2(0.f), vec2(ARENA_SIZE));
+		}
+
+		std::vector<Entity> scanned(NUM_PROJECTILES, Entity(-1));
+		auto start = BenchClock::now();
+		for (int i = 0; i < NUM_PROJECTILES; i++) {
+			scanned[i] = scanNearestEnemy(projectiles[i]);
+		}
+		scan_ms += msSince(start);
+
+		// What SpatialIndexSystem does for the enemies
+		start = BenchClock::now();
+		index.beginSync();
+		for (Entity enemy : enemies) {
+			index.update(enemy, registry.transforms.get(enemy).position, enemy_half_extent, (int)COLLISION_LAYER::ENEMY);
+		}
+		index.endSync();
+		sync_ms += msSince(start);
+
+		std::vector<Entity> queried(NUM_PROJECTILES, Entity(-1));
+		start = BenchClock::now();
+		for (int i = 0; i < NUM_PROJECTILES; i++) {
+			index.queryNearest(projectiles[i], (int)COLLISION_LAYER::ENEMY, 1, nearest);
+			if (!nearest.empty()) {
+				queried[i] = nearest[0];
+			}
+		}
+		query_ms += msSince(start);
+
+		for (int i = 0; i < NUM_PROJECTILES; i++) {
+			if (scanned[i] == queried[i]) {
+				continue;
+			}
+			if (queried[i] == Entity(-1) || glm::distance(registry.transforms.get(scanned[i]).position, projectiles[i])
+				!= glm::distance(registry.transforms.get(queried[i]).position, projectiles[i])) {
+				num_mismatches++;
+			}
+		}
+	}
+
+	std::printf("%d seeking projectiles, %d enemies, %d frames\n", NUM_PROJECTILES, NUM_ENEMIES, num_frames);
+	std::printf("scan every enemy:  %.4f ms/frame\n", scan_ms / num_frames);
+	std::printf("spatial index:     %.4f ms/frame (sync %.4f + queries %.4f)\n", (sync_ms + query_ms) / num_frames,
+		sync_ms / num_frames, query_ms / num_frames);
+	std::printf("different distance: %d\n", num_mismatches);
+
+	for (Entity enemy : enemies) {
+		registry.remove_all_components_of(enemy);
+	}
+	return num_mismatches == 0;
+}
@@ -0,0 +1,64 @@
+#include "bench_common.hpp"
+
+// stdlib
+#include <cmath>
+#include <cstdio>
+
+// internal
+#include "spell_cast_manager.hpp"
+
+// Resolving the player's projectile spell on every cast, with more and more relics picked up. The spell kept on the slot
+// (SpellCastManager::resolveSpell) against what every cast did before it: clone the base spell, run the relics over the
+// clone, slice a Spell out of it for the cooldowns and delete the clone. Making the projectiles isn't part of it.
+// Both have to give the same cooldowns.
+namespace {
+	// The old applyRelicsAndCast without the cast
+	Spell cloneAndApplyRelics(SpellSlot& spell_slot) {
+		ProjectileSpell* new_spell = projectile_spells[spell_slot.spell_id]->clone();
+		for (RELIC_ID relic_id : spell_slot.relics) {
+			new_spell = relics[(int)relic_id]->modifyProjectileSpell(new_spell);
+		}
+		Spell spell = *new_spell;
+		delete new_spell;
+		return spell;
+	}
+}
+
+bool benchSpellCache(const BenchOptions& options) {
+	const int RELIC_COUNTS[] = { 0, 4, 12 };
+	int num_casts = options.repsOr(1000000);
+
+	bool is_matching = true;
+	std::printf("%d casts of fireball\n", num_casts);
+	std::printf("%-8s %18s %18s\n", "relics", "clone ns/cast", "cached ns/cast");
+	for (int num_relics : RELIC_COUNTS) {
+		SpellSlot spell_slot = SpellSlot();
+		spell_slot.spell_type = SPELL_TYPE::PROJECTILE;
+		spell_slot.spell_id = (int)PROJECTILE_SPELL_ID::FIREBALL;
+		for (int i = 0; i < num_relics; i++) {
+			spell_slot.relics.push_back((RELIC_ID)(i % relic_count));
+		}
+
+		// What the cast reads off the spell, summed so neither loop can be skipped
+		double old_sum = 0;
+		auto start = BenchClock::now();
+		for (int cast = 0; cast < num_casts; cast++) {
+			Spell spell = cloneAndApplyRelics(spell_slot);
+			old_sum += spell.getCooldown() + spell.getInternalCastCooldown() + spell.getNumCasts();
+		}
+		double old_ms = msSince(start);
+
+		double cached_sum = 0;
+		start = BenchClock::now();
+		for (int cast = 0; cast < num_casts; cast++) {
+			Spell& spell = *SpellCastManager::resolveSpell(spell_slot);
+			cached_sum += spell.getCooldown() + spell.getInternalCastCooldown() + spell.getNumCasts();
+		}
+		double cached_ms = msSince(start);
+
+		bool is_same = std::abs(old_sum - cached_sum) <= 1e-9 * (1.0 + std::abs(old_sum));
+		is_matching = is_matching && is_same;
+		std::printf("%-8d %18.1f %18.1f%s\n", num_relics, old_ms * 1e6 / num_casts, cached_ms * 1e6 / num_casts, is_same ? "" : "  MISMATCH");
+	}
+	return is_matching;
+}
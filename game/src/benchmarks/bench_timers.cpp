@@ -0,0 +1,150 @@
+#include "bench_common.hpp"
+
+// stdlib
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+// internal
+#include "common.hpp"
+#include "timer_wheel.hpp"
+#include "tinyECS/tiny_ecs.hpp"
+
+// Lots of one-shot timers alive at once, stepped at 60 fps until every one of them fired. The timer wheel against a
+// copy of what it replaced, an entity per timer with a Timer component holding a std::function that TimerSystem counted
+// down every frame. Both have to fire every timer, in the same frame give or take the rounding to whole ticks.
+namespace {
+	const float FRAME_MS = 1000.f / 60.f;
+
+	// The old Timer component
+	struct OldTimer {
+		float duration;
+		float current_time;
+		bool is_active;
+		bool is_looping;
+		std::function<void()> timeout;
+	};
+
+	// The old TimerSystem::step, with the destroys that went through the command buffer done at the end of the frame
+	void stepOld(ComponentContainer<OldTimer>& timers, float elapsed_ms) {
+		float stepSeconds = elapsed_ms / 1000.0f;
+		std::vector<Entity> finished;
+		size_t num_timers = timers.size();
+		for (size_t i = 0; i < num_timers && i < timers.size(); i++) {
+			Entity timerEntity = timers.entities[i];
+			OldTimer& timer = timers.components[i];
+			if (!timer.is_active) {
+				finished.push_back(timerEntity);
+				continue;
+			}
+
+			timer.current_time -= stepSeconds;
+			if (timer.current_time <= 0) {
+				timer.is_active = false;
+				std::function<void()> timerCallback = timer.timeout;
+				timerCallback();
+			}
+		}
+		for (Entity entity : finished) {
+			timers.remove(entity);
+			Entity::release(entity);
+		}
+	}
+
+	struct StepTimes {
+		double schedule_ms = 0;
+		double total_ms = 0;
+		double worst_ms = 0;
+		int num_frames = 0;
+	};
+}
+
+bool benchTimers(const BenchOptions& options) {
+	int num_timers = options.repsOr(100000);
+
+	std::srand(options.seed);
+	std::vector<float> durations(num_timers);
+	for (float& duration : durations) {
+		duration = 0.1f + 9.9f * (float)std::rand() / RAND_MAX;
+	}
+
+	// The frame each timer fired in, -1 if it never did. The captures are about castBurstSpell's size
+	std::vector<int> old_fired(num_timers, -1);
+	std::vector<int> wheel_fired(num_timers, -1);
+	int frame = 0;
+	vec2 position = vec2(1, 2);
+	vec2 direction = vec2(0, 1);
+	vec2 aim = vec2(0, 0);
+
+	StepTimes old_times;
+	{
+		ComponentContainer<OldTimer> timers;
+		auto start = BenchClock::now();
+		for (int i = 0; i < num_timers; i++) {
+			std::function<void()> callback = [&old_fired, &frame, &aim, i, position, direction]() {
+				old_fired[i] = frame;
+				aim += position + direction;
+			};
+			OldTimer& timer = timers.emplace(Entity());
+			timer.duration = durations[i];
+			timer.current_time = durations[i];
+			timer.is_active = true;
+			timer.is_looping = false;
+			timer.timeout = callback;
+		}
+		old_times.schedule_ms = msSince(start);
+
+		for (frame = 0; timers.size() > 0; frame++) {
+			start = BenchClock::now();
+			stepOld(timers, FRAME_MS);
+			double ms = msSince(start);
+			old_times.total_ms += ms;
+			old_times.worst_ms = std::max(old_times.worst_ms, ms);
+			old_times.num_frames++;
+		}
+	}
+
+	StepTimes wheel_times;
+	{
+		TimerWheel wheel;
+		auto start = BenchClock::now();
+		for (int i = 0; i < num_timers; i++) {
+			wheel.schedule(durations[i], [&wheel_fired, &frame, &aim, i, position, direction]() {
+				wheel_fired[i] = frame;
+				aim += position + direction;
+			});
+		}
+		wheel_times.schedule_ms = msSince(start);
+
+		for (frame = 0; wheel.getNumScheduled() > 0; frame++) {
+			start = BenchClock::now();
+			wheel.advance(FRAME_MS);
+			double ms = msSince(start);
+			wheel_times.total_ms += ms;
+			wheel_times.worst_ms = std::max(wheel_times.worst_ms, ms);
+			wheel_times.num_frames++;
+		}
+	}
+
+	int num_missed = 0;
+	int num_off = 0;	// fired a frame apart, float countdown vs whole ticks
+	for (int i = 0; i < num_timers; i++) {
+		if (old_fired[i] < 0 || wheel_fired[i] < 0 || std::abs(old_fired[i] - wheel_fired[i]) > 1) {
+			num_missed++;
+		}
+		else if (old_fired[i] != wheel_fired[i]) {
+			num_off++;
+		}
+	}
+
+	std::printf("%d one-shot timers of 0.1-10 s, stepped at 60 fps\n", num_timers);
+	std::printf("%-24s %12s %14s %14s %8s\n", "", "schedule ms", "step avg ms", "step worst ms", "frames");
+	std::printf("%-24s %12.3f %14.4f %14.4f %8d\n", "entity + std::function", old_times.schedule_ms,
+		old_times.total_ms / std::max(1, old_times.num_frames), old_times.worst_ms, old_times.num_frames);
+	std::printf("%-24s %12.3f %14.4f %14.4f %8d\n", "timer wheel", wheel_times.schedule_ms,
+		wheel_times.total_ms / std::max(1, wheel_times.num_frames), wheel_times.worst_ms, wheel_times.num_frames);
+	std::printf("fired a frame apart: %d, missed or further apart: %d\n", num_off, num_missed);
+	return num_missed == 0;
+}
@@ -0,0 +1,94 @@
+#include "bench_common.hpp"
+
+// stdlib
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+// internal
+#include "tinyECS/components.hpp"
+#include "tinyECS/tiny_ecs.hpp"
+
+// One motion integration pass over two containers, written the way the systems did it before views (walk one
+// container, has() and get() on the other) and with a view. Half of the entities with a transform also have a motion,
+// in a different order, like the real containers once entities have come and gone.
+bool benchView(const BenchOptions& options) {
+	const int NUM_ENTITIES = 100000;
+	int reps = options.repsOr(1000);
+
+	std::mt19937 random(options.seed);
+	std::vector<Entity> entities;
+	for (int i = 0; i < NUM_ENTITIES; i++) {
+		entities.push_back(Entity());
+	}
+
+	ComponentContainer<Transformation, SparseEntityIndex> transforms;
+	ComponentContainer<Motion, SparseEntityIndex> motions;
+	for (Entity e : entities) {
+		transforms.emplace(e);
+	}
+	std::shuffle(entities.begin(), entities.end(), random);
+	for (int i = 0; i < NUM_ENTITIES; i += 2) {
+		Motion& motion = motions.emplace(entities[i]);
+		motion.velocity = vec2((float)(i % 7), (float)(i % 5));
+	}
+	// Some motions without a transform, so both loops have something to skip
+	for (int i = 0; i < NUM_ENTITIES / 10; i++) {
+		motions.emplace(Entity());
+	}
+
+	const float step_seconds = 1.f / 60.f;
+	const int NUM_ROUNDS = 10;
+	int passes_per_round = std::max(1, reps / NUM_ROUNDS);
+
+	auto loopPass = [&]() {
+		for (uint i = 0; i < motions.size(); i++) {
+			Entity entity = motions.entities[i];
+			if (!transforms.has(entity)) {
+				continue;
+			}
+			transforms.get(entity).position += motions.components[i].velocity * step_seconds;
+		}
+	};
+	ComponentView<ComponentContainer<Motion, SparseEntityIndex>, ComponentContainer<Transformation, SparseEntityIndex>> view(motions, transforms);
+	auto viewPass = [&]() {
+		view.each([&](Entity entity, Motion& motion, Transformation& transformation) {
+			transformation.position += motion.velocity * step_seconds;
+		});
+	};
+
+	// Rounds of one then the other, the fastest round of each counts, so a busy machine doesn't favour either
+	auto timeRound = [&](auto& pass, vec2& out_sum) {
+		for (Transformation& transformation : transforms.components) {
+			transformation.position = vec2(0);
+		}
+		auto start = BenchClock::now();
+		for (int i = 0; i < passes_per_round; i++) {
+			pass();
+		}
+		double ms = msSince(start) / passes_per_round;
+		out_sum = vec2(0);
+		for (Transformation& transformation : transforms.components) {
+			out_sum += transformation.position;
+		}
+		return ms;
+	};
+	double loop_ms = 1e9, view_ms = 1e9;
+	vec2 loop_sum, view_sum;
+	for (int round = 0; round < NUM_ROUNDS; round++) {
+		loop_ms = std::min(loop_ms, timeRound(loopPass, loop_sum));
+		view_ms = std::min(view_ms, timeRound(viewPass, view_sum));
+	}
+
+	bool is_same = loop_sum == view_sum;
+	std::printf("%d transforms, %zu motions (%d with both), ms per pass (best of %d rounds):\n", NUM_ENTITIES, motions.size(), NUM_ENTITIES / 2, NUM_ROUNDS);
+	std::printf("  has() + get() loop %.4f\n  view              %.4f\n  same positions    %s\n", loop_ms, view_ms, is_same ? "yes" : "NO");
+
+	for (Entity e : motions.entities) {
+		Entity::release(e);
+	}
+	for (Entity e : transforms.entities) {
+		Entity::release(e);
+	}
+	return is_same;
+}
@@ -0,0 +1,93 @@
+#include "benchmarks.hpp"
+
+// stdlib
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// internal
+#include "bench_common.hpp"
+
+namespace {
+	struct Benchmark {
+		const char* name;
+		bool (*run)(const BenchOptions& options);
+		const char* description;
+	};
+
+	const Benchmark benchmarks[] = {
+		{ "broadphase", benchBroadphase, "uniform grid broadphase vs the all-pairs loop, 100 to 10k boxes" },
+		{ "entity_index", benchEntityIndex, "hash map vs paged sparse set entity lookups, 10k to 1M entities" },
+		{ "entity_recycling", benchEntityRecycling, "soak test, spawn and destroy projectiles with 2000 alive, ids have to be reused" },
+		{ "view", benchView, "registry view vs a has() + get() loop over two containers, 100k entities" },
+		{ "collision_dispatch", benchCollisionDispatch, "collision components + if/else chain vs event queue + layer table, 10k collisions" },
+		{ "particles", benchParticles, "per emitter Particle arrays vs the structure of arrays pool, spawn + update + pack, 1k to 1M slots" },
+		{ "timers", benchTimers, "entity + std::function timers vs the timer wheel, 100k one-shot timers at 60 fps" },
+		{ "spell_cache", benchSpellCache, "clone + relics per cast vs the spell kept on the slot, 0 to 12 relics" },
+		{ "seeking", benchSeeking, "scan every enemy vs the spatial index for 1000 seeking projectiles, 500 enemies" },
+	};
+
+	void printUsage() {
+		std::cerr << "Usage: --bench <name|all> [--reps N] [--seed N]" << std::endl;
+		std::cerr << "Benchmarks:" << std::endl;
+		for (const Benchmark& benchmark : benchmarks) {
+			std::cerr << "  " << benchmark.name << " - " << benchmark.description << std::endl;
+		}
+	}
+}
+
+bool isBenchmarkRun(int argc, char* argv[]) {
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--bench") == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int runBenchmark(int argc, char* argv[]) {
+	std::string name;
+	BenchOptions options;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool has_value = i + 1 < argc;
+
+		if (arg == "--bench" && has_value) {
+			name = argv[++i];
+		}
+		else if (arg == "--reps" && has_value) {
+			options.reps = atoi(argv[++i]);
+		}
+		else if (arg == "--seed" && has_value) {
+			options.seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+		}
+		else {
+			std::cerr << "ERROR: Bad argument " << arg << std::endl;
+			printUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	bool is_found = false;
+	bool is_matching = true;
+	for (const Benchmark& benchmark : benchmarks) {
+		if (name != "all" && name != benchmark.name) {
+			continue;
+		}
+		is_found = true;
+		std::cout << "== " << benchmark.name << ": " << benchmark.description << std::endl;
+		if (!benchmark.run(options)) {
+			std::cout << "MISMATCH in " << benchmark.name << std::endl;
+			is_matching = false;
+		}
+		std::cout << std::endl;
+	}
+
+	if (!is_found) {
+		std::cerr << "ERROR: Unknown benchmark " << name << std::endl;
+		printUsage();
+		return EXIT_FAILURE;
+	}
+	return is_matching ? EXIT_SUCCESS : EXIT_FAILURE;
+}
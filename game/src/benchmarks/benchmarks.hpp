@@ -0,0 +1,16 @@
+#pragma once
+
+// Micro benchmarks for the engine pieces that were rewritten for speed. Each one times the current code next to the
+// code it replaced (kept in the benchmark when it is gone from the game) on generated data, and checks that both give
+// the same results. Started from the command line with
+//
+//	Cleanse_the_Corruption --bench <name> [--reps N] [--seed N]
+//
+// --bench all runs every benchmark. The list is in benchmarks.cpp. For whole-game timings use the headless runner
+// (headless_runner.hpp) instead.
+
+// Does the command line ask for a benchmark?
+bool isBenchmarkRun(int argc, char* argv[]);
+
+// Run the benchmarks given on the command line, returns the exit code for main
+int runBenchmark(int argc, char* argv[]);
@@ -0,0 +1,162 @@
+#include "broadphase.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void BroadphaseGrid::clear()
+{
+	proxies.clear();
+	cells_w = 0;
+	cells_h = 0;
+}
+
+void BroadphaseGrid::insert(Entity entity, vec2 min, vec2 max, int layer, int mask)
+{
+	// Note, aggregate init so we don't default construct (and burn) an Entity id
+	proxies.push_back({ entity, min, max, layer, mask });
+}
+
+ivec2 BroadphaseGrid::cellOf(vec2 point) const
+{
+	int x = (int)std::floor((point.x - origin.x) / current_cell_size);
+	int y = (int)std::floor((point.y - origin.y) / current_cell_size);
+	return ivec2(glm::clamp(x, 0, cells_w - 1), glm::clamp(y, 0, cells_h - 1));
+}
+
+void BroadphaseGrid::build()
+{
+	cell_entries.clear();
+	if (proxies.empty()) {
+		cells_w = 0;
+		cells_h = 0;
+		cell_start.assign(1, 0);
+		return;
+	}
+
+	// Fit the grid around everything that was inserted
+	vec2 bounds_min = proxies[0].min;
+	vec2 bounds_max = proxies[0].max;
+	for (const BroadphaseProxy& proxy : proxies) {
+		bounds_min = glm::min(bounds_min, proxy.min);
+		bounds_max = glm::max(bounds_max, proxy.max);
+	}
+
+	origin = bounds_min;
+	current_cell_size = cell_size;
+	vec2 extent = bounds_max - bounds_min;
+	while (true) {
+		cells_w = (int)(extent.x / current_cell_size) + 1;
+		cells_h = (int)(extent.y / current_cell_size) + 1;
+		if ((long long)cells_w * cells_h <= MAX_CELLS) {
+			break;
+		}
+		current_cell_size *= 2;
+	}
+
+	// Count how many proxies touch each cell
+	int num_cells = cells_w * cells_h;
+	cell_start.assign(num_cells + 1, 0);
+	for (const BroadphaseProxy& proxy : proxies) {
+		ivec2 lo = cellOf(proxy.min);
+		ivec2 hi = cellOf(proxy.max);
+		for (int y = lo.y; y <= hi.y; y++) {
+			for (int x = lo.x; x <= hi.x; x++) {
+				cell_start[y * cells_w + x + 1]++;
+			}
+		}
+	}
+
+	// Prefix sum, so every cell knows where its range starts
+	for (int c = 0; c < num_cells; c++) {
+		cell_start[c + 1] += cell_start[c];
+	}
+
+	// Fill in proxy order, which keeps every cell sorted by proxy index
+	cell_entries.resize(cell_start[num_cells]);
+	cell_cursor.assign(cell_start.begin(), cell_start.end() - 1);
+	for (int i = 0; i < (int)proxies.size(); i++) {
+		ivec2 lo = cellOf(proxies[i].min);
+		ivec2 hi = cellOf(proxies[i].max);
+		for (int y = lo.y; y <= hi.y; y++) {
+			for (int x = lo.x; x <= hi.x; x++) {
+				cell_entries[cell_cursor[y * cells_w + x]++] = i;
+			}
+		}
+	}
+}
+
+void BroadphaseGrid::findPairs(std::vector<std::pair<int, int>>& out_pairs)
+{
+	out_pairs.clear();
+
+	for (int y = 0; y < cells_h; y++) {
+		for (int x = 0; x < cells_w; x++) {
+			int c = y * cells_w + x;
+			int begin = cell_start[c];
+			int end = cell_start[c + 1];
+
+			for (int a = begin; a < end; a++) {
+				const BroadphaseProxy& proxy_a = proxies[cell_entries[a]];
+
+				for (int b = a + 1; b < end; b++) {
+					const BroadphaseProxy& proxy_b = proxies[cell_entries[b]];
+
+					bool a_b_detect = (proxy_a.layer & proxy_b.mask) != 0;
+					bool b_a_detect = (proxy_b.layer & proxy_a.mask) != 0;
+					if (!a_b_detect && !b_a_detect) {
+						continue;
+					}
+
+					if (proxy_a.max.x < proxy_b.min.x || proxy_b.max.x < proxy_a.min.x ||
+						proxy_a.max.y < proxy_b.min.y || proxy_b.max.y < proxy_a.min.y) {
+						continue;
+					}
+
+					// Two boxes can share many cells, only report the pair from the cell holding the corner of their overlap
+					vec2 overlap_min = glm::max(proxy_a.min, proxy_b.min);
+					ivec2 owner = cellOf(overlap_min);
+					if (owner.x != x || owner.y != y) {
+						continue;
+					}
+
+					out_pairs.push_back({ cell_entries[a], cell_entries[b] });
+				}
+			}
+		}
+	}
+
+	// Report pairs in the same order a nested loop over the proxies would
+	std::sort(out_pairs.begin(), out_pairs.end());
+}
+
+void BroadphaseGrid::query(vec2 min, vec2 max, std::vector<int>& out_proxies) const
+{
+	out_proxies.clear();
+	if (proxies.empty()) {
+		return;
+	}
+
+	ivec2 lo = cellOf(min);
+	ivec2 hi = cellOf(max);
+	for (int y = lo.y; y <= hi.y; y++) {
+		for (int x = lo.x; x <= hi.x; x++) {
+			int c = y * cells_w + x;
+			for (int e = cell_start[c]; e < cell_start[c + 1]; e++) {
+				const BroadphaseProxy& proxy = proxies[cell_entries[e]];
+
+				if (max.x < proxy.min.x || proxy.max.x < min.x ||
+					max.y < proxy.min.y || proxy.max.y < min.y) {
+					continue;
+				}
+
+				// Same trick as findPairs, a proxy spanning several cells is only reported from one of them
+				ivec2 owner = cellOf(glm::max(min, proxy.min));
+				if (owner.x != x || owner.y != y) {
+					continue;
+				}
+
+				out_proxies.push_back(cell_entries[e]);
+			}
+		}
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "common.hpp"
+#include "tinyECS/tiny_ecs.hpp"
+
+#include <vector>
+#include <utility>
+
+// An axis aligned box that takes part in the broadphase, along with the collision bits of its hitbox
+struct BroadphaseProxy {
+	Entity entity;
+	vec2 min;
+	vec2 max;
+	int layer;
+	int mask;
+};
+
+// Uniform grid broadphase, rebuilt every physics step.
+// Proxies are bucketed into every cell their box touches, and only proxies that share a cell
+// (and whose layer/mask bits say they care about each other) are handed to the narrow phase.
+// Cells are stored as one flat array indexed by a prefix sum over the cell counts, so a rebuild
+// is two linear passes and reuses the allocations from the previous frame.
+class BroadphaseGrid
+{
+public:
+	BroadphaseGrid(float cell_size = TILE_SIZE) : cell_size(cell_size) {}
+
+	void clear();
+
+	// Add a box to the grid, the proxy index is the insertion order
+	void insert(Entity entity, vec2 min, vec2 max, int layer, int mask);
+
+	// Bucket all inserted proxies into cells, call once after all inserts
+	void build();
+
+	// Write every candidate pair exactly once, as (lower proxy index, higher proxy index), sorted in insertion order.
+	// A pair is only a candidate if the boxes overlap and at least one side's mask matches the other's layer.
+	void findPairs(std::vector<std::pair<int, int>>& out_pairs);
+
+	// Write the index of every proxy whose box overlaps [min, max], each proxy at most once
+	void query(vec2 min, vec2 max, std::vector<int>& out_proxies) const;
+
+	const BroadphaseProxy& getProxy(int index) const { return proxies[index]; }
+	size_t numProxies() const { return proxies.size(); }
+	size_t numCells() const { return (size_t)cells_w * cells_h; }
+
+private:
+	// Upper bound on the grid size, the cell size is grown if the inserted boxes span further than this
+	const int MAX_CELLS = 1 << 18;
+
+	float cell_size;
+	float current_cell_size = 0;
+	vec2 origin = vec2(0);
+	int cells_w = 0;
+	int cells_h = 0;
+
+	std::vector<BroadphaseProxy> proxies;
+	std::vector<int> cell_start;	// cell_start[c] .. cell_start[c + 1] is the range of cell c in cell_entries
+	std::vector<int> cell_entries;	// proxy indices, ascending within every cell
+	std::vector<int> cell_cursor;	// scratch space for filling cell_entries
+
+	ivec2 cellOf(vec2 point) const;
+};
@@ -8,6 +8,14 @@
 
 const float MAX_CAM_DISTANCE = 500;
 const float LERP_STRENGTH = 2.0;
+
+SystemAccess CameraSystem::getAccess() const {
+	SystemAccess access;
+	access.reads = { &registry.cameras, &registry.players, &mouse_pos_x, &mouse_pos_y };
+	access.writes = { &registry.transforms };
+	return access;
+}
+
 void CameraSystem::step(float elapsed_ms) {
 	for (Entity cameraEntity : registry.cameras.entities) { 
 		
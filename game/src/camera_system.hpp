@@ -3,6 +3,7 @@
 #include "tinyECS/tiny_ecs.hpp"
 #include "tinyECS/components.hpp"
 #include "tinyECS/registry.hpp"
+#include "system_scheduler.hpp"
 
 
 class CameraSystem
@@ -10,6 +11,8 @@ class CameraSystem
 public:
 	void step(float elapsed_ms);
 
+	SystemAccess getAccess() const;
+
 	CameraSystem()
 	{
 	}
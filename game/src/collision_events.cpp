@@ -0,0 +1,59 @@
+#include "collision_events.hpp"
+
+#include <algorithm>
+
+bool CollisionEventQueue::push(Entity a, int layer_a, Entity b, int layer_b)
+{
+	uint64_t id_a = (unsigned int)a;
+	uint64_t id_b = (unsigned int)b;
+	uint64_t key = id_a < id_b ? (id_a << 32) | id_b : (id_b << 32) | id_a;
+	if (!insertPair(key)) {
+		return false;
+	}
+
+	// Note, aggregate init so we don't default construct (and burn) an Entity id
+	events.push_back({ a, b, layer_a, layer_b });
+	return true;
+}
+
+void CollisionEventQueue::clear()
+{
+	events.clear();
+	std::fill(pair_slots.begin(), pair_slots.end(), 0);
+}
+
+bool CollisionEventQueue::insertPair(uint64_t key)
+{
+	// Keep the table at most half full
+	if ((events.size() + 1) * 2 > pair_slots.size()) {
+		growPairSlots();
+	}
+
+	size_t slot_mask = pair_slots.size() - 1;
+	size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ull) >> hash_shift);
+	while (pair_slots[slot] != 0) {
+		if (pair_slots[slot] == key) {
+			return false;
+		}
+		slot = (slot + 1) & slot_mask;
+	}
+	pair_slots[slot] = key;
+	return true;
+}
+
+void CollisionEventQueue::growPairSlots()
+{
+	size_t num_slots = std::max((size_t)1024, pair_slots.size() * 2);
+	pair_slots.assign(num_slots, 0);
+	hash_shift = 64;
+	while (((size_t)1 << (64 - hash_shift)) < num_slots) {
+		hash_shift--;
+	}
+
+	// Put the pairs already in the queue back in
+	std::vector<CollisionEvent> old_events;
+	old_events.swap(events);
+	for (const CollisionEvent& event : old_events) {
+		push(event.a, event.layer_a, event.b, event.layer_b);
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "tinyECS/tiny_ecs.hpp"
+#include "tinyECS/components.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Rows/columns of a collision dispatch table, one per COLLISION_LAYER bit plus one for hitboxes with no layer
+// (eg. the inactive boss_2 segment, which still detects walls)
+const int NUM_COLLISION_LAYERS = 7;
+const int NO_COLLISION_LAYER = NUM_COLLISION_LAYERS;
+const int NUM_COLLISION_LAYER_SLOTS = NUM_COLLISION_LAYERS + 1;
+
+// Index of the lowest COLLISION_LAYER bit set in layer, NO_COLLISION_LAYER if none is
+inline int collisionLayerIndex(int layer)
+{
+	for (int i = 0; i < NUM_COLLISION_LAYERS; i++) {
+		if (layer & (1 << i)) {
+			return i;
+		}
+	}
+	return NO_COLLISION_LAYER;
+}
+
+// Two hitboxes that overlap this frame, with the layers they had when the physics step found them
+struct CollisionEvent {
+	Entity a;
+	Entity b;
+	int layer_a;
+	int layer_b;
+};
+
+// Collisions found by the physics step, in the order they were found, and handled by WorldSystem::handle_collisions.
+// Every pair of entities is only in it once per frame, whichever way round it was pushed.
+class CollisionEventQueue
+{
+public:
+	// Returns false (and adds nothing) if the pair is already in the queue
+	bool push(Entity a, int layer_a, Entity b, int layer_b);
+	void clear();
+
+	const std::vector<CollisionEvent>& getEvents() const { return events; }
+	size_t size() const { return events.size(); }
+
+private:
+	std::vector<CollisionEvent> events;
+
+	// Hash set of the pairs in the queue, open addressing with linear probing so pushing doesn't allocate.
+	// A key is both entity ids, lower one in the high bits, 0 marks an empty slot (entity ids start at 1)
+	std::vector<uint64_t> pair_slots;
+	int hash_shift = 64;
+
+	bool insertPair(uint64_t key);
+	void growPairSlots();
+};
@@ -2,7 +2,7 @@
 
 #include "world_init.hpp"
 #include "render_system.hpp"
-#include "map_gen/map_node.hpp"
+#include "map_gen/map_layout.hpp"
 #include "tinyECS/registry.hpp"
 #include "tinyECS/components.hpp"
 
@@ -42,7 +42,7 @@ struct EnemyRoomManager {
 	std::vector<int> wall_entities;
 
 	// For random enemies
-	void init(std::vector<std::vector<int>>& arr, MapNode* map_node, std::vector<ENEMY_TYPE> enemy_types) {
+	void init(const MapGrid& grid, const MapNode& map_node, std::vector<ENEMY_TYPE> enemy_types) {
 		 
 		int num_waves = (int)(uniform_dist(rng) * (MAX_WAVES - MIN_WAVES)) + MIN_WAVES;
 
@@ -60,15 +60,15 @@ struct EnemyRoomManager {
 				ivec2 rand_loc;
 
 				do {
-					rand_x = (int)(uniform_dist(rng) * map_node->size.x);
-					rand_y = (int)(uniform_dist(rng) * map_node->size.y);
+					rand_x = (int)(uniform_dist(rng) * map_node.size.x);
+					rand_y = (int)(uniform_dist(rng) * map_node.size.y);
 
 					rand_loc = ivec2(
-						(map_node->array_pos.x + rand_x),
-						(map_node->array_pos.y + rand_y)
+						(map_node.array_pos.x + rand_x),
+						(map_node.array_pos.y + rand_y)
 					);
 
-				} while (arr[rand_loc.x][rand_loc.y] == 1);
+				} while (grid.at(rand_loc.x, rand_loc.y) == 1);
 
 				vec2 rand_pos = { rand_loc.x * TILE_SIZE, rand_loc.y * TILE_SIZE };
 				
@@ -146,14 +146,8 @@ void Boss_1::addSpellsAndSpellSlotsAndParticleEmitters(Entity& self) {
 	spellSlotContainer.spellSlots.push_back(movementSpellSlot);
 
 
-	ParticleEmitter dash_particle_emitter = ParticleEmitter();
-	dash_particle_emitter.setNumParticles(8);
-	dash_particle_emitter.setParentEntity(self);
-	dash_particle_emitter.setInitialColor(vec4(0.75, 0.75, 1, 0.25));
-	dash_particle_emitter.setTextureAssetId(TEXTURE_ASSET_ID::PLAYER_DASH_PARTICLES);
-
 	ParticleEmitterContainer& particle_emitter_container = registry.particle_emitter_containers.emplace(self);
-	particle_emitter_container.particle_emitter_map.insert(std::pair<PARTICLE_EMITTER_ID, ParticleEmitter>(PARTICLE_EMITTER_ID::DASH_TRAIL, dash_particle_emitter));
+	particle_emitter_container.add(PARTICLE_EMITTER_ID::DASH_TRAIL, dash_particles);
 }
 
 void Boss_1::resetAndGoToState(BOSS_STATE target_state, Entity& self) {
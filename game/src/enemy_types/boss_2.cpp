@@ -150,14 +150,8 @@ void Boss_2::addSpellsAndSpellSlotsAndParticleEmitters(Entity& self)
 		spellSlotContainer.spellSlots.push_back(movementSpellSlot);
 	}
 
-	ParticleEmitter dash_particle_emitter;
-	dash_particle_emitter.setNumParticles(8);
-	dash_particle_emitter.setParentEntity(self);
-	dash_particle_emitter.setInitialColor(vec4(0.75, 0.75, 1, 0.25));
-	dash_particle_emitter.setTextureAssetId(TEXTURE_ASSET_ID::PLAYER_DASH_PARTICLES);
-
 	ParticleEmitterContainer& pec = registry.particle_emitter_containers.emplace(self);
-	pec.particle_emitter_map.insert({PARTICLE_EMITTER_ID::DASH_TRAIL, dash_particle_emitter});
+	pec.add(PARTICLE_EMITTER_ID::DASH_TRAIL, dash_particles);
 }
 
 
@@ -0,0 +1,28 @@
+#include "game_systems.hpp"
+
+void GameSystems::init()
+{
+	world_system.physics = &physics_system;
+	world_system.init(&renderer_system);
+	ai_system.init(&renderer_system);
+	projectile_spell_system.renderer = &renderer_system;
+
+	// CK: be mindful of the order of your systems and rearrange this list only if necessary
+	// Systems that create or destroy entities, or run arbitrary callbacks, are exclusive. The ones that declare what they
+	// touch can share a stage with their neighbours. Only minimap, animation and particle end up sharing one (the minimap
+	// comes after the tweens for that), the camera sits between exclusive systems so it still runs on its own.
+	scheduler.add("world", SystemAccess::exclusive(), [this](float elapsed_ms) { world_system.step(elapsed_ms); }, false);
+	scheduler.add("spatial_index", SystemAccess::exclusive(), [this](float elapsed_ms) { spatial_index_system.step(elapsed_ms); });
+	scheduler.add("interactable", SystemAccess::exclusive(), [this](float elapsed_ms) { interactable_system.step(elapsed_ms); });
+	scheduler.add("ai", SystemAccess::exclusive(), [this](float elapsed_ms) { ai_system.step(elapsed_ms); });
+	scheduler.add("projectile_spell", SystemAccess::exclusive(), [this](float elapsed_ms) { projectile_spell_system.step(elapsed_ms); });
+	scheduler.add("physics", SystemAccess::exclusive(), [this](float elapsed_ms) { physics_system.step(elapsed_ms); });
+	scheduler.add("spell_slot", SystemAccess::exclusive(), [this](float elapsed_ms) { spell_slot_system.step(elapsed_ms); });
+	scheduler.add("collisions", SystemAccess::exclusive(), [this](float) { world_system.handle_collisions(); });
+	scheduler.add("camera", camera_system.getAccess(), [this](float elapsed_ms) { camera_system.step(elapsed_ms); });
+	scheduler.add("timer", SystemAccess::exclusive(), [this](float elapsed_ms) { timer_system.step(elapsed_ms); });
+	scheduler.add("tween", SystemAccess::exclusive(), [this](float elapsed_ms) { tween_system.step(elapsed_ms); }, false);
+	scheduler.add("minimap", minimap_system.getAccess(), [this](float elapsed_ms) { minimap_system.step(elapsed_ms); });
+	scheduler.add("animation", animation_system.getAccess(), [this](float elapsed_ms) { animation_system.step(elapsed_ms); }, false);
+	scheduler.add("particle", particle_system.getAccess(), [this](float elapsed_ms) { particle_system.step(elapsed_ms); });
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "physics_system.hpp"
+#include "ai_system.hpp"
+#include "render_system.hpp"
+#include "world_system.hpp"
+#include "spell_slot_system.hpp"
+#include "camera_system.hpp"
+#include "projectile_spell_system.hpp"
+#include "timer_system.hpp"
+#include "tween_system.hpp"
+#include "animation_system.hpp"
+#include "particle_system.hpp"
+#include "minimap_system.hpp"
+#include "spatial_index_system.hpp"
+#include "interactables/interactable_system.hpp"
+#include "system_scheduler.hpp"
+
+// Every system of the game, shared by main and the headless runner so both step exactly the same list
+struct GameSystems
+{
+	AISystem	  ai_system;
+	WorldSystem   world_system;
+	RenderSystem  renderer_system;
+	PhysicsSystem physics_system;
+	SpellSlotSystem spell_slot_system;
+	CameraSystem camera_system;
+	ProjectileSpellSystem projectile_spell_system;
+	TimerSystem timer_system;
+	TweenSystem tween_system;
+	AnimationSystem animation_system;
+	ParticleSystem particle_system;
+	InteractableSystem interactable_system;
+	MinimapSystem minimap_system;
+	SpatialIndexSystem spatial_index_system;
+
+	SystemScheduler scheduler;
+
+	// Hook the systems up to each other and start the game, the renderer has to be initialized first
+	void init();
+};
@@ -0,0 +1,263 @@
+#include "headless_runner.hpp"
+
+// stdlib
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// internal
+#include "game_systems.hpp"
+#include "job_system.hpp"
+#include "map_gen/room_templates.hpp"
+#include "world_init.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+	struct HeadlessScenario {
+		const char* name;
+		GAME_SCREEN_ID game_screen;
+		int default_enemies;	// added on top of the ones the screen spawns itself
+		const char* description;
+		bool is_floor_loading = false;	// time going into new floors instead of stepping the screen
+	};
+
+	const HeadlessScenario scenarios[] = {
+		{ "boss_1", GAME_SCREEN_ID::BOSS_1, 50, "boss_1 arena, the boss cycles through its attacks (spiral, dash, summon)" },
+		{ "swarm", GAME_SCREEN_ID::BOSS_1, 400, "boss_1 arena packed with enemies and their projectiles, for the thread scaling runs" },
+		{ "level_1", GAME_SCREEN_ID::LEVEL_1, 0, "a freshly generated floor" },
+		{ "hub", GAME_SCREEN_ID::HUB, 0, "the hub, next to nothing moving" },
+		{ "floors", GAME_SCREEN_ID::HUB, 0, "20 new floors entered from the hub and the shop, prints how long each load holds up the main thread", true },
+	};
+
+	struct HeadlessOptions {
+		const HeadlessScenario* scenario = nullptr;
+		int ticks = 3600;
+		float tick_ms = 1000.f / 60.f;
+		int enemies = -1;	// -1 is the scenario default
+		unsigned int seed = 1;
+		int threads = 1;
+		bool is_static_grid_used = true;
+		bool is_floor_prepared = true;
+	};
+
+	const HeadlessScenario* findScenario(const char* name) {
+		for (const HeadlessScenario& scenario : scenarios) {
+			if (strcmp(scenario.name, name) == 0) {
+				return &scenario;
+			}
+		}
+		return nullptr;
+	}
+
+	void printUsage() {
+		std::cerr << "Usage: --headless <scenario> [--ticks N] [--tick-ms MS] [--enemies N] [--seed N] [--threads N] [--no-static-grid] [--no-floor-prep]" << std::endl;
+		std::cerr << "Scenarios:" << std::endl;
+		for (const HeadlessScenario& scenario : scenarios) {
+			std::cerr << "  " << scenario.name << " - " << scenario.description << std::endl;
+		}
+	}
+
+	bool parseOptions(int argc, char* argv[], HeadlessOptions& options) {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			bool has_value = i + 1 < argc;
+
+			if (arg == "--headless" && has_value) {
+				options.scenario = findScenario(argv[++i]);
+				if (options.scenario == nullptr) {
+					std::cerr << "ERROR: Unknown scenario " << argv[i] << std::endl;
+					return false;
+				}
+			}
+			else if (arg == "--ticks" && has_value) {
+				options.ticks = atoi(argv[++i]);
+			}
+			else if (arg == "--tick-ms" && has_value) {
+				options.tick_ms = (float)atof(argv[++i]);
+			}
+			else if (arg == "--enemies" && has_value) {
+				options.enemies = atoi(argv[++i]);
+			}
+			else if (arg == "--seed" && has_value) {
+				options.seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (arg == "--threads" && has_value) {
+				options.threads = atoi(argv[++i]);
+			}
+			else if (arg == "--no-static-grid") {
+				options.is_static_grid_used = false;
+			}
+			else if (arg == "--no-floor-prep") {
+				options.is_floor_prepared = false;
+			}
+			else {
+				std::cerr << "ERROR: Bad argument " << arg << std::endl;
+				return false;
+			}
+		}
+		return options.scenario != nullptr && options.ticks > 0 && options.tick_ms > 0;
+	}
+
+	// Finish whatever transition is running, then go through the game's own transition to the screen
+	// with no fade, so the level is loaded exactly the way it is when playing
+	void loadScreen(WorldSystem& world_system, TweenSystem& tween_system, GAME_SCREEN_ID game_screen, float tick_ms) {
+		while (world_system.is_transitioning) {
+			tween_system.step(tick_ms);
+		}
+		world_system.transitionToScene(game_screen, 0.0f, 0.0f);
+		while (world_system.is_transitioning) {
+			tween_system.step(tick_ms);
+		}
+	}
+
+	// Spread enemies over random floor tiles, so they work on any map. The tiles right around the player are left out,
+	// the enemy AI can't pick a direction away from a player standing exactly on top of it
+	void spawnEnemies(RenderSystem* renderer, int num_enemies) {
+		vec2 player_position = registry.transforms.get(registry.players.entities[0]).position;
+		std::vector<vec2> spawn_positions;
+		for (Entity floor_entity : registry.floors.entities) {
+			vec2 position = registry.transforms.get(floor_entity).position;
+			if (glm::distance(position, player_position) > 2 * TILE_SIZE) {
+				spawn_positions.push_back(position);
+			}
+		}
+		if (spawn_positions.empty()) {
+			return;
+		}
+
+		for (int i = 0; i < num_enemies; i++) {
+			int spawn_index = (int)(uniform_dist(rng) * spawn_positions.size()) % spawn_positions.size();
+			createRandomEnemy(renderer, spawn_positions[spawn_index]);
+		}
+	}
+
+	// Nobody is playing, keep the player alive so the run doesn't turn into the death sequence
+	void keepPlayerAlive() {
+		Health& player_health = registry.healths.get(registry.players.entities[0]);
+		player_health.maxHealth = 1e9f;
+		player_health.currentHealth = 1e9f;
+	}
+
+	// Play the current screen for ticks ticks, fixed timestep like main
+	void stepTicks(GameSystems& systems, int ticks, float tick_ms) {
+		for (int tick = 0; tick < ticks; tick++) {
+			GAME_SCREEN_ID game_screen = systems.world_system.get_game_screen();
+			ScreenState& screen_state = registry.screenStates.get(registry.screenStates.entities[0]);
+
+			systems.scheduler.step(tick_ms, game_screen != GAME_SCREEN_ID::INTRO && !screen_state.is_paused);
+		}
+	}
+
+	// Go into new floors the way a run does, from the hub and then from the shop (the shop after the second floor leads
+	// to the outro, so it's back to the hub after that). Every screen is played for --ticks ticks, the next floor is
+	// prepared in the background meanwhile, and the main thread time of every floor load is printed
+	int runFloorLoads(GameSystems& systems, const HeadlessOptions& options) {
+		const int NUM_FLOOR_LOADS = 20;
+
+		std::cout << "Headless run: " << options.scenario->name << ", " << options.ticks << " ticks of " << options.tick_ms
+			<< " ms on every screen, seed " << options.seed << ", " << job_system.numThreads() << " threads" << std::endl;
+
+		std::vector<double> load_ms;
+		for (int i = 0; i < NUM_FLOOR_LOADS; i++) {
+			loadScreen(systems.world_system, systems.tween_system, i % 2 == 0 ? GAME_SCREEN_ID::HUB : GAME_SCREEN_ID::IN_BETWEEN, options.tick_ms);
+			keepPlayerAlive();
+			stepTicks(systems, options.ticks, options.tick_ms);
+
+			auto load_start = Clock::now();
+			loadScreen(systems.world_system, systems.tween_system, GAME_SCREEN_ID::LEVEL_1, options.tick_ms);
+			load_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - load_start).count());
+			std::printf("floor %2d from the %-4s %8.3f ms, %zu tiles, %zu enemy rooms\n", i + 1, i % 2 == 0 ? "hub" : "shop",
+				load_ms.back(), registry.tiles.size(), registry.enemyRoomManagers.size());
+
+			keepPlayerAlive();
+			stepTicks(systems, options.ticks, options.tick_ms);
+		}
+
+		std::vector<double> sorted_ms = load_ms;
+		std::sort(sorted_ms.begin(), sorted_ms.end());
+		std::printf("floor load: median %.3f ms, max %.3f ms\n", sorted_ms[sorted_ms.size() / 2], sorted_ms.back());
+		return EXIT_SUCCESS;
+	}
+
+	// Sum over the whole simulation state that moves, runs with the same seed have to end on the same value
+	// whatever the thread count
+	double stateChecksum() {
+		double checksum = registry.enemies.size() * 1000.0 + registry.projectiles.size();
+		for (const Transformation& transform : registry.transforms.components) {
+			checksum += transform.position.x * 0.001 + transform.position.y * 0.000001;
+		}
+		return checksum;
+	}
+}
+
+bool isHeadlessRun(int argc, char* argv[]) {
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--headless") == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int runHeadless(int argc, char* argv[]) {
+	HeadlessOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	job_system.init(options.threads);
+	rng.seed(options.seed);
+
+	if (!room_templates.load()) {
+		std::cerr << "ERROR: Failed to load the room templates." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	GameSystems systems;
+	if (!systems.renderer_system.initHeadless()) {
+		std::cerr << "ERROR: Failed to read the texture assets." << std::endl;
+		return EXIT_FAILURE;
+	}
+	systems.world_system.is_headless = true;
+	systems.physics_system.is_static_geometry_baked = options.is_static_grid_used;
+	systems.world_system.is_next_floor_prepared = options.is_floor_prepared;
+	systems.init();
+
+	if (options.scenario->is_floor_loading) {
+		return runFloorLoads(systems, options);
+	}
+
+	loadScreen(systems.world_system, systems.tween_system, options.scenario->game_screen, options.tick_ms);
+
+	int num_enemies = options.enemies >= 0 ? options.enemies : options.scenario->default_enemies;
+	spawnEnemies(&systems.renderer_system, num_enemies);
+	keepPlayerAlive();
+
+	std::cout << "Headless run: " << options.scenario->name << ", " << options.ticks << " ticks of " << options.tick_ms
+		<< " ms, seed " << options.seed << ", " << job_system.numThreads() << " threads, " << registry.enemies.entities.size() << " enemies" << std::endl;
+
+	auto run_start = Clock::now();
+	stepTicks(systems, options.ticks, options.tick_ms);
+	double run_ms = std::chrono::duration<double, std::milli>(Clock::now() - run_start).count();
+
+	std::printf("%-18s %12s %10s %12s\n", "system", "total ms", "ms/tick", "ticks/sec");
+	for (int i = 0; i < systems.scheduler.numSystems(); i++) {
+		double system_ms = systems.scheduler.getTotalMs(i);
+		double ms_per_tick = system_ms / options.ticks;
+		std::printf("%-18s %12.2f %10.4f %12.0f\n", systems.scheduler.getName(i), system_ms, ms_per_tick,
+			ms_per_tick > 0 ? 1000.0 / ms_per_tick : 0.0);
+	}
+	double ms_per_tick = run_ms / options.ticks;
+	std::printf("%-18s %12.2f %10.4f %12.0f\n", "all", run_ms, ms_per_tick, 1000.0 / ms_per_tick);
+	std::cout << "At the end: " << registry.enemies.entities.size() << " enemies, "
+		<< registry.projectiles.entities.size() << " projectiles, state checksum " << std::fixed << stateChecksum() << std::endl;
+
+	return EXIT_SUCCESS;
+}
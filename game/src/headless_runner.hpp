@@ -0,0 +1,22 @@
+#pragma once
+
+// Headless mode, steps the game systems with a fixed timestep and without a window, audio or OpenGL,
+// so the simulation can be timed on a machine with no display. Started from the command line with
+//
+//	Cleanse_the_Corruption --headless <scenario> [--ticks N] [--tick-ms MS] [--enemies N] [--seed N] [--threads N]
+//		[--no-static-grid] [--no-floor-prep]
+//
+// A scenario loads one of the game screens and adds enemies to it (see scenarios in headless_runner.cpp).
+// When the run is over the time spent in every system is printed, per tick and as ticks per second, followed by a
+// checksum of the final state that has to match between runs with the same seed and a different number of threads.
+// --no-static-grid runs the level walls through the per-step broadphase instead of the static grid, the checksum has
+// to match that way too.
+// The floors scenario doesn't step one screen, it goes into new floors one after another and prints how long each
+// floor load held up the main thread (--ticks is then how long every screen is played before moving on).
+// --no-floor-prep generates each floor when it is entered instead of ahead of time in the hub or the shop.
+
+// Does the command line ask for headless mode?
+bool isHeadlessRun(int argc, char* argv[]);
+
+// Run the scenario given on the command line, returns the exit code for main
+int runHeadless(int argc, char* argv[]);
@@ -64,7 +64,7 @@ void HealthRestoreItem::interact(Entity interactable_entity) {
 	Transformation& player_transform = registry.transforms.get(player_entity); 
 	createTextPopup(std::to_string((int)interactable.heal_amount), HEALING_NUMBER_COLOR, 1.0, vec2(0.5), 0, player_transform.position, false);
 
-	registry.remove_all_components_of(interactable_entity);
+	registry.commands.destroy(interactable_entity);
 }
 
 void NextLevelEntry::interact(Entity interactable_entity) {
@@ -88,10 +88,12 @@ void RelicDropItem::interact(Entity interactable_entity, bool apply_to_movement)
 	if (apply_to_movement) {
 		SpellSlot& movement_spell_slot = player_spell_slots.spellSlots[1];
 		movement_spell_slot.relics.push_back((RELIC_ID)interactable.relic_id);
+		movement_spell_slot.invalidateResolvedSpell();
 	}
 	else {
 		SpellSlot& projectile_spell_slot = player_spell_slots.spellSlots[0];
 		projectile_spell_slot.relics.push_back((RELIC_ID)interactable.relic_id);
+		projectile_spell_slot.invalidateResolvedSpell();
 	} 
 
 	Transformation& player_transform = registry.transforms.get(player_entity);
@@ -114,7 +116,7 @@ void RelicDropItem::interact(Entity interactable_entity, bool apply_to_movement)
 	createTextPopup(text, vec3(1.0), 1.0, vec2(0.5), 0, player_transform.position, false);
 
 	// Munn: Uncomment this, it's just for testing
-	registry.remove_all_components_of(interactable_entity);
+	registry.commands.destroy(interactable_entity);
 }
 
 void FountainInteractable::interact(Entity interactable_entity) {
@@ -6,15 +6,32 @@
 #include "tinyECS/registry.hpp"
 #include "physics_system.hpp"
 #include "interactable.hpp"
+#include "spatial_index.hpp"
 
 void InteractableSystem::step(float elapsed_ms) {
 	
 	Entity player_entity = registry.players.entities[0];
 
+	// Whatever could interact last frame has to be in range again to keep it
+	for (Entity entity : in_range) {
+		if (registry.interactables.has(entity)) {
+			registry.interactables.get(entity).can_interact = false;
+		}
+	}
+
+	// Only the interactables whose box overlaps the player's need the exact check
+	Transformation& player_transform = registry.transforms.get(player_entity);
+	Hitbox& player_hitbox = registry.hitboxes.get(player_entity);
+	vec2 half_extent = get_bounding_box(player_transform, abs(player_hitbox.hitbox_scale)) / 2.f;
+	spatial_index.queryRect(player_transform.position - half_extent, player_transform.position + half_extent, (int)COLLISION_LAYER::INTERACTABLE, in_range);
+
 	Entity nearest_entity = -1; // "null" entity
 	float nearest_distance = 99999999;
-	for (Entity entity : registry.interactables.entities) {
-		
+	for (Entity entity : in_range) {
+		if (!registry.interactables.has(entity)) {
+			continue;
+		}
+
 		Interactable& interactable = registry.interactables.get(entity);
 		interactable.can_interact = false;
 
@@ -24,7 +41,6 @@ void InteractableSystem::step(float elapsed_ms) {
 
 		// Check for collision
 		if (collides(player_entity, entity)) {
-			Transformation player_transform = registry.transforms.get(player_entity);
 			Transformation interactable_transform = registry.transforms.get(entity);
 
 			// Check if it is the nearest interactable
@@ -10,4 +10,8 @@ public:
 	void step(float elapsed_ms);
 
 	InteractableSystem() {}
+
+private:
+	// Interactables near the player this step, only these can have can_interact set
+	std::vector<Entity> in_range;
 };
\ No newline at end of file
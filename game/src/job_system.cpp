@@ -0,0 +1,154 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+
+JobSystem job_system;
+
+namespace {
+	// Queue of the current thread, -1 on threads that aren't part of the pool
+	thread_local int current_queue = -1;
+}
+
+JobSystem::~JobSystem()
+{
+	shutdown();
+}
+
+void JobSystem::init(int num_threads)
+{
+	shutdown();
+
+	if (num_threads <= 0) {
+		num_threads = std::max(1, (int)std::thread::hardware_concurrency());
+	}
+
+	queues.clear();
+	for (int i = 0; i < num_threads; i++) {
+		queues.push_back(std::make_unique<JobQueue>());
+	}
+	current_queue = 0;
+
+	is_running = true;
+	for (int i = 1; i < num_threads; i++) {
+		workers.emplace_back(&JobSystem::workerLoop, this, i);
+	}
+}
+
+void JobSystem::shutdown()
+{
+	if (workers.empty()) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		is_running = false;
+	}
+	wake.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+}
+
+void JobSystem::run(JobGroup& group, std::function<void()> job)
+{
+	if (workers.empty()) {
+		job();
+		return;
+	}
+
+	group.pending++;
+	int queue_index = current_queue >= 0 ? current_queue : (int)(next_queue++ % queues.size());
+	{
+		std::lock_guard<std::mutex> lock(queues[queue_index]->mutex);
+		queues[queue_index]->jobs.push_back([&group, job = std::move(job)]() {
+			job();
+			group.pending--;
+		});
+	}
+	num_queued++;
+
+	// Taking the lock makes sure a worker that just found nothing to do is already waiting, so it can't miss this
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+	}
+	wake.notify_one();
+}
+
+void JobSystem::wait(JobGroup& group)
+{
+	int queue_index = current_queue >= 0 ? current_queue : 0;
+	while (group.pending > 0) {
+		if (!tryRunJob(queue_index)) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::parallel_for(int count, int grain, const std::function<void(int, int)>& func)
+{
+	if (count <= 0) {
+		return;
+	}
+	grain = std::max(1, grain);
+	if (workers.empty() || count <= grain) {
+		func(0, count);
+		return;
+	}
+
+	JobGroup group;
+	for (int begin = 0; begin < count; begin += grain) {
+		int end = std::min(count, begin + grain);
+		run(group, [&func, begin, end]() { func(begin, end); });
+	}
+	wait(group);
+}
+
+bool JobSystem::tryRunJob(int queue_index)
+{
+	std::function<void()> job;
+
+	// Newest job of our own queue first, it's the most likely to still be in cache
+	{
+		JobQueue& queue = *queues[queue_index];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+		}
+	}
+
+	// Otherwise steal the oldest job of another queue
+	for (size_t i = 1; !job && i < queues.size(); i++) {
+		JobQueue& queue = *queues[(queue_index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+		}
+	}
+
+	if (!job) {
+		return false;
+	}
+	num_queued--;
+	job();
+	return true;
+}
+
+void JobSystem::workerLoop(int queue_index)
+{
+	current_queue = queue_index;
+	while (true) {
+		if (tryRunJob(queue_index)) {
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		wake.wait(lock, [this]() { return num_queued > 0 || !is_running; });
+		if (!is_running) {
+			return;
+		}
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The unfinished jobs of one batch, wait on it to block until all of them are done
+struct JobGroup {
+	std::atomic<int> pending{ 0 };
+};
+
+// Work stealing thread pool. Every thread has its own queue, it pushes and pops at the back of it and once it runs dry
+// it steals from the front of the other queues. A thread waiting on a group runs queued jobs until the group is done,
+// so a job can wait on jobs of its own (eg. a system running as a job can parallel_for).
+// With a single thread there are no workers and every job runs right away on the calling thread.
+class JobSystem
+{
+public:
+	~JobSystem();
+
+	// Threads in total, including the calling (main) thread. 0 picks one per core
+	void init(int num_threads);
+	void shutdown();
+	int numThreads() const { return (int)workers.size() + 1; }
+
+	void run(JobGroup& group, std::function<void()> job);
+	void wait(JobGroup& group);
+
+	// Calls func(begin, end) over [0, count) in chunks of at most grain items and returns once all are done.
+	// Every index is visited exactly once, so as long as func only writes to the items it was handed the
+	// result doesn't depend on the number of threads.
+	void parallel_for(int count, int grain, const std::function<void(int, int)>& func);
+
+private:
+	struct JobQueue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> jobs;
+	};
+
+	std::vector<std::thread> workers;
+	std::vector<std::unique_ptr<JobQueue>> queues;	// one per thread, 0 is the thread that called init
+	std::atomic<int> num_queued{ 0 };
+	std::atomic<unsigned int> next_queue{ 0 };	// where jobs pushed from outside the pool go, round robin
+	bool is_running = false;
+
+	// Idle workers sleep here until a job is pushed
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+
+	bool tryRunJob(int queue_index);
+	void workerLoop(int queue_index);
+};
+
+extern JobSystem job_system;
@@ -4,42 +4,63 @@
 
 // stdlib
 #include <chrono>
+#include <cstring>
 #include <iostream>
 
 // internal
-#include "physics_system.hpp"
-#include "ai_system.hpp"
-#include "render_system.hpp"
-#include "world_system.hpp"
-#include "spell_slot_system.hpp"
-#include "camera_system.hpp"
-#include "projectile_spell_system.hpp"
-#include "timer_system.hpp"
-#include "tween_system.hpp"
-#include "animation_system.hpp"
-#include "particle_system.hpp"
-#include "minimap_system.hpp"
-#include "interactables/interactable_system.hpp"
+#include "benchmarks/benchmarks.hpp"
+#include "game_systems.hpp"
+#include "job_system.hpp"
+#include "headless_runner.hpp"
+#include "map_gen/map_farm.hpp"
+#include "map_gen/room_templates.hpp"
+#include "profiler.hpp"
 
 using Clock = std::chrono::high_resolution_clock;
 
 // Entry point
-int main()
+int main(int argc, char* argv[])
 {
+	// Simulation only, no window (see headless_runner.hpp)
+	if (isHeadlessRun(argc, argv)) {
+		return runHeadless(argc, argv);
+	}
+
+	// Floor generation only, no game at all (see map_farm.hpp)
+	if (isMapFarmRun(argc, argv)) {
+		return runMapFarm(argc, argv);
+	}
+
+	// Engine micro benchmarks, no game at all (see benchmarks.hpp)
+	if (isBenchmarkRun(argc, argv)) {
+		return runBenchmark(argc, argv);
+	}
+
+	// --profile-dump <seconds> writes the last seconds as a chrome trace when the game closes, F4 does it at any time
+	// --threads <n> sets the size of the job system, one thread per core by default
+	bool is_trace_dumped_on_exit = false;
+	int num_threads = 0;
+	for (int i = 1; i + 1 < argc; i++) {
+		if (strcmp(argv[i], "--profile-dump") == 0) {
+			profiler.dump_seconds = (float)atof(argv[i + 1]);
+			is_trace_dumped_on_exit = true;
+		}
+		if (strcmp(argv[i], "--threads") == 0) {
+			num_threads = atoi(argv[i + 1]);
+		}
+	}
+	job_system.init(num_threads);
+
+	// Every room layout the maps are made of, parsed once
+	if (!room_templates.load()) {
+		std::cerr << "ERROR: Failed to load the room templates." << std::endl;
+		return EXIT_FAILURE;
+	}
+
 	// global systems
-	AISystem	  ai_system;
-	WorldSystem   world_system;
-	RenderSystem  renderer_system;
-	PhysicsSystem physics_system;
-	SpellSlotSystem spell_slot_system;
-	CameraSystem camera_system;
-	ProjectileSpellSystem projectile_spell_system;
-	TimerSystem timer_system;
-	TweenSystem tween_system;
-	AnimationSystem animation_system;
-	ParticleSystem particle_system;
-	InteractableSystem interactable_system;
-	MinimapSystem minimap_system;
+	GameSystems systems;
+	WorldSystem& world_system = systems.world_system;
+	RenderSystem& renderer_system = systems.renderer_system;
 
 	int seed = std::chrono::system_clock::now().time_since_epoch().count();
 	//int seed = -1070238144;
@@ -62,13 +83,12 @@ int main()
 	std::cout << "Initializing renderer" << std::endl;
 	// initialize the main systems
 	renderer_system.init(window);
-	world_system.init(&renderer_system);
-	ai_system.init(&renderer_system);
-	projectile_spell_system.renderer = &renderer_system;
+	systems.init();
 
 	// variable timestep loop
 	auto t = Clock::now();
 	while (!world_system.is_over()) {
+		PROFILE_SCOPE("frame");
 
 		// Mark: Check game screen and pause status
 		GAME_SCREEN_ID game_screen = world_system.get_game_screen();
@@ -83,6 +103,7 @@ int main()
 		float elapsed_ms =
 			(float)(std::chrono::duration_cast<std::chrono::microseconds>(now - t)).count() / 1000;
 		t = now;
+		profiler.endFrame(elapsed_ms);
 
 		/*if (world_system.player_dead) {
 			world_system.player_dead = false;
@@ -94,38 +115,15 @@ int main()
 
 		//std::cout << "Frames per second: " << 1 / (elapsed_ms / 1000.0) << std::endl; // Munn: we can use this for FPS counter requirement
 
-		// CK: be mindful of the order of your systems and rearrange this list only if necessary
-		world_system.step(elapsed_ms);
+		// See GameSystems::init for the systems and their order
+		systems.scheduler.step(elapsed_ms, game_screen != GAME_SCREEN_ID::INTRO && !screen_state.is_paused);
 
-		if (game_screen != GAME_SCREEN_ID::INTRO && !screen_state.is_paused)
-		{
-			interactable_system.step(elapsed_ms);
-
-			ai_system.step(elapsed_ms);
-
-			projectile_spell_system.step(elapsed_ms);
-
-			physics_system.step(elapsed_ms);
-
-			spell_slot_system.step(elapsed_ms);
-
-			world_system.handle_collisions();
-
-			camera_system.step(elapsed_ms);
-
-			timer_system.step(elapsed_ms);
-
-			minimap_system.step(elapsed_ms);
-		}
-
-		tween_system.step(elapsed_ms);
-    
-		animation_system.step(elapsed_ms);
-
-		if (game_screen != GAME_SCREEN_ID::INTRO && !screen_state.is_paused)
-			particle_system.step(elapsed_ms);
+		{ PROFILE_SCOPE("draw"); renderer_system.draw(game_screen); }
+	}
 
-		renderer_system.draw(game_screen);
+	if (is_trace_dumped_on_exit) {
+		std::string trace_path = profiler.dumpChromeTrace(profiler.dump_seconds);
+		std::cout << (trace_path.empty() ? "ERROR: Failed to write the profiler trace" : "Wrote profiler trace to " + trace_path) << std::endl;
 	}
 
 	return EXIT_SUCCESS;
@@ -0,0 +1,215 @@
+#include "map_farm.hpp"
+
+// stdlib
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// internal
+#include "job_system.hpp"
+#include "map_layout.hpp"
+#include "room_templates.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+	const int MAPS_PER_JOB = 16;
+	const int MAX_BROKEN_SEEDS_PRINTED = 20;
+
+	struct MapFarmOptions {
+		int num_maps = 0;
+		unsigned int first_seed = 1;
+		int threads = 0;	// one per core
+	};
+
+	// What is kept of every floor once it has been checked
+	struct FarmedMap {
+		int num_rooms = 0;
+		int num_enemy_rooms = 0;
+		int num_chest_rooms = 0;
+		int num_unreachable_rooms = 0;
+		uint64_t tiles_hash = 0;
+	};
+
+	void printUsage() {
+		std::cerr << "Usage: --map-farm <num_maps> [--first-seed N] [--threads N]" << std::endl;
+	}
+
+	bool parseOptions(int argc, char* argv[], MapFarmOptions& options) {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			bool has_value = i + 1 < argc;
+
+			if (arg == "--map-farm" && has_value) {
+				options.num_maps = atoi(argv[++i]);
+			}
+			else if (arg == "--first-seed" && has_value) {
+				options.first_seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (arg == "--threads" && has_value) {
+				options.threads = atoi(argv[++i]);
+			}
+			else {
+				std::cerr << "ERROR: Bad argument " << arg << std::endl;
+				return false;
+			}
+		}
+		return options.num_maps > 0;
+	}
+
+	// Number of rooms that can't be walked to from the spawn room, over room and corridor tiles (anything above a wall).
+	// A room counts as reached as soon as one of its tiles is
+	int countUnreachableRooms(const MapLayout& layout, std::vector<uint8_t>& is_reached, std::vector<int>& stack) {
+		const MapGrid& grid = layout.grid;
+		is_reached.assign(grid.tiles.size(), 0);
+		stack.clear();
+
+		// Start from any tile of the spawn room
+		for (int node_index : layout.room_nodes) {
+			const MapNode& node = layout.nodes[node_index];
+			if (node.content != ROOM_CONTENT::PLAYER_SPAWN) {
+				continue;
+			}
+			auto spawn_tile = std::find(grid.tiles.begin(), grid.tiles.end(), (uint8_t)node.room_number);
+			if (spawn_tile != grid.tiles.end()) {
+				int tile = (int)(spawn_tile - grid.tiles.begin());
+				is_reached[tile] = 1;
+				stack.push_back(tile);
+			}
+		}
+
+		while (!stack.empty()) {
+			int tile = stack.back();
+			stack.pop_back();
+			int x = tile % grid.length;
+			int y = tile / grid.length;
+
+			const ivec2 neighbours[] = { { x - 1, y }, { x + 1, y }, { x, y - 1 }, { x, y + 1 } };
+			for (ivec2 neighbour : neighbours) {
+				if (neighbour.x < 0 || neighbour.y < 0 || neighbour.x >= grid.length || neighbour.y >= grid.height) {
+					continue;
+				}
+				int neighbour_tile = neighbour.y * grid.length + neighbour.x;
+				if (!is_reached[neighbour_tile] && grid.tiles[neighbour_tile] >= 2) {
+					is_reached[neighbour_tile] = 1;
+					stack.push_back(neighbour_tile);
+				}
+			}
+		}
+
+		bool is_room_reached[256] = {};
+		for (size_t tile = 0; tile < grid.tiles.size(); tile++) {
+			if (is_reached[tile]) {
+				is_room_reached[grid.tiles[tile]] = true;
+			}
+		}
+
+		int num_unreachable_rooms = 0;
+		for (int node_index : layout.room_nodes) {
+			if (!is_room_reached[layout.nodes[node_index].room_number]) {
+				num_unreachable_rooms++;
+			}
+		}
+		return num_unreachable_rooms;
+	}
+
+	// FNV-1a over the tiles, the same seed has to give the same floor
+	uint64_t hashTiles(const MapGrid& grid) {
+		uint64_t hash = 14695981039346656037ull;
+		for (uint8_t tile : grid.tiles) {
+			hash = (hash ^ tile) * 1099511628211ull;
+		}
+		return hash;
+	}
+}
+
+bool isMapFarmRun(int argc, char* argv[]) {
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--map-farm") == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int runMapFarm(int argc, char* argv[]) {
+	MapFarmOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	job_system.init(options.threads);
+
+	if (!room_templates.load()) {
+		std::cerr << "ERROR: Failed to load the room templates." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "Map farm: " << options.num_maps << " floors from seed " << options.first_seed << ", "
+		<< job_system.numThreads() << " threads" << std::endl;
+
+	// Every floor only writes its own entry, so the results don't depend on the thread count
+	std::vector<FarmedMap> maps(options.num_maps);
+	auto run_start = Clock::now();
+	job_system.parallel_for(options.num_maps, MAPS_PER_JOB, [&](int begin, int end) {
+		// One layout per job, every floor after the first one reuses its memory
+		MapLayout layout;
+		std::vector<uint8_t> is_reached;
+		std::vector<int> stack;
+		for (int i = begin; i < end; i++) {
+			generateMapLayout(layout, options.first_seed + i);
+
+			FarmedMap& map = maps[i];
+			map.num_rooms = layout.numRooms();
+			map.num_enemy_rooms = layout.num_enemy_rooms;
+			map.num_chest_rooms = layout.num_chest_rooms;
+			map.num_unreachable_rooms = countUnreachableRooms(layout, is_reached, stack);
+			map.tiles_hash = hashTiles(layout.grid);
+		}
+	});
+	double run_ms = std::chrono::duration<double, std::milli>(Clock::now() - run_start).count();
+
+	int min_rooms = maps[0].num_rooms;
+	int max_rooms = maps[0].num_rooms;
+	double total_rooms = 0;
+	double total_enemy_rooms = 0;
+	double total_chest_rooms = 0;
+	int num_broken_maps = 0;
+	uint64_t checksum = 0;
+	for (const FarmedMap& map : maps) {
+		min_rooms = std::min(min_rooms, map.num_rooms);
+		max_rooms = std::max(max_rooms, map.num_rooms);
+		total_rooms += map.num_rooms;
+		total_enemy_rooms += map.num_enemy_rooms;
+		total_chest_rooms += map.num_chest_rooms;
+		if (map.num_unreachable_rooms > 0) {
+			num_broken_maps++;
+		}
+		checksum = checksum * 31 + map.tiles_hash;
+	}
+
+	std::printf("%d floors in %.2f ms, %.0f maps/sec, %.4f ms per floor per thread\n", options.num_maps, run_ms,
+		options.num_maps * 1000.0 / run_ms, run_ms * job_system.numThreads() / options.num_maps);
+	std::printf("rooms per floor: %d min, %.2f avg, %d max (%.2f enemy, %.2f chest)\n", min_rooms,
+		total_rooms / options.num_maps, max_rooms, total_enemy_rooms / options.num_maps, total_chest_rooms / options.num_maps);
+	std::printf("floors with a room that can't be reached from the spawn: %d (%.2f%%)\n", num_broken_maps,
+		num_broken_maps * 100.0 / options.num_maps);
+
+	int num_printed = 0;
+	for (int i = 0; i < options.num_maps && num_printed < MAX_BROKEN_SEEDS_PRINTED; i++) {
+		if (maps[i].num_unreachable_rooms > 0) {
+			std::printf("  seed %u: %d of %d rooms unreachable\n", options.first_seed + i, maps[i].num_unreachable_rooms, maps[i].num_rooms);
+			num_printed++;
+		}
+	}
+	std::printf("tiles checksum %016llx\n", (unsigned long long)checksum);
+
+	return num_broken_maps == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// Map farm, generates floor layouts (everything createMap does except creating the entities) for a range of seeds on
+// every core, to tune the generation constants over a lot of floors at once. Started from the command line with
+//
+//	Cleanse_the_Corruption --map-farm <num_maps> [--first-seed N] [--threads N]
+//
+// Every floor is flood filled from the spawn room to check that all of its rooms can be walked to. When it is done
+// the maps per second and room stats are printed with the seeds of the broken floors, followed by a checksum of all
+// the tiles that has to match between runs with a different number of threads.
+
+// Does the command line ask for the map farm?
+bool isMapFarmRun(int argc, char* argv[]);
+
+// Generate the floors given on the command line, returns the exit code for main
+int runMapFarm(int argc, char* argv[]);
@@ -3,7 +3,40 @@
 #include "common.hpp"
 #include "tinyECS/tiny_ecs.hpp"
 #include "render_system.hpp"
-
+#include "map_layout.hpp"
+
+#include <vector>
+
+// A floor or wall sprite that createMap will create
+struct TileBlueprint {
+	vec2 position;
+	vec2 tilecoord;	// which sprite of the tileset
+	bool is_wall = false;
+};
+
+// A merged wall collision that createMap will create
+struct WallCollisionBlueprint {
+	vec2 position;
+	vec2 scale;
+};
+
+// A procedurally generated floor with everything worked out but nothing in the registry yet. prepareFloor only touches
+// the blueprint, so it can run on another thread (see WorldSystem::prepareNextFloor), createMap then only has to make
+// the entities.
+struct FloorBlueprint {
+	MapLayout layout;
+	vec2 position = vec2(0, 0);
+	std::vector<TileBlueprint> tiles;
+	std::vector<WallCollisionBlueprint> wall_collisions;
+};
+
+// Generate the floor of seed at position, reusing the memory floor already has
+void prepareFloor(FloorBlueprint& floor, unsigned int seed, vec2 position);
+
+// Create the entities of a prepared floor, main thread only
+void createMap(RenderSystem* renderer, const FloorBlueprint& floor);
+
+// Prepare a floor seeded from the game's rng and create it right away
 void createMap(RenderSystem* renderer, vec2 position);
 
 void createTutorialMap(RenderSystem* renderer, vec2 position);
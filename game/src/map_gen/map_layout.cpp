@@ -0,0 +1,556 @@
+#include "map_layout.hpp"
+#include "room_templates.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+// Constants for map generation (lots of tweaking may need to be done to get the map to look "right")
+const int MAP_LENGTH = 100;
+const int MAP_HEIGHT = 100;
+
+const int MIN_ROOM_WIDTH = 8;
+const int MIN_ROOM_HEIGHT = 8;
+
+const int MAX_ROOM_ADJUST_SIZE = 4;
+
+const int MIN_ROOM_TILES = 500;
+const float MIN_SPLIT_PERCENTAGE = 0.45f;
+// this ensures that when we split the last time, we'll always have
+// at least min_room_tiles in the children
+const int MAX_ROOM_TILES = MIN_ROOM_TILES / (1 - MIN_SPLIT_PERCENTAGE);
+
+const int CORRIDOR_THICKNESS = 2;
+
+const int MIN_WALL_THICKNESS = 8;
+
+// Room generation related constants
+// Munn: Just random notes for myself. Let's say you have 16 rooms, and you want to fill them with stuff.
+//		 One room must be for the player spawn
+//		 One room must be for the exit
+//		 So you have 14 rooms to fill with enemies/chests or whatever
+//		 4 chest rooms
+//		 10 rooms to be just filled with enemies
+//		 Other ideas for rooms:
+//			- "Ritual" rooms, sacrifice your hp for some sort of buff
+//			- "Fountain" rooms, which just restore your health to full when you drink the fountain
+//			- Hades-esque special rooms, where you are locked in for X seconds, and must just survive until the end. You will be rewarded for surviving
+
+const int MAX_ENEMY_ROOMS = 10;
+const int MAX_CHEST_ROOMS = 4;
+
+const vec2 PLAYER_SPAWN_ROOM_SIZE = vec2(9, 9);
+const vec2 EXIT_ROOM_SIZE = vec2(9, 9);
+const vec2 CHEST_ROOM_SIZE = vec2(7, 7);
+const vec2 FOUNTAIN_ROOM_SIZE = vec2(7, 7);
+
+
+float getRandomSplitPercent(MapLayout& layout, float max_split_percentage) {
+	float random_split_percentage = 0;
+
+	while (random_split_percentage <= max_split_percentage || random_split_percentage >= 1 - max_split_percentage) {
+		random_split_percentage = layout.uniform_dist(layout.rng);
+	}
+
+	return random_split_percentage;
+}
+
+void adjustRoomSize(MapLayout& layout, int node_index, vec2 new_size) {
+	MapGrid& grid = layout.grid;
+	MapNode& node = layout.nodes[node_index];
+
+	// Empty all room info
+	for (int x = node.array_pos.x; x < node.array_pos.x + node.size.x; x++) {
+		for (int y = node.array_pos.y; y < node.array_pos.y + node.size.y; y++) {
+			grid.at(x, y) = 0;
+		}
+	}
+
+	new_size -= vec2(1);
+
+	// Find center of the room
+	vec2 roomCenterPos = vec2(
+		((int)node.array_pos.x + (int)(node.size.x) / 2),
+		((int)node.array_pos.y + (int)(node.size.y) / 2)
+	);
+
+	// Construct smaller room around center
+	for (int x = roomCenterPos.x - (new_size.x / 2); x <= roomCenterPos.x + (new_size.x / 2); x++) {
+		if (x <= 0 || x >= grid.length) {
+			continue;
+		}
+		for (int y = roomCenterPos.y - (new_size.y / 2); y <= roomCenterPos.y + (new_size.y / 2); y++) {
+			if (y <= 0 || y >= grid.height) {
+				continue;
+			}
+
+			grid.at(x, y) = node.room_number;
+		}
+	}
+
+	// Adjust node properties
+	node.array_pos.x = roomCenterPos.x - (new_size.x / 2);
+	node.array_pos.y = roomCenterPos.y - (new_size.y / 2);
+	node.size = new_size;
+}
+
+void createEnemyRoomFromTemplate(MapLayout& layout, int node_index, int room_template) {
+
+	const MapGrid& file_grid = room_templates.getEnemyRoom(room_template);
+
+	// Adjust room size (Munn: if we want to be super efficient, we could just set the tile info as we adjust the room size, but I'm too lazy atm)
+	vec2 new_size = vec2(
+		file_grid.length,
+		file_grid.height
+	);
+	adjustRoomSize(layout, node_index, new_size);
+
+	MapNode& node = layout.nodes[node_index];
+
+	// Copy tiles info into room
+	for (int x = 0; x < new_size.x; x++) {
+		for (int y = 0; y < new_size.y; y++) {
+			int tile_info = file_grid.at(x, y);
+
+			vec2 tile_pos = vec2(
+				node.array_pos.x + x,
+				node.array_pos.y + y
+			);
+
+			// I don't know why... but without this there's a weird placement bug?
+			int x_size = new_size.x;
+			int y_size = new_size.y;
+			if (x_size % 2 == 0) {
+				tile_pos.x -= 0.5;
+			}
+			if (y_size % 2 == 0) {
+				tile_pos.y -= 0.5;
+			}
+
+			if (tile_info == 0) {
+				tile_info = node.room_number;
+			}
+			if (tile_info == 3) {
+				layout.box_positions.push_back(tile_pos);
+				tile_info = node.room_number;
+			}
+
+			layout.grid.at(node.array_pos.x + x, node.array_pos.y + y) = tile_info;
+		}
+	}
+}
+
+void fillRoomContent(MapLayout& layout, int node_index) {
+	MapNode& node = layout.nodes[node_index];
+
+	// Spawn Player Here
+	if (node.room_number == 3) {
+		adjustRoomSize(layout, node_index, PLAYER_SPAWN_ROOM_SIZE);
+		node.content = ROOM_CONTENT::PLAYER_SPAWN;
+		node.isFilled = true;
+		return;
+	}
+
+	// Munn: Currently it generates the exit at room 15, which is usually near the bottom right of the map
+	if (!layout.is_exit_generated && node.room_number == 15) {
+		layout.is_exit_generated = true;
+		adjustRoomSize(layout, node_index, EXIT_ROOM_SIZE);
+		// Random boss
+		node.boss_number = layout.uniform_dist(layout.rng) > 0.5 ? 1 : 2;
+		node.content = ROOM_CONTENT::FLOOR_EXIT;
+		node.isFilled = true;
+		return;
+	}
+
+	if (layout.num_enemy_rooms < MAX_ENEMY_ROOMS) {
+		float chance_to_spawn_enemy_room = (float)(MAX_ENEMY_ROOMS - layout.num_enemy_rooms + 1) / (float)MAX_ENEMY_ROOMS;
+
+		float rand = layout.uniform_dist(layout.rng);
+
+		if (rand < chance_to_spawn_enemy_room) {
+			// Adjust map according to enemy room file
+			node.room_template = (int)(layout.uniform_dist(layout.rng) * room_templates.numEnemyRooms());
+			node.content = ROOM_CONTENT::ENEMY;
+			node.isFilled = true;
+			createEnemyRoomFromTemplate(layout, node_index, node.room_template);
+			layout.num_enemy_rooms++;
+			return;
+		}
+	}
+
+	if (layout.num_chest_rooms < MAX_CHEST_ROOMS) {
+		float chance_to_spawn_chest_room = (float)(MAX_CHEST_ROOMS - layout.num_chest_rooms + 1) / (float)MAX_CHEST_ROOMS;
+
+		float rand = layout.uniform_dist(layout.rng);
+
+		if (rand < chance_to_spawn_chest_room) {
+			adjustRoomSize(layout, node_index, CHEST_ROOM_SIZE);
+			node.content = ROOM_CONTENT::CHEST;
+			node.isFilled = true;
+			layout.num_chest_rooms++;
+			return;
+		}
+	}
+}
+
+void fillUniqueRoom(MapLayout& layout, int node_index) {
+	if (layout.remaining_unique_rooms.size() == 0) {
+		return;
+	}
+
+	int rand_index = (int)(layout.uniform_dist(layout.rng) * layout.remaining_unique_rooms.size());
+
+	ROOM_CONTENT content = layout.remaining_unique_rooms[rand_index];
+
+	switch (content) {
+	case ROOM_CONTENT::FOUNTAIN:
+	case ROOM_CONTENT::SACRIFICE: {
+		adjustRoomSize(layout, node_index, FOUNTAIN_ROOM_SIZE);
+		break;
+	}
+	default:
+		// Choice and mimic rooms keep the size they have
+		break;
+	}
+
+	layout.remaining_unique_rooms.erase(layout.remaining_unique_rooms.begin() + rand_index);
+
+	MapNode& node = layout.nodes[node_index];
+	node.content = content;
+	node.isFilled = true;
+}
+
+// THIS is where we build rooms.
+// TODO: Add different sized and shaped rooms here (don't jsut fill the cell)
+void fillRoomTiles(MapLayout& layout, int node_index) {
+	MapNode& node = layout.nodes[node_index];
+
+	int room_size_adjust_x_left = (int)(layout.uniform_dist(layout.rng) * MAX_ROOM_ADJUST_SIZE / 2);
+	int room_size_adjust_x_right = (int)(layout.uniform_dist(layout.rng) * MAX_ROOM_ADJUST_SIZE / 2);
+	int room_size_adjust_y_top = (int)(layout.uniform_dist(layout.rng) * MAX_ROOM_ADJUST_SIZE / 2);
+	int room_size_adjust_y_bottom = (int)(layout.uniform_dist(layout.rng) * MAX_ROOM_ADJUST_SIZE / 2);
+
+	vec2 room_size = vec2(0, 0);
+	for (int i = node.array_pos.x + MIN_WALL_THICKNESS + room_size_adjust_x_left; i < node.array_pos.x + node.size.x - 1 - room_size_adjust_x_right; i++) {
+		room_size.y = 0;
+		for (int j = node.array_pos.y + MIN_WALL_THICKNESS + room_size_adjust_y_top; j < node.array_pos.y + node.size.y - 1 - room_size_adjust_y_bottom; j++) {
+			layout.grid.at(i, j) = layout.current_room;
+			room_size.y++;
+		}
+		room_size.x++;
+	}
+
+	node.array_pos.x = (int)(node.array_pos.x + MIN_WALL_THICKNESS + room_size_adjust_x_left);
+	node.array_pos.y = (int)(node.array_pos.y + MIN_WALL_THICKNESS + room_size_adjust_y_top);
+
+	node.size = room_size;
+
+	node.room_number = layout.current_room;
+
+	layout.room_nodes.push_back(node_index);
+
+	layout.current_room++;
+}
+
+vec2 getTopLeftRecursive(const MapLayout& layout, int node_index) {
+	const MapNode& node = layout.nodes[node_index];
+	if (!node.hasChildren) {
+		return vec2(
+			node.array_pos.x,	// Left
+			node.array_pos.y	// Top
+		);
+	}
+
+	vec2 child_one_top_left = getTopLeftRecursive(layout, node.child_one);
+	vec2 child_two_top_left = getTopLeftRecursive(layout, node.child_two);
+
+	vec2 top_leftest = vec2(
+		min(child_one_top_left.x, child_two_top_left.x),
+		min(child_one_top_left.y, child_two_top_left.y)
+	);
+
+	return top_leftest;
+}
+
+vec2 getBottomRightRecursive(const MapLayout& layout, int node_index) {
+	const MapNode& node = layout.nodes[node_index];
+	if (!node.hasChildren) {
+		return vec2(
+			node.array_pos.x + node.size.x,	// Right
+			node.array_pos.y + node.size.y	// Bottom
+		);
+	}
+
+	vec2 child_one_bottom_right = getBottomRightRecursive(layout, node.child_one);
+	vec2 child_two_bottom_right = getBottomRightRecursive(layout, node.child_two);
+
+	vec2 bottom_rightest = vec2(
+		max(child_one_bottom_right.x, child_two_bottom_right.x),
+		max(child_one_bottom_right.y, child_two_bottom_right.y)
+	);
+
+	return bottom_rightest;
+}
+
+void connectMapNodesRecursive(MapLayout& layout, int node_index) {
+	const MapNode& node = layout.nodes[node_index];
+	MapGrid& grid = layout.grid;
+
+	if (!node.hasChildren) {
+		return;
+	}
+
+	connectMapNodesRecursive(layout, node.child_one);
+	connectMapNodesRecursive(layout, node.child_two);
+
+	// Connect child 1 and 2
+	// NOTE: if split vertically, child 1 is on TOP. if split horizontally, child 1 is on LEFT
+
+	vec2 child_one_top_left = getTopLeftRecursive(layout, node.child_one);
+	vec2 child_one_bottom_right = getBottomRightRecursive(layout, node.child_one);
+
+	vec2 child_two_top_left = getTopLeftRecursive(layout, node.child_two);
+	vec2 child_two_bottom_right = getBottomRightRecursive(layout, node.child_two);
+
+	// the next large chunk of code is to find two tiles that we want to connect
+	int room_one_right = child_one_bottom_right.x;
+	int room_one_left = child_one_top_left.x;
+	int room_one_top = child_one_top_left.y;
+	int room_one_bottom = child_one_bottom_right.y;
+
+	int room_two_right = child_two_bottom_right.x;
+	int room_two_left = child_two_top_left.y;
+	int room_two_top = child_two_top_left.y;
+	int room_two_bottom = child_two_bottom_right.y;
+
+
+	vec2 child_one_tile;
+	vec2 child_two_tile;
+	if (node.split_vertically) {
+		float rand = clamp(layout.normal_dist(layout.rng), 0.0f, 1.0f);
+
+		int rooms_y_min = max(room_one_top, room_two_top);
+		int rooms_y_max = min(room_one_bottom, room_two_bottom);
+
+		int rooms_y_overlap = rooms_y_max - rooms_y_min;
+
+		int random_height = clamp(rooms_y_min + rand * rooms_y_overlap, (float)rooms_y_min + 1, (float)rooms_y_max - CORRIDOR_THICKNESS);
+
+		child_one_tile = vec2(room_one_right, random_height);
+		child_two_tile = vec2(room_two_left, random_height);
+	}
+	else {
+		float rand = clamp(layout.normal_dist(layout.rng), 0.0f, 1.0f);
+
+		int rooms_x_min = max(room_one_left, room_two_left);
+		int rooms_x_max = min(room_one_right, room_two_right);
+
+		int rooms_x_overlap = rooms_x_max - rooms_x_min;
+
+		int random_width = clamp(rooms_x_min + rand * rooms_x_overlap, (float)rooms_x_min + 1, (float)rooms_x_max - CORRIDOR_THICKNESS);
+
+		child_one_tile = vec2(random_width, room_one_bottom);
+		child_two_tile = vec2(random_width, room_two_top);
+	}
+
+	// CONNECT The cells
+	int i = child_one_tile.x;
+	int j = child_one_tile.y;
+	if (node.split_vertically) {
+		for (int corridor_j = 0; corridor_j < CORRIDOR_THICKNESS; corridor_j++) {
+			i = room_one_right + 1;
+
+			// Step back until you are out of the wall
+			while (grid.at(i, j + corridor_j) == 0) {
+				i--;
+				if (i <= room_one_left) {
+					break;
+				}
+			}
+
+			// Step back into the wall
+			i++;
+
+			// Turn into corridors
+			while (grid.at(i, j + corridor_j) == 0) {
+
+				grid.at(i, j + corridor_j) = 2;
+				i++;
+
+				if (i >= room_two_right) {
+					break;
+				}
+			}
+		}
+	}
+	else {
+		for (int corridor_i = 0; corridor_i < CORRIDOR_THICKNESS; corridor_i++) {
+			j = room_one_bottom + 1;
+
+			while (grid.at(i + corridor_i, j) == 0) {
+				j--;
+				if (j <= room_one_top) {
+					break;
+				}
+			}
+
+			j++;
+
+			while (grid.at(i + corridor_i, j) == 0) {
+
+				grid.at(i + corridor_i, j) = 2;
+				j++;
+
+				if (j >= room_two_bottom) {
+					break;
+				}
+			}
+		}
+	}
+}
+
+bool shouldSplitVertically(MapLayout& layout, int x, int y) {
+
+	bool shouldSplitRandomly = abs(x - y) <= 2 && x > 3 && y > 3 && x * y > 50;
+	if (shouldSplitRandomly) {
+		return layout.uniform_dist(layout.rng) > 0.5f;
+	}
+
+	return x >= y;
+}
+
+// Returns the index of the new node, its children come after it in layout.nodes
+int populateMapWithArray(MapLayout& layout, vec2 array_pos, vec2 current_map_size, int max_room_tiles, float max_split_percentage) {
+
+	int node_index = (int)layout.nodes.size();
+	layout.nodes.emplace_back();
+	{
+		MapNode& cur_node = layout.nodes[node_index];
+		cur_node.array_pos = array_pos;
+		cur_node.size = current_map_size;
+		cur_node.room_number = -1; // no room, just children
+	}
+
+	if (current_map_size.x * current_map_size.y <= max_room_tiles) {
+		layout.nodes[node_index].room_number = layout.current_room;
+		fillRoomTiles(layout, node_index);
+		return node_index;
+	}
+	bool split_vertically = shouldSplitVertically(layout, current_map_size.x, current_map_size.y);
+
+	float random_split_percentage = getRandomSplitPercent(layout, max_split_percentage);
+
+	vec2 child_one_size;
+	vec2 child_two_size;
+	vec2 new_pos = array_pos;
+
+	if (split_vertically) {
+		child_one_size = vec2(current_map_size.x * random_split_percentage, current_map_size.y);
+		child_two_size = vec2(current_map_size.x - child_one_size.x, current_map_size.y);
+		new_pos.x = array_pos.x + child_one_size.x;
+	}
+	else {
+		child_one_size = vec2(current_map_size.x, current_map_size.y * random_split_percentage);
+		child_two_size = vec2(current_map_size.x, current_map_size.y - child_one_size.y);
+		new_pos.y = array_pos.y + child_one_size.y;
+	}
+
+	// The children are added to layout.nodes, which can move it, so only get at the node by index from here
+	int child_one = populateMapWithArray(layout, array_pos, child_one_size, max_room_tiles, max_split_percentage);
+	int child_two = populateMapWithArray(layout, new_pos, child_two_size, max_room_tiles, max_split_percentage);
+
+	MapNode& cur_node = layout.nodes[node_index];
+	cur_node.hasChildren = true;
+	cur_node.split_vertically = split_vertically;
+	cur_node.child_one = child_one;
+	cur_node.child_two = child_two;
+
+	return node_index;
+}
+
+// Shaw: Yes, it's really ugly, but please overlook
+void addWallsToArray(MapGrid& grid) {
+	for (int y = 0; y < grid.height; y++) {
+		for (int x = 0; x < grid.length; x++) {
+
+			// If this is blank space
+			if (grid.at(x, y) == 0) {
+
+				// Check if near a room
+				for (int a = -1; a <= 1; a++) {
+					if (x + a >= grid.length || x + a <= 0) {
+						continue;
+					}
+
+					for (int b = -1; b <= 1; b++) {
+						if (y + b >= grid.height || y + b <= 0) {
+							continue;
+						}
+
+						// Check if it is a room or a corridor
+						if (grid.at(x + a, y + b) >= 2) {
+							grid.at(x, y) = 1;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void resetMapLayout(MapLayout& layout, unsigned int seed) {
+	layout.rng.seed(seed);
+	layout.uniform_dist.reset();
+	layout.normal_dist.reset();
+
+	layout.grid.reset(MAP_LENGTH, MAP_HEIGHT);
+	layout.nodes.clear();
+	layout.room_nodes.clear();
+	layout.box_positions.clear();
+
+	layout.is_exit_generated = false;
+	layout.current_room = 3; // RESET ROOM
+	layout.num_enemy_rooms = 0;
+	layout.num_chest_rooms = 0;
+	layout.num_unique_rooms = 0;
+
+	layout.remaining_unique_rooms = {
+		ROOM_CONTENT::FOUNTAIN,
+		ROOM_CONTENT::SACRIFICE,
+		ROOM_CONTENT::CHOICE,
+		ROOM_CONTENT::MIMIC,
+	};
+}
+
+void generateMapLayout(MapLayout& layout, unsigned int seed) {
+	// The enemy rooms are made from the templates
+	assert(room_templates.isLoaded() && room_templates.numEnemyRooms() > 0);
+
+	resetMapLayout(layout, seed);
+
+	// Create rooms with random size
+	vec2 size = vec2(MAP_LENGTH, MAP_HEIGHT);
+	int root_node = populateMapWithArray(layout, vec2(0, 0), size, MAX_ROOM_TILES, MIN_SPLIT_PERCENTAGE);
+
+	// Then, fill rooms with content
+	// Randomize order that we fill rooms
+	std::shuffle(layout.room_nodes.begin(), layout.room_nodes.end(), layout.rng);
+
+	// Fill the map with essential rooms (player spawn room, floor exit, enemy rooms, chest rooms
+	for (int node_index : layout.room_nodes) {
+		fillRoomContent(layout, node_index);
+	}
+
+	// Fill any remaining empty rooms with "unique" rooms
+	for (int node_index : layout.room_nodes) {
+		if (!layout.nodes[node_index].isFilled) {
+			fillUniqueRoom(layout, node_index);
+			layout.num_unique_rooms++;
+		}
+	}
+
+	// Connect map nodes after generating map nodes
+	connectMapNodesRecursive(layout, root_node);
+
+	// Add walls to the array
+	addWallsToArray(layout.grid);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "common.hpp"
+#include "map_node.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/* MAP INFO
+* 0:		empty space
+* 1:		WALL
+* 2:		CORRIDOR
+* 3 - 127:	ROOM (each room is filled with a different number)
+* 128 - 255: CORRIDOR
+*
+ */
+
+// The tiles of a level, a byte each, in one block row after row
+struct MapGrid {
+	int length = 0;	// x
+	int height = 0;	// y
+	std::vector<uint8_t> tiles;
+
+	// Resize to length x height and empty every tile, keeps the memory when the size doesn't grow
+	void reset(int length, int height) {
+		this->length = length;
+		this->height = height;
+		tiles.assign((size_t)length * height, 0);
+	}
+
+	uint8_t& at(int x, int y) { return tiles[(size_t)y * length + x]; }
+	uint8_t at(int x, int y) const { return tiles[(size_t)y * length + x]; }
+};
+
+// A procedurally generated floor before anything of it is in the registry: the tiles, the BSP tree and what goes in
+// each room. It has its own random engine and no other state, so floors can be generated on any thread, and the same
+// seed always gives the same floor. createMap turns it into entities.
+struct MapLayout {
+	MapGrid grid;
+	std::vector<MapNode> nodes;	// the BSP tree, the root is the first one
+	std::vector<int> room_nodes;	// the very "bottom" nodes, which are the actual rooms themselves, in the order they were filled
+	std::vector<vec2> box_positions;	// destructable boxes of the enemy rooms, in tiles
+
+	int current_room = 3;
+	int num_enemy_rooms = 0;
+	int num_chest_rooms = 0;
+	int num_unique_rooms = 0;
+	bool is_exit_generated = false;
+	std::vector<ROOM_CONTENT> remaining_unique_rooms;
+
+	std::default_random_engine rng;
+	std::uniform_real_distribution<float> uniform_dist;	// number between 0..1
+	std::normal_distribution<float> normal_dist{ 0.5, 0.166 };
+
+	int numRooms() const { return current_room - 3; }	// -3 because current_room starts at 3
+};
+
+// Generate a whole floor from seed, reusing the memory layout already has
+void generateMapLayout(MapLayout& layout, unsigned int seed);
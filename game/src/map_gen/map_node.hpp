@@ -1,15 +1,33 @@
 #pragma once
 
+// What a room of a generated floor gets filled with
+enum class ROOM_CONTENT {
+	NONE = 0,
+	PLAYER_SPAWN = NONE + 1,
+	FLOOR_EXIT = PLAYER_SPAWN + 1,
+	ENEMY = FLOOR_EXIT + 1,
+	CHEST = ENEMY + 1,
+	// Unique rooms, at most one of each per floor
+	FOUNTAIN = CHEST + 1,		// Restores health to full
+	SACRIFICE = FOUNTAIN + 1,	// Sacrifice half your HP for 2 relics
+	CHOICE = SACRIFICE + 1,		// Choose one of 2 spells
+	MIMIC = CHOICE + 1,			// Mimic room
+};
+
+// Node of the BSP tree of a generated floor, they all live in MapLayout::nodes
 struct MapNode {
-	vec2 array_pos;
-	vec2 size;
-	bool hasChildren;
-	bool split_vertically;
-	int room_number;
-	MapNode* child_one;
-	MapNode* child_two;
+	vec2 array_pos = vec2(0);
+	vec2 size = vec2(0);
+	bool hasChildren = false;
+	bool split_vertically = false;
+	int room_number = -1;
+	int child_one = -1;	// index in MapLayout::nodes
+	int child_two = -1;
 
 	bool isFilled = false;
+	ROOM_CONTENT content = ROOM_CONTENT::NONE;
+	int room_template = -1;	// ENEMY: number of its data/enemy_rooms file
+	int boss_number = 0;	// FLOOR_EXIT: the boss the exit leads to
 
 	MapNode() {};
-};
\ No newline at end of file
+};
@@ -0,0 +1,98 @@
+#include "room_templates.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+RoomTemplates room_templates;
+
+bool RoomTemplates::parseFile(const std::string& full_file_path, MapGrid& grid)
+{
+	std::ifstream file(full_file_path, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	// Collect the tiles row after row first, the widest row is the length of the grid (shorter ones end in empty tiles)
+	std::vector<uint8_t> tiles;
+	std::vector<int> row_lengths;
+	int value = -1;
+	int row_length = 0;
+	for (size_t i = 0; i <= text.size(); i++) {
+		char c = i < text.size() ? text[i] : '\n';
+		if (c >= '0' && c <= '9') {
+			value = (value < 0 ? 0 : value * 10) + (c - '0');
+			continue;
+		}
+		if (value >= 0) {
+			tiles.push_back((uint8_t)value);
+			row_length++;
+			value = -1;
+		}
+		if (c == '\n' && row_length > 0) {
+			row_lengths.push_back(row_length);
+			row_length = 0;
+		}
+	}
+
+	int length = 0;
+	for (int row : row_lengths) {
+		length = std::max(length, row);
+	}
+
+	grid.reset(length, (int)row_lengths.size());
+	size_t next_tile = 0;
+	for (int y = 0; y < grid.height; y++) {
+		for (int x = 0; x < row_lengths[y]; x++) {
+			grid.at(x, y) = tiles[next_tile++];
+		}
+	}
+	return true;
+}
+
+bool RoomTemplates::load()
+{
+	templates.clear();
+	enemy_rooms.clear();
+	is_loaded = false;
+
+	const char* folders[] = { "enemy_rooms", "boss_rooms", "unique_rooms" };
+	std::string data_dir = get_base_path() + "data/";
+	for (const char* folder : folders) {
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(data_dir + folder, error)) {
+			if (!entry.is_regular_file() || entry.path().extension() != ".txt") {
+				continue;
+			}
+			std::string file_path = std::string(folder) + "/" + entry.path().filename().string();
+			if (!parseFile(entry.path().string(), templates[file_path])) {
+				std::cerr << "ERROR: Failed to read room template " << file_path << std::endl;
+				return false;
+			}
+		}
+		if (error) {
+			std::cerr << "ERROR: Failed to read the room templates in " << data_dir + folder << std::endl;
+			return false;
+		}
+	}
+
+	for (int number = 0; ; number++) {
+		const MapGrid* grid = find("enemy_rooms/room_" + std::to_string(number) + ".txt");
+		if (grid == nullptr) {
+			break;
+		}
+		enemy_rooms.push_back(grid);
+	}
+
+	is_loaded = true;
+	return true;
+}
+
+const MapGrid* RoomTemplates::find(const std::string& file_path) const
+{
+	auto it = templates.find(file_path);
+	return it != templates.end() ? &it->second : nullptr;
+}
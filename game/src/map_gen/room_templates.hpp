@@ -0,0 +1,36 @@
+#pragma once
+
+#include "map_layout.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Every room layout under data/enemy_rooms, data/boss_rooms and data/unique_rooms, parsed into a MapGrid once at
+// startup instead of every time a room is generated. Nothing changes once it is loaded, so floors can be generated
+// from any thread.
+class RoomTemplates
+{
+public:
+	// Parse every .txt of the room folders, returns false if a folder can't be read
+	bool load();
+	bool isLoaded() const { return is_loaded; }
+
+	// file_path is relative to data/, eg. "unique_rooms/hub_room.txt". nullptr if there is no such file
+	const MapGrid* find(const std::string& file_path) const;
+
+	// data/enemy_rooms/room_<number>.txt, numbered from 0 without gaps
+	const MapGrid& getEnemyRoom(int number) const { return *enemy_rooms[number]; }
+	int numEnemyRooms() const { return (int)enemy_rooms.size(); }
+
+	// Read one of the text files, one line per row of tiles separated by spaces
+	static bool parseFile(const std::string& full_file_path, MapGrid& grid);
+
+private:
+	std::unordered_map<std::string, MapGrid> templates;	// by path relative to data/, elements never move
+	std::vector<const MapGrid*> enemy_rooms;
+	bool is_loaded = false;
+};
+
+// Defined in room_templates.cpp, loaded by main before anything is generated
+extern RoomTemplates room_templates;
@@ -5,6 +5,38 @@
 #include "tinyECS/registry.hpp"
 #include <iostream>
 
+SystemAccess MinimapSystem::getAccess() const {
+	SystemAccess access;
+	access.reads = { &registry.players, &registry.transforms, &registry.walls };
+	access.writes = { &registry.minimaps };
+	return access;
+}
+
+// Mark which tiles are walls, and size the map to fit them. Only runs when the level changes
+static void buildWallTiles(Minimap& minimap) {
+	int map_size = 0;
+	for (Entity wall_entity : registry.walls.entities) {
+		Transformation& wall_transform = registry.transforms.get(wall_entity);
+		ivec2 tile = ivec2(wall_transform.position / (float)TILE_SIZE);
+		map_size = max(map_size, max(tile.x, tile.y) + 1);
+	}
+
+	minimap.clear();
+	minimap.num_walls = (int)registry.walls.size();
+	minimap.map_size = map_size;
+	minimap.is_wall.assign((size_t)map_size * map_size, 0);
+	minimap.revealed.assign((size_t)map_size * map_size, 0);
+	minimap.is_resized = true;
+
+	for (Entity wall_entity : registry.walls.entities) {
+		Transformation& wall_transform = registry.transforms.get(wall_entity);
+		ivec2 tile = ivec2(wall_transform.position / (float)TILE_SIZE);
+		if (tile.x >= 0 && tile.y >= 0) {
+			minimap.is_wall[tile.y * map_size + tile.x] = 1;
+		}
+	}
+}
+
 void MinimapSystem::step(float elapsed_ms) {
 	Entity minimap_entity = registry.minimaps.entities[0];
 	Minimap& minimap = registry.minimaps.get(minimap_entity);
@@ -12,25 +44,33 @@ void MinimapSystem::step(float elapsed_ms) {
 	Entity player_entity = registry.players.entities[0];
 	Transformation player_transform = registry.transforms.get(player_entity);
 
-	for (Entity wall_entity : registry.walls.entities) {
-		Transformation wall_transform = registry.transforms.get(wall_entity);
-
-		float dist_to_wall = distance(wall_transform.position, player_transform.position);
+	if (minimap.num_walls != (int)registry.walls.size()) {
+		buildWallTiles(minimap);
+	}
 
-		// If the wall is within range of the player
-		if (dist_to_wall < minimap.reveal_range) {
-			// And the wall isn't already revealed
-			if (find(minimap.walls_revealed.begin(), minimap.walls_revealed.end(), (int)wall_entity) == minimap.walls_revealed.end()) {
-				// Add it to revealed walls
-				minimap.walls_revealed.push_back(wall_entity);
+	// Whatever was in range of this tile has already been revealed
+	ivec2 player_tile = ivec2(floor(player_transform.position / (float)TILE_SIZE));
+	if (player_tile == minimap.player_tile) {
+		return;
+	}
+	minimap.player_tile = player_tile;
 
-				vec2 tile_pos = vec2(
-					(int)(wall_transform.position.x / TILE_SIZE),
-					(int)(wall_transform.position.y / TILE_SIZE)
-				);
+	// Only the tiles that can be in range, walls sit on the corner of their tile like before
+	int range_tiles = (int)ceil(minimap.reveal_range / TILE_SIZE) + 1;
+	ivec2 lo = max(player_tile - range_tiles, ivec2(0));
+	ivec2 hi = min(player_tile + range_tiles, ivec2(minimap.map_size - 1));
+	for (int y = lo.y; y <= hi.y; y++) {
+		for (int x = lo.x; x <= hi.x; x++) {
+			int tile_index = y * minimap.map_size + x;
+			if (!minimap.is_wall[tile_index] || minimap.revealed[tile_index]) {
+				continue;
+			}
 
-				minimap.wall_positions.push_back(tile_pos);
-				//std::cout << minimap.walls_revealed.size() << std::endl;
+			float dist_to_wall = distance(vec2(x, y) * (float)TILE_SIZE, player_transform.position);
+			if (dist_to_wall < minimap.reveal_range) {
+				minimap.revealed[tile_index] = 255;
+				minimap.dirty_min = min(minimap.dirty_min, ivec2(x, y));
+				minimap.dirty_max = max(minimap.dirty_max, ivec2(x, y));
 			}
 		}
 	}
@@ -3,6 +3,7 @@
 #include "tinyECS/tiny_ecs.hpp"
 #include "tinyECS/components.hpp"
 #include "tinyECS/registry.hpp"
+#include "system_scheduler.hpp"
 
 
 class MinimapSystem
@@ -10,6 +11,8 @@ class MinimapSystem
 public:
 	void step(float elapsed_ms);
 
+	SystemAccess getAccess() const;
+
 	MinimapSystem()
 	{
 	}
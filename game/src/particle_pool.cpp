@@ -0,0 +1,100 @@
+#include "particle_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+	// log2 of the smallest power of two block that fits num_particles
+	int blockSizeClass(int num_particles) {
+		int size_class = 0;
+		while ((ParticlePool::MIN_BLOCK_SIZE << size_class) < num_particles) {
+			size_class++;
+		}
+		return size_class;
+	}
+}
+
+ParticlePool::ParticlePool()
+{
+	grow(INITIAL_CAPACITY);
+	free_blocks.resize(blockSizeClass(MAX_BLOCK_SIZE) + 1);
+}
+
+int ParticlePool::allocate(int num_particles, int& out_size)
+{
+	assert(num_particles <= MAX_BLOCK_SIZE && "Too many particles for one emitter");
+	int size_class = blockSizeClass(std::max(1, num_particles));
+	int size = MIN_BLOCK_SIZE << size_class;
+	out_size = size;
+	num_slots_in_use += size;
+
+	std::vector<int>& free_list = free_blocks[size_class];
+	if (!free_list.empty()) {
+		int offset = free_list.back();
+		free_list.pop_back();
+		return offset;
+	}
+
+	if (top + size > capacity) {
+		grow(top + size);
+	}
+	int offset = top;
+	top += size;
+	return offset;
+}
+
+void ParticlePool::release(int offset, int size)
+{
+	num_slots_in_use -= size;
+	free_blocks[blockSizeClass(size)].push_back(offset);
+}
+
+void ParticlePool::copyParticle(int from, int to)
+{
+	for (int f = 0; f < FIELD_COUNT; f++) {
+		data[fieldStart(f, capacity) + to] = data[fieldStart(f, capacity) + from];
+	}
+}
+
+void ParticlePool::grow(int min_capacity)
+{
+	int new_capacity = std::max(capacity, INITIAL_CAPACITY);
+	while (new_capacity < min_capacity) {
+		new_capacity *= 2;
+	}
+
+	std::vector<float> new_data(fieldStart(FIELD_COUNT, new_capacity));
+	for (int f = 0; f < FIELD_COUNT; f++) {
+		std::copy(data.begin() + fieldStart(f, capacity), data.begin() + fieldStart(f, capacity) + top, new_data.begin() + fieldStart(f, new_capacity));
+	}
+	data.swap(new_data);
+	capacity = new_capacity;
+}
+
+void ParticleRange::reserve(int num_particles)
+{
+	if (isAllocated() && num_particles <= size) {
+		return;
+	}
+
+	int new_size = 0;
+	int new_offset = particle_pool.allocate(num_particles, new_size);
+	for (int i = 0; i < num_alive; i++) {
+		particle_pool.copyParticle(offset + i, new_offset + i);
+	}
+	if (isAllocated()) {
+		particle_pool.release(offset, size);
+	}
+	offset = new_offset;
+	size = (uint16_t)new_size;
+}
+
+void ParticleRange::release()
+{
+	if (isAllocated()) {
+		particle_pool.release(offset, size);
+	}
+	offset = -1;
+	size = 0;
+	num_alive = 0;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Particles of every emitter live in one preallocated pool, stored as one array per field (structure of arrays) so
+// updating them is a plain loop over floats. Every emitter gets a block of slots in it, its alive particles are kept
+// packed at the front of the block, so spawning one is an append and the renderer can use the alive count as is.
+// Blocks come in power of two sizes with a free list per size, so handing one out or back doesn't allocate.
+class ParticlePool
+{
+public:
+	enum FIELD {
+		POSITION_X, POSITION_Y,
+		VELOCITY_X, VELOCITY_Y,
+		SCALE_X, SCALE_Y,
+		COLOR_R, COLOR_G, COLOR_B, COLOR_A,
+		LIFETIME,
+		FIELD_COUNT
+	};
+
+	static const int INITIAL_CAPACITY = 1 << 14;
+	static const int MIN_BLOCK_SIZE = 4;
+	static const int MAX_BLOCK_SIZE = 1 << 15;
+
+	ParticlePool();
+
+	// Field f of every slot, index it with block offset + particle
+	float* field(FIELD f) { return data.data() + fieldStart(f, capacity); }
+	const float* field(FIELD f) const { return data.data() + fieldStart(f, capacity); }
+
+	// First slot of a block with room for at least num_particles (its size is written to out_size).
+	// The pool only ever grows, which moves the arrays, so don't hold on to field() pointers across an allocate
+	int allocate(int num_particles, int& out_size);
+	void release(int offset, int size);
+
+	// Copy particle from into slot to, in every field
+	void copyParticle(int from, int to);
+
+	int getCapacity() const { return capacity; }
+	int getNumSlotsInUse() const { return num_slots_in_use; }
+
+private:
+	// Capacity is a power of two, so without a gap every field would start on the same cache set and the fields of one
+	// particle would keep evicting each other. A cache line between the fields puts them on different sets
+	static const int FIELD_PADDING = 16;
+
+	static size_t fieldStart(int f, int capacity) { return (size_t)f * (capacity + FIELD_PADDING); }
+
+	std::vector<float> data;	// FIELD_COUNT arrays of capacity floats, one after the other
+	int capacity = 0;
+	int top = 0;	// slots below this have been handed out as a block at some point
+	int num_slots_in_use = 0;
+
+	std::vector<std::vector<int>> free_blocks;	// offsets of released blocks, by log2 of their size
+
+	void grow(int min_capacity);
+};
+
+// Defined in registry.cpp, the emitters still in the registry give their blocks back when it is destroyed
+extern ParticlePool particle_pool;
+
+// The block of pool slots an emitter owns. Moving it hands the block over, destroying it gives the block back.
+// It only takes a few bytes, so emitters stay small however many particles they have.
+struct ParticleRange {
+	int offset = -1;	// first slot, -1 until a block is allocated
+	uint16_t size = 0;
+	uint16_t num_alive = 0;
+
+	ParticleRange() {}
+	ParticleRange(const ParticleRange&) = delete;
+	ParticleRange& operator=(const ParticleRange&) = delete;
+	ParticleRange(ParticleRange&& other) { take(other); }
+	ParticleRange& operator=(ParticleRange&& other) {
+		if (this != &other) {
+			release();
+			take(other);
+		}
+		return *this;
+	}
+	~ParticleRange() { release(); }
+
+	bool isAllocated() const { return offset >= 0; }
+
+	// Get a block with room for num_particles, the alive particles are moved over if there already was one
+	void reserve(int num_particles);
+	void release();
+
+	// Slot of a new alive particle (its fields still need to be set), -1 if the block is full
+	int spawn() {
+		return num_alive < size ? offset + num_alive++ : -1;
+	}
+
+	// Kill the i-th alive particle, the last alive one takes its slot
+	void kill(int i) {
+		num_alive--;
+		if (i != num_alive) {
+			particle_pool.copyParticle(offset + num_alive, offset + i);
+		}
+	}
+
+private:
+	void take(ParticleRange& other) {
+		offset = other.offset;
+		size = other.size;
+		num_alive = other.num_alive;
+		other.offset = -1;
+		other.size = 0;
+		other.num_alive = 0;
+	}
+};
@@ -4,85 +4,141 @@
 #include "tinyECS/tiny_ecs.hpp"
 #include "tinyECS/components.hpp"
 #include "tinyECS/registry.hpp"
+#include "job_system.hpp"
 
 
+const int PARTICLE_JOB_SIZE = 16; // emitter containers per job
+
+namespace {
+	// Move and fade count particles. Nothing but float math over arrays that don't overlap, so the compiler vectorizes it
+	void integrateParticles(float* __restrict position_x, float* __restrict position_y,
+		const float* __restrict velocity_x, const float* __restrict velocity_y,
+		float* __restrict alpha, float* __restrict lifetime, int count, float stepSeconds, float fade)
+	{
+		for (int i = 0; i < count; i++) {
+			lifetime[i] -= stepSeconds;
+
+			position_x[i] += velocity_x[i] * stepSeconds; // update particle position
+			position_y[i] += velocity_y[i] * stepSeconds;
+			alpha[i] -= (fade / lifetime[i]) * stepSeconds; // fade particle out
+		}
+	}
+}
+
+SystemAccess ParticleSystem::getAccess() const {
+	SystemAccess access;
+	access.reads = { &registry.transforms };
+	access.writes = { &registry.particle_emitter_containers, &rng };
+	return access;
+}
+
 void ParticleSystem::step(float elapsed_ms) {
-	for (ParticleEmitterContainer& particle_emitter_container : registry.particle_emitter_containers.components) {
-		for (auto& pair : particle_emitter_container.particle_emitter_map) {
-			ParticleEmitter& particle_emitter = pair.second;
-			updateParticles(particle_emitter, elapsed_ms);
+	auto& containers = registry.particle_emitter_containers;
+
+	// Respawning draws from the global rng, so it stays on this thread in emitter order to keep the sequence the same.
+	// It is also the only place that takes blocks from the particle pool, which isn't thread safe
+	for (size_t i = 0; i < containers.components.size(); i++) {
+		for (ParticleEmitter& particle_emitter : containers.components[i].emitters) {
+			if (particle_emitter.descriptor != nullptr) {
+				respawnParticles(containers.entities[i], particle_emitter, elapsed_ms);
+			}
 		}
 	}
+
+	// Moving the particles only touches the emitter's own block of the pool
+	job_system.parallel_for((int)containers.components.size(), PARTICLE_JOB_SIZE, [&](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			for (ParticleEmitter& particle_emitter : containers.components[i].emitters) {
+				if (particle_emitter.descriptor != nullptr) {
+					updateParticles(particle_emitter, elapsed_ms);
+				}
+			}
+		}
+	});
 }
 
-void ParticleSystem::updateParticles(ParticleEmitter& particle_emitter, float elapsed_ms) {
+void ParticleSystem::respawnParticles(Entity parent, ParticleEmitter& particle_emitter, float elapsed_ms) {
 
 	int numNewParticles = 1; // MunnL Create 1 particle per frame (we usually won't make more (?)) 
 
 	float stepSeconds = elapsed_ms / 1000.0f;
 
+	const ParticleEmitterDescriptor& descriptor = *particle_emitter.descriptor;
 	particle_emitter.current_respawn_time += stepSeconds;
 
 	for (int i = 0; i < numNewParticles; i++) {
-		int unusedParticle = getFirstUnusedParticle(particle_emitter); // This is actually inefficient, see https://learnopengl.com/In-Practice/2D-Game/Particles for better way to iterate
-		if (unusedParticle < 0) { // All particles are being used
+		if (particle_emitter.particles.num_alive >= descriptor.max_particles) { // All particles are being used
 			break;
 		}
-		if (particle_emitter.current_respawn_time > particle_emitter.loop_duration / particle_emitter.max_particles) {
+		if (particle_emitter.current_respawn_time > particle_emitter.loop_duration / descriptor.max_particles) {
 
 			// Don't respawn particles if not emitting, but still continue to update other particles
 			if (particle_emitter.is_emitting) {
-				respawnParticle(particle_emitter, particle_emitter.particles[unusedParticle]);
+				if (!particle_emitter.particles.isAllocated()) {
+					particle_emitter.particles.reserve(descriptor.max_particles);
+				}
+				respawnParticle(parent, particle_emitter, particle_emitter.particles.spawn());
 				particle_emitter.current_respawn_time = 0;
 			}
 		}
 	}
+}
 
+void ParticleSystem::updateParticles(ParticleEmitter& particle_emitter, float elapsed_ms) {
 
-	for (int i = 0; i < particle_emitter.max_particles; i++) {
-		Particle& particle = particle_emitter.particles[i];
-
-		if (particle.lifetime <= 0) { // ignore particles that have "died"
-			//std::cout << "Particle " << i << " is dead!" << std::endl;
-			continue;
-		}
+	float stepSeconds = elapsed_ms / 1000.0f;
 
-		particle.lifetime -= stepSeconds;
+	ParticleRange& particles = particle_emitter.particles;
+	if (particles.num_alive == 0) {
+		return;
+	}
 
-		particle.position += particle.velocity * stepSeconds; // update particle position
-		particle.color.w -= (particle_emitter.color_i.w / particle.lifetime) * stepSeconds; // fade particle out
+	int offset = particles.offset;
+	integrateParticles(particle_pool.field(ParticlePool::POSITION_X) + offset, particle_pool.field(ParticlePool::POSITION_Y) + offset,
+		particle_pool.field(ParticlePool::VELOCITY_X) + offset, particle_pool.field(ParticlePool::VELOCITY_Y) + offset,
+		particle_pool.field(ParticlePool::COLOR_A) + offset, particle_pool.field(ParticlePool::LIFETIME) + offset,
+		particles.num_alive, stepSeconds, particle_emitter.descriptor->color_i.w);
+
+	// Drop the particles that just died, keeping the alive ones packed at the front of the block
+	const float* lifetime = particle_pool.field(ParticlePool::LIFETIME) + offset;
+	for (int i = 0; i < particles.num_alive;) {
+		if (lifetime[i] <= 0) {
+			particles.kill(i);
+		}
+		else {
+			i++;
+		}
 	}
 }
 
 
-void ParticleSystem::respawnParticle(ParticleEmitter& particle_emitter, Particle& particle) {
-	vec2 random_position = vec2((uniform_dist(rng) - 0.5) * (particle_emitter.random_position_max.x - particle_emitter.random_position_min.x),
-		(uniform_dist(rng) - 0.5) * (particle_emitter.random_position_max.y - particle_emitter.random_position_min.y));
-	vec2 random_velocity = vec2((uniform_dist(rng) - 0.5) * (particle_emitter.random_velocity_max.x - particle_emitter.random_velocity_min.x),
-		(uniform_dist(rng) - 0.5) * (particle_emitter.random_velocity_max.y - particle_emitter.random_velocity_max.y));
+void ParticleSystem::respawnParticle(Entity parent, ParticleEmitter& particle_emitter, int slot) {
+	const ParticleEmitterDescriptor& descriptor = *particle_emitter.descriptor;
+
+	vec2 random_position = vec2((uniform_dist(rng) - 0.5) * (descriptor.random_position_max.x - descriptor.random_position_min.x),
+		(uniform_dist(rng) - 0.5) * (descriptor.random_position_max.y - descriptor.random_position_min.y));
+	vec2 random_velocity = vec2((uniform_dist(rng) - 0.5) * (descriptor.random_velocity_max.x - descriptor.random_velocity_min.x),
+		(uniform_dist(rng) - 0.5) * (descriptor.random_velocity_max.y - descriptor.random_velocity_max.y));
 
 	vec2 parent_position = vec2(0, 0);
 	vec2 parent_scale = vec2(1, 1);
-	if (particle_emitter.parent_entity != -1) {
-		Transformation parent_transform = registry.transforms.get(particle_emitter.parent_entity);
-
-		parent_position = parent_transform.position;
-		parent_scale = parent_transform.scale;
+	if (Transformation* parent_transform = registry.transforms.try_get(parent)) {
+		parent_position = parent_transform->position;
+		parent_scale = parent_transform->scale;
 	}
 
-	particle.position = parent_position + particle_emitter.position_i + random_position;
-	particle.velocity = particle_emitter.velocity_i + random_velocity;
-	particle.scale = vec2(parent_scale.x * particle_emitter.scale_i.x, parent_scale.y * particle_emitter.scale_i.y);
-	particle.color = particle_emitter.color_i;
-	particle.lifetime = particle_emitter.loop_duration;
+	vec2 position = parent_position + descriptor.position_i + random_position;
+	vec2 velocity = descriptor.velocity_i + random_velocity;
+
+	particle_pool.field(ParticlePool::POSITION_X)[slot] = position.x;
+	particle_pool.field(ParticlePool::POSITION_Y)[slot] = position.y;
+	particle_pool.field(ParticlePool::VELOCITY_X)[slot] = velocity.x;
+	particle_pool.field(ParticlePool::VELOCITY_Y)[slot] = velocity.y;
+	particle_pool.field(ParticlePool::SCALE_X)[slot] = parent_scale.x * descriptor.scale_i.x;
+	particle_pool.field(ParticlePool::SCALE_Y)[slot] = parent_scale.y * descriptor.scale_i.y;
+	particle_pool.field(ParticlePool::COLOR_R)[slot] = descriptor.color_i.r;
+	particle_pool.field(ParticlePool::COLOR_G)[slot] = descriptor.color_i.g;
+	particle_pool.field(ParticlePool::COLOR_B)[slot] = descriptor.color_i.b;
+	particle_pool.field(ParticlePool::COLOR_A)[slot] = descriptor.color_i.a;
+	particle_pool.field(ParticlePool::LIFETIME)[slot] = particle_emitter.loop_duration;
 }
-
-int ParticleSystem::getFirstUnusedParticle(ParticleEmitter& particle_emitter) {
-	for (int i = 0; i < particle_emitter.max_particles; i++) {
-		if (particle_emitter.particles[i].lifetime <= 0) {
-			return i;
-		}
-	}
-
-	return -1;
-}
\ No newline at end of file
@@ -4,18 +4,20 @@
 #include "tinyECS/tiny_ecs.hpp"
 #include "tinyECS/components.hpp"
 #include "tinyECS/registry.hpp"
+#include "system_scheduler.hpp"
 
 class ParticleSystem {
 public:
 	void step(float elapsed_ms);
 
+	SystemAccess getAccess() const;
+
 	ParticleSystem() {}
 
 private: 
 
+	void respawnParticles(Entity parent, ParticleEmitter& particle_emitter, float elapsed_ms);
 	void updateParticles(ParticleEmitter& particle_emitter, float elapsed_ms);
 
-	void respawnParticle(ParticleEmitter& particle_emitter, Particle& particle);
-
-	int getFirstUnusedParticle(ParticleEmitter& particle_emitter);
+	void respawnParticle(Entity parent, ParticleEmitter& particle_emitter, int slot);
 };
\ No newline at end of file
@@ -2,9 +2,13 @@
 #include "physics_system.hpp"
 #include "world_init.hpp"
 #include "render_system.hpp"
+#include "job_system.hpp"
 #include <iostream>
 #include <cmath>
 
+const int MOTION_JOB_SIZE = 1024; // entities per job
+const int NARROW_PHASE_JOB_SIZE = 512; // candidate pairs per job
+
 
 std::vector<vec2> getWorldPoints(Entity e)
 {
@@ -172,82 +176,124 @@ void PhysicsSystem::step(float elapsed_ms)
 	// Move each entity that has motion (invaders, projectiles, and even towers [they have 0 for velocity])
 	// based on how much time has passed, this is to (partially) avoid
 	// having entities move at different speed based on the machine.
-	auto& motion_registry = registry.motions;
-	for(uint i = 0; i< motion_registry.size(); i++)
+	// Every entity only moves itself, so this is split over the job threads. The player moves too,
+	// so everyone is checked against where the player was at the start of the step
+	float step_seconds = elapsed_ms / 1000.f;
+	vec2 player_position = player_transform.position;
+	auto motion_view = registry.view<Motion, Transformation>();
+	job_system.parallel_for((int)motion_view.size(), MOTION_JOB_SIZE, [&](int begin, int end) {
+		motion_view.each_in_range(begin, end, [&](Entity entity, Motion& motion, Transformation& transformation)
+		{
+			// update position based on step_seconds and motion.velocity
+			if (glm::distance(player_position, transformation.position) > COLLISION_CHECK_DISTANCE) {
+				return;
+			}
+
+			transformation.position += motion.velocity * step_seconds;
+		});
+	});
+
+	// Broadphase: bucket every nearby hitbox into a uniform grid, so we only run the narrow phase
+	// on boxes that share a cell instead of on every pair of hitboxes
+	broadphase.clear();
+	auto& hitbox_registry = registry.hitboxes;
+	for (uint i = 0; i < hitbox_registry.size(); i++)
 	{
-		// update motion.position based on step_seconds and motion.velocity
-		Motion& motion = motion_registry.components[i];
-		Entity entity = motion_registry.entities[i];
-		float step_seconds = elapsed_ms / 1000.f;
-		
-		// Guo: get position associated with the entity that is in motion
-		auto& position = registry.transforms.get(entity).position;
+		Entity entity = hitbox_registry.entities[i];
 
-		if (glm::distance(player_transform.position, position) > COLLISION_CHECK_DISTANCE) {
+		// Level walls live in the static grid instead
+		if (is_static_geometry_baked && registry.staticColliders.has(entity)) {
 			continue;
 		}
 
-		position += motion.velocity * step_seconds;
-	}
+		Hitbox& hitbox = hitbox_registry.components[i];
+		Transformation& transformation = registry.transforms.get(entity);
 
-	int num_collisions_checked = 0;
-	
-	// check for collisions between all moving entities
-	// then check whether their collision matters or not
-    //ComponentContainer<Hitbox> &hitbox_container = registry.hitboxes;
-	for(Entity entity_i : registry.hitboxes.entities)
-	{  
-		if (!registry.hitboxes.has(entity_i))
+		if (glm::distance(transformation.position, player_transform.position) > COLLISION_CHECK_DISTANCE) {
 			continue;
+		}
 
-		Transformation& transformation_i = registry.transforms.get(entity_i);
-
-		if (glm::distance(transformation_i.position, player_transform.position) > COLLISION_CHECK_DISTANCE) {
-			continue;
+		// Same box as collideAABB, but without rounding the hitbox scale down, so it can only be bigger
+		vec2 half_extent = get_bounding_box(transformation, abs(hitbox.hitbox_scale)) / 2.f;
+		broadphase.insert(entity, transformation.position - half_extent, transformation.position + half_extent, hitbox.layer, hitbox.mask);
+	}
+	broadphase.build();
+	broadphase.findPairs(candidate_pairs);
+
+	num_hitboxes_checked = (int)broadphase.numProxies();
+	num_candidate_pairs = (int)candidate_pairs.size();
+	num_collisions_found = 0;
+
+	// Narrow phase, every pair is only reported once so no need to look for duplicates.
+	// The tests only read, so they run in parallel, the collisions are then added in pair order
+	candidate_hits.assign(candidate_pairs.size(), 0);
+	job_system.parallel_for((int)candidate_pairs.size(), NARROW_PHASE_JOB_SIZE, [&](int begin, int end) {
+		for (int k = begin; k < end; k++) {
+			candidate_hits[k] = collides(broadphase.getProxy(candidate_pairs[k].first).entity, broadphase.getProxy(candidate_pairs[k].second).entity);
 		}
-		
-		// note starting j at i+1 to compare all (i,j) pairs only once (and to not compare with itself)
-		for(Entity entity_j : registry.hitboxes.entities)
-		{ 
-			if (entity_i == entity_j)
-				continue;
+	});
 
-			Transformation& transformation_j = registry.transforms.get(entity_j);
+	collision_events.clear();
+	for (size_t k = 0; k < candidate_pairs.size(); k++)
+	{
+		if (candidate_hits[k])
+		{
+			const BroadphaseProxy& proxy_i = broadphase.getProxy(candidate_pairs[k].first);
+			const BroadphaseProxy& proxy_j = broadphase.getProxy(candidate_pairs[k].second);
+			if (collision_events.push(proxy_i.entity, proxy_i.layer, proxy_j.entity, proxy_j.layer)) {
+				num_collisions_found++;
+			}
+		}
+	}
 
-			if (glm::distance(transformation_j.position, player_transform.position) > COLLISION_CHECK_DISTANCE) {
+	// Moving bodies against the level walls, the walls never need to be checked against each other
+	num_static_pairs = 0;
+	for (int i = 0; i < (int)broadphase.numProxies(); i++)
+	{
+		const BroadphaseProxy& proxy = broadphase.getProxy(i);
+		static_broadphase.query(proxy.min, proxy.max, static_candidates);
+		for (int s : static_candidates)
+		{
+			const BroadphaseProxy& wall_proxy = static_broadphase.getProxy(s);
+			bool i_j_detect = (proxy.layer & wall_proxy.mask) != 0;
+			bool j_i_detect = (wall_proxy.layer & proxy.mask) != 0;
+			if (!i_j_detect && !j_i_detect) {
 				continue;
 			}
 
-			num_collisions_checked++;
-
-			Hitbox& hitbox_i = registry.hitboxes.get(entity_i);
-			Hitbox& hitbox_j = registry.hitboxes.get(entity_j);
-			bool i_j_detect = (hitbox_i.layer & hitbox_j.mask) != 0;
-			bool j_i_detect = (hitbox_j.layer & hitbox_i.mask) != 0;
+			num_static_pairs++;
 
-			if (i_j_detect || j_i_detect)
+			if (collides(proxy.entity, wall_proxy.entity) &&
+				collision_events.push(proxy.entity, proxy.layer, wall_proxy.entity, wall_proxy.layer))
 			{
-				if (collides(entity_i, entity_j))
-				{ 
-					// Remove duplicates
-					if (registry.collisions.has(entity_j)) {
-						Collision collision = registry.collisions.get(entity_j);
-
-						if (collision.other == entity_i) {
-							continue;
-						}
-					}
-					// Create a collisions event
-					// We are abusing the ECS system a bit in that we potentially insert multiple collisions for the same entity
-					// CK: why the duplication, except to allow searching by entity_id
-					registry.collisions.emplace_with_duplicates(entity_i, entity_j);
-					// registry.collisions.emplace_with_duplicates(entity_j, entity_i);
-				}
+				num_collisions_found++;
 			}
 		}
 	}
+}
+
+void PhysicsSystem::rebuildStaticGeometry()
+{
+	static_broadphase.clear();
+	if (!is_static_geometry_baked) {
+		static_broadphase.build();
+		return;
+	}
+
+	for (Entity entity : registry.staticColliders.entities)
+	{
+		if (!registry.hitboxes.has(entity) || !registry.transforms.has(entity)) {
+			continue;
+		}
+
+		Hitbox& hitbox = registry.hitboxes.get(entity);
+		Transformation& transformation = registry.transforms.get(entity);
+
+		vec2 half_extent = get_bounding_box(transformation, abs(hitbox.hitbox_scale)) / 2.f;
+		static_broadphase.insert(entity, transformation.position - half_extent, transformation.position + half_extent, hitbox.layer, hitbox.mask);
+	}
 
-	// std::cout << num_collisions_checked << std::endl;
+	static_broadphase.build();
 }
 
 
@@ -5,10 +5,13 @@
 #include "tinyECS/components.hpp"
 #include "tinyECS/registry.hpp"
 #include "render_system.hpp"
+#include "broadphase.hpp"
+#include "collision_events.hpp"
 
 struct Transformation;
 bool collides(Entity entity_i, Entity entity_j);
 bool collideAABB(Entity entity_i, Entity entity_j);
+vec2 get_bounding_box(const Transformation& transform, vec2 texture_dimension);
 std::vector<vec2> getWorldPoints(Entity e);
 bool polygonsCollide(const std::vector<vec2>& polyA, const std::vector<vec2>& polyB);
 void getAxes(const std::vector<vec2>& poly, std::vector<vec2>& axesOut);
@@ -26,7 +29,32 @@ public:
 
 	void step(float elapsed_ms);
 
+	// Bake every StaticCollider into the static grid, call once the level geometry has been created
+	void rebuildStaticGeometry();
+
 	PhysicsSystem()
 	{
 	}
+
+	// Off puts the level walls back into the per-step broadphase with everything else, the way it was before the static
+	// grid. Only there to check that both give the same collisions (headless runner --no-static-grid)
+	bool is_static_geometry_baked = true;
+
+	// Everything that collided during the last step, handled by WorldSystem::handle_collisions
+	CollisionEventQueue collision_events;
+
+	// Stats from the last step, handy for checking how much work the broadphase saves
+	int num_hitboxes_checked = 0;
+	int num_candidate_pairs = 0;
+	int num_static_pairs = 0;
+	int num_collisions_found = 0;
+
+private:
+	BroadphaseGrid broadphase;
+	std::vector<std::pair<int, int>> candidate_pairs;
+	std::vector<char> candidate_hits;	// narrow phase result of every candidate pair, filled in parallel
+
+	// Level walls, built once per level and only queried by the bodies in the dynamic broadphase
+	BroadphaseGrid static_broadphase;
+	std::vector<int> static_candidates;
 };
\ No newline at end of file
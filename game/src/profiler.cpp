@@ -0,0 +1,157 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+Profiler profiler;
+
+Profiler::Profiler()
+	: start_time(std::chrono::steady_clock::now()),
+	slots(new ProfileSlot[MAX_SAMPLES]),
+	frame_ms(MAX_FRAMES, 0.f),
+	frame_end_ns(MAX_FRAMES, 0)
+{
+}
+
+int64_t Profiler::now() const
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+void Profiler::record(const char* name, int64_t start_ns, int64_t duration_ns)
+{
+	// Small ids for the trace, in the order threads first record something
+	static std::atomic<int> num_threads{ 0 };
+	thread_local int thread = num_threads++;
+
+	uint64_t index = next_sample.fetch_add(1, std::memory_order_relaxed);
+	ProfileSlot& slot = slots[index & (MAX_SAMPLES - 1)];
+	slot.sequence.store(0, std::memory_order_relaxed);
+	// Keep the sample writes below the store above, pairs with the acquire fence in collectSamples
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.sample = { name, start_ns, duration_ns, thread };
+	slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::collectSamples(int64_t since_ns, std::vector<ProfileSample>& out_samples)
+{
+	out_samples.clear();
+
+	uint64_t end = next_sample.load(std::memory_order_acquire);
+	uint64_t begin = end > MAX_SAMPLES ? end - MAX_SAMPLES : 0;
+	for (uint64_t i = begin; i < end; i++) {
+		ProfileSlot& slot = slots[i & (MAX_SAMPLES - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != i + 1) {
+			continue;
+		}
+		ProfileSample sample = slot.sample;
+		// A writer that wrapped around may have overwritten the slot while we copied it
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != i + 1) {
+			continue;
+		}
+
+		if (sample.start_ns + sample.duration_ns >= since_ns) {
+			out_samples.push_back(sample);
+		}
+	}
+}
+
+void Profiler::endFrame(float frame_time_ms)
+{
+	int i = num_frames % MAX_FRAMES;
+	frame_ms[i] = frame_time_ms;
+	frame_end_ns[i] = now();
+	num_frames++;
+}
+
+std::string Profiler::dumpChromeTrace(float seconds)
+{
+	std::vector<ProfileSample> dump;
+	collectSamples(now() - (int64_t)(seconds * 1e9), dump);
+	std::sort(dump.begin(), dump.end(), [](const ProfileSample& a, const ProfileSample& b) { return a.start_ns < b.start_ns; });
+
+	std::string path = "trace_" + std::to_string((long long)std::time(nullptr)) + ".json";
+	std::ofstream file(path);
+	if (!file) {
+		return "";
+	}
+
+	// Complete events ("ph":"X"), timestamps and durations are in microseconds
+	file << std::fixed << std::setprecision(3);
+	file << "{\"traceEvents\":[\n";
+	for (size_t i = 0; i < dump.size(); i++) {
+		const ProfileSample& sample = dump[i];
+		file << (i == 0 ? "" : ",\n")
+			<< "{\"name\":\"" << sample.name << "\",\"cat\":\"game\",\"ph\":\"X\",\"pid\":1,\"tid\":" << sample.thread
+			<< ",\"ts\":" << sample.start_ns / 1000.0 << ",\"dur\":" << sample.duration_ns / 1000.0 << "}";
+	}
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	return file ? path : "";
+}
+
+const std::vector<std::string>& Profiler::getOverlayLines()
+{
+	int64_t t = now();
+	if (!overlay_lines.empty() && t - overlay_updated_ns < (int64_t)(OVERLAY_UPDATE_MS * 1e6)) {
+		return overlay_lines;
+	}
+	overlay_updated_ns = t;
+	overlay_lines.clear();
+
+	const int64_t window_start = t - 1000000000;
+	char line[128];
+
+	// Frame times over the last second
+	std::vector<float> recent_frames;
+	for (int i = std::max(0, num_frames - MAX_FRAMES); i < num_frames; i++) {
+		if (frame_end_ns[i % MAX_FRAMES] >= window_start) {
+			recent_frames.push_back(frame_ms[i % MAX_FRAMES]);
+		}
+	}
+	if (recent_frames.empty()) {
+		overlay_lines.push_back("No frames yet");
+		return overlay_lines;
+	}
+	std::sort(recent_frames.begin(), recent_frames.end());
+	auto percentile = [&recent_frames](float p) {
+		return recent_frames[std::min(recent_frames.size() - 1, (size_t)(p * recent_frames.size()))];
+	};
+	snprintf(line, sizeof(line), "Frame ms  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f  (%d fps)",
+		percentile(0.5f), percentile(0.95f), percentile(0.99f), recent_frames.back(), (int)recent_frames.size());
+	overlay_lines.push_back(line);
+
+	// Every scope's time per frame, the biggest first
+	struct ScopeTotal {
+		double total_ms = 0;
+		double max_ms = 0;
+	};
+	std::vector<ProfileSample> recent_samples;
+	collectSamples(window_start, recent_samples);
+	std::map<std::string, ScopeTotal> totals;
+	for (const ProfileSample& sample : recent_samples) {
+		ScopeTotal& total = totals[sample.name];
+		double ms = sample.duration_ns / 1e6;
+		total.total_ms += ms;
+		total.max_ms = std::max(total.max_ms, ms);
+	}
+
+	std::vector<std::pair<std::string, ScopeTotal>> sorted_totals(totals.begin(), totals.end());
+	std::sort(sorted_totals.begin(), sorted_totals.end(), [](const auto& a, const auto& b) { return a.second.total_ms > b.second.total_ms; });
+	if ((int)sorted_totals.size() > MAX_OVERLAY_SCOPES) {
+		sorted_totals.resize(MAX_OVERLAY_SCOPES);
+	}
+
+	for (const auto& pair : sorted_totals) {
+		snprintf(line, sizeof(line), "%s  %.3f ms  max %.3f", pair.first.c_str(),
+			pair.second.total_ms / recent_frames.size(), pair.second.max_ms);
+		overlay_lines.push_back(line);
+	}
+
+	return overlay_lines;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One timed scope, times are in nanoseconds since the profiler was created
+struct ProfileSample {
+	const char* name;	// string literal
+	int64_t start_ns;
+	int64_t duration_ns;
+	int thread;
+};
+
+// Collects timed scopes (see PROFILE_SCOPE) for the in-game overlay and for dumping as a chrome trace,
+// the dump opens in chrome://tracing or ui.perfetto.dev.
+// Samples go into a fixed size ring buffer, a writer claims its slot with a single atomic add so scopes can be
+// recorded from any thread without taking a lock. Once the ring is full the oldest samples are overwritten.
+class Profiler
+{
+public:
+	Profiler();
+
+	int64_t now() const;
+	void record(const char* name, int64_t start_ns, int64_t duration_ns);
+
+	// Call once per frame with the frame time, the overlay percentiles are taken from these
+	void endFrame(float frame_ms);
+
+	// Write the last `seconds` of samples as chrome trace_event json into a new file in the working directory.
+	// Returns the file path, or an empty string if the file couldn't be written
+	std::string dumpChromeTrace(float seconds);
+
+	// Text for the overlay: frame time percentiles, then ms per frame of every scope over the last second.
+	// Only rebuilt every OVERLAY_UPDATE_MS so it stays readable and cheap
+	const std::vector<std::string>& getOverlayLines();
+
+	bool is_overlay_enabled = false;
+	float dump_seconds = 10.f;	// how far back a dump goes
+
+private:
+	static const int MAX_SAMPLES = 1 << 16;	// a power of two, so the ring index is a mask
+	static const int MAX_FRAMES = 1024;
+	const float OVERLAY_UPDATE_MS = 500.f;
+	const int MAX_OVERLAY_SCOPES = 16;
+
+	std::chrono::steady_clock::time_point start_time;
+
+	struct ProfileSlot {
+		ProfileSample sample;
+		std::atomic<uint64_t> sequence{ 0 };	// index of the sample + 1 once it is fully written, 0 while writing
+	};
+	std::unique_ptr<ProfileSlot[]> slots;
+	std::atomic<uint64_t> next_sample{ 0 };
+
+	// Frame times and when each frame ended, ring buffers written by the main thread only
+	std::vector<float> frame_ms;
+	std::vector<int64_t> frame_end_ns;
+	int num_frames = 0;
+
+	std::vector<std::string> overlay_lines;
+	int64_t overlay_updated_ns = 0;
+
+	// Copy out every sample newer than since_ns, skipping any that are half written
+	void collectSamples(int64_t since_ns, std::vector<ProfileSample>& out_samples);
+};
+
+extern Profiler profiler;
+
+// Times the enclosing scope
+class ProfileScope
+{
+public:
+	ProfileScope(const char* name) : name(name), start_ns(profiler.now()) {}
+	~ProfileScope() { profiler.record(name, start_ns, profiler.now() - start_ns); }
+
+private:
+	const char* name;
+	int64_t start_ns;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
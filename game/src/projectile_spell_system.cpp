@@ -5,13 +5,11 @@
 
 
 void ProjectileSpellSystem::step(float elapsed_ms) {
-	for (Entity& projectileEntity : registry.projectiles.entities) {
-
-		if (!registry.projectiles.has(projectileEntity)) {
-			continue;
-		}
-		
-		Projectile& projectile = registry.projectiles.get(projectileEntity);
+	// Go by index, spells can still cast new projectiles while stepping. Those are only stepped from the next frame
+	size_t num_projectiles = registry.projectiles.size();
+	for (size_t i = 0; i < num_projectiles; i++) {
+		Entity projectileEntity = registry.projectiles.entities[i];
+		Projectile& projectile = registry.projectiles.components[i];
 
 		if (projectile.is_dead) {
 			continue;
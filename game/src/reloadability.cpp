@@ -131,7 +131,10 @@ bool load_scores(int& score, std::vector<int>& top_10_score)
 		in_file.close();
 		return true;
 	}
-	
+
+	// No scores saved yet (fresh checkout), start from the empty table so update_record has its 10 entries
+	score = initialize_high_score_json["highest_score"];
+	top_10_score = initialize_high_score_json["top_10_highest_score"].template get<std::vector<int>>();
 	return false;
 }
 
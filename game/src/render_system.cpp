@@ -9,30 +9,31 @@
 #include "spells.hpp"
 #include <glm/gtc/type_ptr.hpp>
 #include "relics.hpp"
+#include "profiler.hpp"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
 
-/* This function has several prerequisites:
-* 1. This only works if every entity in componentContainer has an associated Transformation Component
-* 2. The shader referenced in shader_id must have the following fields:
+/* Fills in the instance buffer of a tile layer from the given floor/wall entities.
+* The tiles don't move once the level is created, so this only runs when the level changes.
+* The shader for EFFECT_ASSET_ID::ENVIRONMENT must have the following fields:
 *   a. in_position (vec3)
 *   b. in_texcoord (vec2)
 *   c. instance_matrix (mat3)
+*   d. in_tilecoord (vec2)
 */
-void RenderSystem::drawTiles(std::vector<Entity> entities, TEXTURE_ASSET_ID texture_asset_id, const mat3& projection) {
+void RenderSystem::buildTileLayer(TileLayer& layer, const std::vector<Entity>& entities, TEXTURE_ASSET_ID texture_asset_id) {
 
-	int entityCount = entities.size();
-
-	TileInfo* tile_info = new TileInfo[entityCount];
+	// Bucket the tiles into TILE_CHUNK_SIZE x TILE_CHUNK_SIZE chunks, the instances of a chunk are stored
+	// contiguously so a chunk can be drawn (or culled) as one range of the instance buffer
+	std::map<std::pair<int, int>, std::vector<TileInfo>> chunk_tiles; // (chunk y, chunk x) -> tiles, so chunks are in row order
+	std::map<std::pair<int, int>, TileChunk> chunk_bounds;
+	const float chunk_extent = (float)(TILE_CHUNK_SIZE * TILE_SIZE);
 
 	ivec2& texture_dimension = texture_dimensions[(GLuint)texture_asset_id];
-	// TODO: I think we can extract this out of the loop / out of this function
-	for (int i = 0; i < entityCount; i++) {
+	for (Entity current_entity : entities) {
 
-		Entity& current_entity = entities[i];
-		
 		if (!registry.transforms.has(current_entity)) continue;
 
 		Transformation& current_transform = registry.transforms.get(current_entity);
@@ -45,28 +46,46 @@ void RenderSystem::drawTiles(std::vector<Entity> entities, TEXTURE_ASSET_ID text
 		e_transform.scale(trueScale);
 		e_transform.rotate(radians(current_transform.angle));
 
-		tile_info[i].transform_matrix = e_transform.mat;
+		TileInfo info;
+		info.transform_matrix = e_transform.mat;
+		info.tilecoord = registry.tiles.has(current_entity) ? registry.tiles.get(current_entity).tilecoord : vec2(0);
 
+		std::pair<int, int> key = { (int)floor(current_transform.position.y / chunk_extent), (int)floor(current_transform.position.x / chunk_extent) };
+		chunk_tiles[key].push_back(info);
 
-		if (registry.walls.has(current_entity)) {
-			Tile tile = registry.tiles.get(current_entity);
-			tile_info[i].tilecoord = tile.tilecoord;
+		// A rotated tile can reach as far as half its diagonal
+		vec2 half_size = current_transform.angle == 0.f ? abs(trueScale) / 2.f : vec2(length(trueScale) / 2.f);
+		vec2 tile_min = current_transform.position - half_size;
+		vec2 tile_max = current_transform.position + half_size;
+		auto it = chunk_bounds.find(key);
+		if (it == chunk_bounds.end()) {
+			chunk_bounds[key] = { tile_min, tile_max, 0, 0 };
 		}
-		else if (registry.floors.has(current_entity)) {
-			Tile tile = registry.tiles.get(current_entity);
-			tile_info[i].tilecoord = tile.tilecoord;
+		else {
+			it->second.min = glm::min(it->second.min, tile_min);
+			it->second.max = glm::max(it->second.max, tile_max);
 		}
 	}
 
-	const GLuint program = (GLuint)effects[(GLuint)EFFECT_ASSET_ID::ENVIRONMENT];
+	std::vector<TileInfo> tile_info;
+	tile_info.reserve(entities.size());
+	layer.chunks.clear();
+	for (auto& [key, tiles] : chunk_tiles) {
+		TileChunk chunk = chunk_bounds[key];
+		chunk.first_instance = (GLint)tile_info.size();
+		chunk.instance_count = (GLsizei)tiles.size();
+		layer.chunks.push_back(chunk);
+		tile_info.insert(tile_info.end(), tiles.begin(), tiles.end());
+	}
 
-	// Setting shaders
-	glUseProgram(program);
+	// The vao remembers all the attribute bindings below, so drawing the layer only has to bind it
+	if (layer.vao == 0) {
+		glGenVertexArrays(1, &layer.vao);
+		glGenBuffers(1, &layer.instance_vbo);
+	}
+	glBindVertexArray(layer.vao);
 	gl_has_errors();
 
-  
-
-
 	const GLuint vbo = vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::BACKGROUND];
 	const GLuint ibo = index_buffers[(GLuint)GEOMETRY_BUFFER_ID::BACKGROUND];
 
@@ -77,169 +96,157 @@ void RenderSystem::drawTiles(std::vector<Entity> entities, TEXTURE_ASSET_ID text
 
 	// texture-mapped entities - use data location as in the vertex buffer
 	GLint in_position_loc = 0;
-	//!!!!!
-	glBindAttribLocation(program, in_position_loc, "in_position");
-
 	GLint in_texcoord_loc = 1;
-	glBindAttribLocation(program, in_texcoord_loc, "in_texcoord");
-	gl_has_errors();
-	assert(in_texcoord_loc >= 0);
 
 	glEnableVertexAttribArray(in_position_loc);
 	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
 		sizeof(TexturedVertex), (void*)0);
 	gl_has_errors();
 
+	// The vertex buffer is an Array of TexturedVertex, the stride skips over the position to the next texcoord
 	glEnableVertexAttribArray(in_texcoord_loc);
 	glVertexAttribPointer(
 		in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex),
-		(void*)sizeof(
-			vec3)); // note the stride to skip the preceeding vertex position
-	// Q: How does stride work ? I'd figure the offset is enough, why do we need to do this?
-	// A: The vertex buffer is an Array of TexturedVertex, and TexturedVertex is made of 2 parts, position and texcoords. 
-	//	  The offset is so we access texcoords properly, and then the stride makes it so we "jump" to the next texcoord in the array, and not the position or something
+		(void*)sizeof(vec3));
+	gl_has_errors();
 
-	// NEW CODE:
 	// references:
 	// https://stackoverflow.com/questions/17355051/using-a-matrix-as-vertex-attribute-in-opengl3-core-profile
 	// https://learnopengl.com/Advanced-OpenGL/Instancing
+	glBindBuffer(GL_ARRAY_BUFFER, layer.instance_vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(TileInfo) * tile_info.size(), tile_info.data(), GL_STATIC_DRAW);
+	tile_bytes_uploaded += sizeof(TileInfo) * tile_info.size();
+	gl_has_errors();
 
-	// bind new vbo and attach to it transformation data-- this is where we load the position data in
-	const GLuint instanceVBO = instance_buffers[(int)GEOMETRY_BUFFER_ID::BACKGROUND]; // always the first instance_buffer
-
-
-	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(TileInfo) * entityCount, &tile_info[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo); //rebind original vbo before moving forward	
-
-	// this is normal stuff-- binding the instance_matrix_loc to attribute location 2, as specified in vertex shader
-	GLint instance_matrix_loc = 2;
-	glBindAttribLocation(program, instance_matrix_loc, "instance_matrix");
-
-	int pos0 = instance_matrix_loc + 0;
-	int pos1 = instance_matrix_loc + 1;
-	int pos2 = instance_matrix_loc + 2;
-	glEnableVertexAttribArray(pos0);
-	glEnableVertexAttribArray(pos1);
-	glEnableVertexAttribArray(pos2);
-
-	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO); // rebind 
-
-	// binding attributes-- a mat3 is passed in as 3 vec3s cause shaders only directly accept up to vec4 size
-	int vec3Size = sizeof(vec3);
-	glVertexAttribPointer(pos0, 3, GL_FLOAT, GL_FALSE, sizeof(TileInfo), (void*)0);
-	glVertexAttribPointer(pos1, 3, GL_FLOAT, GL_FALSE, sizeof(TileInfo), (void*)(1 * sizeof(vec3)));
-	glVertexAttribPointer(pos2, 3, GL_FLOAT, GL_FALSE, sizeof(TileInfo), (void*)(2 * sizeof(vec3)));
-
-	// sets these to instance variables-- the 1 indicates the repetition frequency (0 for non-instance)
-	glVertexAttribDivisor(pos0, 1);
-	glVertexAttribDivisor(pos1, 1);
-	glVertexAttribDivisor(pos2, 1);
-
-	
-
-	GLint tilecoord_loc = pos2 + 1;
-	glBindAttribLocation(program, tilecoord_loc, "in_tilecoord");
-
-	glEnableVertexAttribArray(tilecoord_loc);
-
-	glVertexAttribPointer(tilecoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TileInfo), (void*)(3 * sizeof(vec3)));
-
-	glVertexAttribDivisor(tilecoord_loc, 1);
-
-
-	glBindBuffer(GL_ARRAY_BUFFER, vbo); // Finished the new code section-- set vbo back to normal
+	// a mat3 is passed in as 3 vec3s cause shaders only directly accept up to vec4 size, then the tilecoord
+	for (int i = 0; i < 4; i++) {
+		glEnableVertexAttribArray(TILE_INSTANCE_ATTRIB_LOC + i);
+		// the 1 indicates the repetition frequency (0 for non-instance)
+		glVertexAttribDivisor(TILE_INSTANCE_ATTRIB_LOC + i, 1);
+	}
+	setTileInstanceOffset(0);
+	gl_has_errors();
 
+	// Get number of indices from index buffer, which has elements uint16_t
+	GLint size = 0;
+	glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+	gl_has_errors();
 
-	// Set uniforms
-	if (entities.size() > 0) {
-		if (registry.walls.has(entities[0])) {
-			GLint h_frame_uloc = glGetUniformLocation(program, "h_tiles");
-			glUniform1f(h_frame_uloc, (float)NUM_WALL_TILES_H);
-			gl_has_errors();
+	layer.num_indices = size / sizeof(uint16_t);
+	layer.instance_count = (GLsizei)tile_info.size();
 
-			// Getting uniform locations for glUniform* calls
-			GLint v_frame_uloc = glGetUniformLocation(program, "v_tiles");
-			glUniform1f(v_frame_uloc, (float)NUM_WALL_TILES_V);
-			gl_has_errors();
-		}
-		else if (registry.floors.has(entities[0])) {
-			GLint h_frame_uloc = glGetUniformLocation(program, "h_tiles");
-			glUniform1f(h_frame_uloc, (float)NUM_FLOOR_TILES_H);
-			gl_has_errors();
+	// Back to the shared vao, so nothing else changes the bindings of this one
+	glBindVertexArray(m_vao);
+	gl_has_errors();
+}
 
-			// Getting uniform locations for glUniform* calls
-			GLint v_frame_uloc = glGetUniformLocation(program, "v_tiles");
-			glUniform1f(v_frame_uloc, (float)NUM_FLOOR_TILES_V);
-			gl_has_errors();
-		}
+// Points the instance attributes of the bound tile vao at the given instance of the bound instance buffer
+void RenderSystem::setTileInstanceOffset(GLint first_instance) {
+	size_t base = first_instance * sizeof(TileInfo);
+	for (int i = 0; i < 3; i++) {
+		glVertexAttribPointer(TILE_INSTANCE_ATTRIB_LOC + i, 3, GL_FLOAT, GL_FALSE, sizeof(TileInfo), (void*)(base + i * sizeof(vec3)));
 	}
-	
-
-	
+	glVertexAttribPointer(TILE_INSTANCE_ATTRIB_LOC + 3, 2, GL_FLOAT, GL_FALSE, sizeof(TileInfo), (void*)(base + 3 * sizeof(vec3)));
+}
 
+void RenderSystem::drawTiles(const TileLayer& layer, TEXTURE_ASSET_ID texture_asset_id, vec2 num_tiles, const mat3& projection) {
+	PROFILE_SCOPE("drawTiles");
 
+	if (layer.instance_count == 0) {
+		return;
+	}
 
+	const GLuint program = (GLuint)effects[(GLuint)EFFECT_ASSET_ID::ENVIRONMENT];
 
-	// Enabling and binding texture to slot 0
-	glActiveTexture(GL_TEXTURE0);
+	// Setting shaders
+	glUseProgram(program);
 	gl_has_errors();
 
-	GLuint texture_id =
-		texture_gl_handles[(GLuint)texture_asset_id];
-
-	glBindTexture(GL_TEXTURE_2D, texture_id);
+	glBindVertexArray(layer.vao);
 	gl_has_errors();
 
-	// Get number of indices from index buffer, which has elements uint16_t
-	GLint size = 0;
-	glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+	// Set uniforms
+	GLint h_frame_uloc = glGetUniformLocation(program, "h_tiles");
+	glUniform1f(h_frame_uloc, num_tiles.x);
+	GLint v_frame_uloc = glGetUniformLocation(program, "v_tiles");
+	glUniform1f(v_frame_uloc, num_tiles.y);
 	gl_has_errors();
 
-	GLsizei num_indices = size / sizeof(uint16_t);
-	// GLsizei num_triangles = num_indices / 3;
+	GLuint projection_loc = glGetUniformLocation(program, "projection");
+	glUniformMatrix3fv(projection_loc, 1, GL_FALSE, (float*)&projection);
+	gl_has_errors();
 
-	GLint currProgram;
-	glGetIntegerv(GL_CURRENT_PROGRAM, &currProgram);
+	// Enabling and binding texture to slot 0
+	glActiveTexture(GL_TEXTURE0);
+	gl_has_errors();
 
-	GLuint projection_loc = glGetUniformLocation(currProgram, "projection");
-	glUniformMatrix3fv(projection_loc, 1, GL_FALSE, (float*)&projection);
+	bindTexture(program, texture_asset_id);
 	gl_has_errors();
 
 	// Munn: setting texture filter to NEAREST, instead of the defeault LINEAR (for pixel art)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // when scaling down
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); // when scaling up
 
-	// Drawing of num_indices/3 triangles specified in the index buffer
-	glDrawElementsInstanced(GL_TRIANGLES, num_indices, GL_UNSIGNED_SHORT, nullptr, entityCount);
-	gl_has_errors();
+	// Only submit the chunks that overlap the camera rect (same rect as createProjectionMatrix).
+	// Chunks are in row order, so visible neighbours in a row are merged into a single draw call.
+	vec2 camera_pos = vec2(0, 0);
+	if (!registry.cameras.entities.empty()) {
+		camera_pos = registry.transforms.get(registry.cameras.entities[0]).position;
+	}
+	vec2 camera_min = camera_pos - vec2(WINDOW_WIDTH_PX, WINDOW_HEIGHT_PX) / 2.f;
+	vec2 camera_max = camera_pos + vec2(WINDOW_WIDTH_PX, WINDOW_HEIGHT_PX) / 2.f;
+
+	glBindBuffer(GL_ARRAY_BUFFER, layer.instance_vbo);
+
+	GLint run_first = 0;
+	GLsizei run_count = 0;
+	for (size_t i = 0; i <= layer.chunks.size(); i++) {
+		bool visible = false;
+		if (i < layer.chunks.size()) {
+			const TileChunk& chunk = layer.chunks[i];
+			visible = chunk.max.x >= camera_min.x && chunk.min.x <= camera_max.x &&
+				chunk.max.y >= camera_min.y && chunk.min.y <= camera_max.y;
+			if (visible) {
+				tile_chunks_drawn++;
+				if (run_count > 0 && run_first + run_count == chunk.first_instance) {
+					run_count += chunk.instance_count;
+					continue;
+				}
+			}
+		}
 
-	// This is really important-- unassigns buffer and therefore stops memory leak
-	//glDeleteBuffers(1, &instanceVBO); // TODO: small optimization by reusing a single instanceVBO over multiple draw calls
-	delete[]tile_info;
+		// Flush the current run, GL 3.3 has no base instance so the instance attributes are offset instead
+		if (run_count > 0) {
+			setTileInstanceOffset(run_first);
+			glDrawElementsInstanced(GL_TRIANGLES, layer.num_indices, GL_UNSIGNED_SHORT, nullptr, run_count);
+			gl_has_errors();
+			tile_instances_drawn += run_count;
+			run_count = 0;
+		}
+		if (visible) {
+			run_first = layer.chunks[i].first_instance;
+			run_count = layer.chunks[i].instance_count;
+		}
+	}
 
-	// Munn: without reseting these, the particles were no longer showing up for me
-	glVertexAttribDivisor(pos0, 0);
-	glVertexAttribDivisor(pos1, 0);
-	glVertexAttribDivisor(pos2, 0);
-	glVertexAttribDivisor(tilecoord_loc, 0);
+	// The divisors live in the tile vao, so the shared one is untouched for the particles and everything else
+	glBindVertexArray(m_vao);
+	gl_has_errors();
 }
 
 
 
 void RenderSystem::drawEnvironment(const mat3& projection) {
 
-	// TODO: do the frustrum culling here based on rooms, accessing a higher-scoped
-	// vectors (that I've yet to create) called "floorsToRender" and "wallsToRender"
-
-	// these vectors should eventually hold pointers to entities that we want to render. 
-
-	// Create vectors of unculled floors/walls
-	std::vector<Entity> floors = registry.floors.entities;
-	std::vector<Entity> walls = registry.walls.entities;
+	// Tiles only change when a level is loaded, rebuild their instance buffers then
+	if (tile_layers_dirty) {
+		buildTileLayer(floor_layer, registry.floors.entities, TEXTURE_ASSET_ID::FLOOR);
+		buildTileLayer(wall_layer, registry.walls.entities, TEXTURE_ASSET_ID::WALL);
+		tile_layers_dirty = false;
+	}
 
 	// Draw floor
-	drawTiles(floors, TEXTURE_ASSET_ID::FLOOR, projection);
+	drawTiles(floor_layer, TEXTURE_ASSET_ID::FLOOR, vec2(NUM_FLOOR_TILES_H, NUM_FLOOR_TILES_V), projection);
 
 	// Draw "doors"
 	for (Entity entity : registry.enemyRoomManagers.entities) {
@@ -259,7 +266,7 @@ void RenderSystem::drawEnvironment(const mat3& projection) {
 	}
 
 	// Draw walls
-	drawTiles(walls, TEXTURE_ASSET_ID::WALL, projection);
+	drawTiles(wall_layer, TEXTURE_ASSET_ID::WALL, vec2(NUM_WALL_TILES_H, NUM_WALL_TILES_V), projection);
 }
 
 
@@ -292,6 +299,24 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 
 	transform.rotate(radians(entity_transform.angle));
 
+	// Plain and animated sprites go into the batch, everything else draws right away (after the batch, to keep the order)
+	if (is_sprite_batching && isSpriteBatchable(render_request)) {
+		vec4 frame = vec4(1, 1, 0, render_request.is_hitflash);
+		if (render_request.used_effect == EFFECT_ASSET_ID::ANIMATED) {
+			Animation& animation = registry.animation_managers.get(entity).current_animation;
+			int current_frame = ((int)animation.current_time % animation.num_frames);
+			frame = vec4(animation.h_frames, animation.v_frames, current_frame, render_request.is_hitflash);
+		}
+		const vec3 color = registry.colors.has(entity) ? registry.colors.get(entity) : vec3(1);
+		batchSprite(render_request.used_texture, transform.mat, color, frame);
+
+		if (registry.interactables.has(entity)) {
+			drawIconOnInteractable(entity, projection);
+		}
+		return;
+	}
+	flushSprites();
+
 	const GLuint used_effect_enum = (GLuint)render_request.used_effect;
 	assert(used_effect_enum != (GLuint)EFFECT_ASSET_ID::EFFECT_COUNT);
 	const GLuint program = (GLuint)effects[used_effect_enum];
@@ -330,10 +355,7 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 	gl_has_errors();
 
 	assert(registry.renderRequests.has(entity));
-	GLuint texture_id =
-		texture_gl_handles[(GLuint)registry.renderRequests.get(entity).used_texture];
-
-	glBindTexture(GL_TEXTURE_2D, texture_id);
+	bindTexture(program, registry.renderRequests.get(entity).used_texture);
 	gl_has_errors();
 
 	// texture-mapped entities - use data location as in the vertex buffer
@@ -451,32 +473,20 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 		gl_has_errors();
 	}
 	else if (render_request.used_effect == EFFECT_ASSET_ID::MINIMAP) {
-		// Pass num tiles x and y, and also which tiles are revealed
-
-		Minimap minimap = registry.minimaps.components[0];
+		// Pass the map size in tiles, and the texture of which tiles are revealed
+		Minimap& minimap = registry.minimaps.components[0];
+		updateMinimapTexture(minimap);
 
-		std::vector<vec2> revealed_walls = minimap.wall_positions;
-		
-		// HARD CODED MAP SIZES
-		GLint x_tiles_uloc = glGetUniformLocation(program, "num_x_tiles");
-		GLint y_tiles_uloc = glGetUniformLocation(program, "num_y_tiles");
-		glUniform1f(x_tiles_uloc, (float)100);
-		glUniform1f(y_tiles_uloc, (float)100);
+		GLint num_tiles_uloc = glGetUniformLocation(program, "num_tiles");
+		glUniform1f(num_tiles_uloc, (float)minimap.map_size);
 		gl_has_errors();
 
-		// Pass in revealed tiles
-		for (int i = 0; i < revealed_walls.size(); i++) {
-			std::string var_name = "revealed_walls[" + std::to_string(i) + "]";
-			GLint revealed_walls_uloc = glGetUniformLocation(program, var_name.c_str());
-			//std::cout << revealed_walls_uloc << std::endl;
-			glUniform2f(revealed_walls_uloc, revealed_walls[i].x, revealed_walls[i].y);
-		}
-
-		GLint num_walls_uloc = glGetUniformLocation(program, "num_revealed_walls");
-		glUniform1f(num_walls_uloc, (float)revealed_walls.size());
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, minimap_texture);
+		GLint revealed_uloc = glGetUniformLocation(program, "revealed_tiles");
+		glUniform1i(revealed_uloc, 1);
+		glActiveTexture(GL_TEXTURE0);
 		gl_has_errors();
-
-
 	}
 	else {
 		assert(false && "Type of render request not supported");
@@ -530,39 +540,11 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 	gl_has_errors();
 
 	if (registry.interactables.has(entity)) {
-		Interactable interactable = registry.interactables.get(entity);
-
-		if (interactable.interactable_id == INTERACTABLE_ID::PROJECTILE_SPELL_DROP
-			|| interactable.interactable_id == INTERACTABLE_ID::MOVEMENT_SPELL_DROP
-			|| interactable.interactable_id == INTERACTABLE_ID::RELIC_DROP) {
-			drawIconOnInteractable(entity, projection);
-		}
+		drawIconOnInteractable(entity, projection);
 	}
 }
 
 void RenderSystem::drawShadow(Entity entity, const mat3& projection) {
-	GLuint program = effects[(GLuint)EFFECT_ASSET_ID::TEXTURED];
-	glUseProgram(program);
-	gl_has_errors();
-
-	// bind the geometry buffer (quad) for our health bars
-	GLuint vbo = vertex_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE];
-	GLuint ibo = index_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE];
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-
-
-	GLint in_position_loc = glGetAttribLocation(program, "in_position");
-	glEnableVertexAttribArray(in_position_loc);
-	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
-		sizeof(TexturedVertex), (void*)0);
-
-	GLint in_texcoord_loc = glGetAttribLocation(program, "in_texcoord");
-	glEnableVertexAttribArray(in_texcoord_loc);
-	glVertexAttribPointer(
-		in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex),
-		(void*)sizeof(vec3));
-
 	if (!registry.renderRequests.has(entity)) {
 		return;
 	}
@@ -595,6 +577,33 @@ void RenderSystem::drawShadow(Entity entity, const mat3& projection) {
 		entity_transform.scale.y * shadow_dimension.y * PIXEL_SCALE_FACTOR);
 	transform.scale(trueScale);
 
+	if (is_sprite_batching) {
+		batchSprite(TEXTURE_ASSET_ID::SHADOW, transform.mat, vec3(1), vec4(1, 1, 0, 0));
+		return;
+	}
+
+	GLuint program = effects[(GLuint)EFFECT_ASSET_ID::TEXTURED];
+	glUseProgram(program);
+	gl_has_errors();
+
+	// bind the geometry buffer (quad) for our health bars
+	GLuint vbo = vertex_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE];
+	GLuint ibo = index_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE];
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+
+
+	GLint in_position_loc = glGetAttribLocation(program, "in_position");
+	glEnableVertexAttribArray(in_position_loc);
+	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
+		sizeof(TexturedVertex), (void*)0);
+
+	GLint in_texcoord_loc = glGetAttribLocation(program, "in_texcoord");
+	glEnableVertexAttribArray(in_texcoord_loc);
+	glVertexAttribPointer(
+		in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex),
+		(void*)sizeof(vec3));
+
 	// Getting uniform locations for glUniform* calls
 	GLint color_uloc = glGetUniformLocation(program, "fcolor");
 	vec3 color = vec3(1);
@@ -618,8 +627,7 @@ void RenderSystem::drawShadow(Entity entity, const mat3& projection) {
 
 	// Enabling and binding texture to slot 0
 	glActiveTexture(GL_TEXTURE0);
-	GLuint texture_id = texture_gl_handles[shadow_id];
-	glBindTexture(GL_TEXTURE_2D, texture_id);
+	bindTexture(program, (TEXTURE_ASSET_ID)shadow_id);
 	gl_has_errors();
 
 	// Get number of indices from index buffer, which has elements uint16_t
@@ -639,29 +647,7 @@ void RenderSystem::drawShadow(Entity entity, const mat3& projection) {
 }
 
 void RenderSystem::drawIconOnInteractable(Entity entity, const mat3& projection) {
-	GLuint program = effects[(GLuint)EFFECT_ASSET_ID::TEXTURED];
-	glUseProgram(program);
-	gl_has_errors();
-
-	// bind the geometry buffer (quad) for our health bars
-	GLuint vbo = vertex_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE];
-	GLuint ibo = index_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE];
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-
-
-	GLint in_position_loc = glGetAttribLocation(program, "in_position");
-	glEnableVertexAttribArray(in_position_loc);
-	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
-		sizeof(TexturedVertex), (void*)0);
-
-	GLint in_texcoord_loc = glGetAttribLocation(program, "in_texcoord");
-	glEnableVertexAttribArray(in_texcoord_loc);
-	glVertexAttribPointer(
-		in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex),
-		(void*)sizeof(vec3));
-
-	// Munn: This function assumes the entity you pass in is a spell drop interactable
+	// Only spell and relic drops show an icon
 	Interactable interactable = registry.interactables.get(entity);
 
 	int asset_id = 0;
@@ -669,14 +655,17 @@ void RenderSystem::drawIconOnInteractable(Entity entity, const mat3& projection)
 		ProjectileSpell* spell = projectile_spells[(int)interactable.spell_id];
 		asset_id = (int)spell->getAssetID();
 	}
-	if (interactable.interactable_id == INTERACTABLE_ID::MOVEMENT_SPELL_DROP) {
+	else if (interactable.interactable_id == INTERACTABLE_ID::MOVEMENT_SPELL_DROP) {
 		MovementSpell* spell = movement_spells[(int)interactable.spell_id];
 		asset_id = (int)spell->getAssetID();
 	}
-	if (interactable.interactable_id == INTERACTABLE_ID::RELIC_DROP) {
+	else if (interactable.interactable_id == INTERACTABLE_ID::RELIC_DROP) {
 		Relic* relic = relics[(int)interactable.relic_id];
 		asset_id = (int)relic->getIconAsset();
 	}
+	else {
+		return;
+	}
 
 	Transformation entity_transform = registry.transforms.get(entity);
 
@@ -692,6 +681,33 @@ void RenderSystem::drawIconOnInteractable(Entity entity, const mat3& projection)
 
 	transform.rotate(radians(entity_transform.angle));
 
+	if (is_sprite_batching) {
+		batchSprite((TEXTURE_ASSET_ID)asset_id, transform.mat, vec3(1), vec4(1, 1, 0, 0));
+		return;
+	}
+
+	GLuint program = effects[(GLuint)EFFECT_ASSET_ID::TEXTURED];
+	glUseProgram(program);
+	gl_has_errors();
+
+	// bind the geometry buffer (quad) for our health bars
+	GLuint vbo = vertex_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE];
+	GLuint ibo = index_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE];
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+
+
+	GLint in_position_loc = glGetAttribLocation(program, "in_position");
+	glEnableVertexAttribArray(in_position_loc);
+	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
+		sizeof(TexturedVertex), (void*)0);
+
+	GLint in_texcoord_loc = glGetAttribLocation(program, "in_texcoord");
+	glEnableVertexAttribArray(in_texcoord_loc);
+	glVertexAttribPointer(
+		in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex),
+		(void*)sizeof(vec3));
+
 	// Getting uniform locations for glUniform* calls
 	GLint color_uloc = glGetUniformLocation(program, "fcolor");
 	vec3 color = vec3(1);
@@ -710,8 +726,7 @@ void RenderSystem::drawIconOnInteractable(Entity entity, const mat3& projection)
 
 	// Enabling and binding texture to slot 0
 	glActiveTexture(GL_TEXTURE0);
-	GLuint texture_id = texture_gl_handles[(GLuint)asset_id];
-	glBindTexture(GL_TEXTURE_2D, texture_id);
+	bindTexture(program, (TEXTURE_ASSET_ID)asset_id);
 	gl_has_errors();
 
 	// Get number of indices from index buffer, which has elements uint16_t
@@ -731,6 +746,80 @@ void RenderSystem::drawIconOnInteractable(Entity entity, const mat3& projection)
 }
 
 
+// Binds the atlas page of a texture to the active slot and tells the current program where on the page the texture is
+void RenderSystem::bindTexture(GLuint program, TEXTURE_ASSET_ID texture_asset_id) {
+	glBindTexture(GL_TEXTURE_2D, texture_gl_handles[(GLuint)texture_asset_id]);
+	GLint uv_rect_uloc = glGetUniformLocation(program, "uv_rect");
+	glUniform4fv(uv_rect_uloc, 1, (float*)&texture_uv_rects[(GLuint)texture_asset_id]);
+}
+
+bool RenderSystem::isSpriteBatchable(const RenderRequest& render_request) {
+	bool is_quad = render_request.used_geometry == GEOMETRY_BUFFER_ID::SPRITE || render_request.used_geometry == GEOMETRY_BUFFER_ID::ANIMATED_SPRITE;
+	bool is_sprite_effect = render_request.used_effect == EFFECT_ASSET_ID::TEXTURED || render_request.used_effect == EFFECT_ASSET_ID::ANIMATED;
+	return is_quad && is_sprite_effect;
+}
+
+void RenderSystem::beginSpriteBatch(const mat3& projection) {
+	sprite_batch_projection = projection;
+	is_sprite_batching = true;
+}
+
+void RenderSystem::endSpriteBatch() {
+	flushSprites();
+	is_sprite_batching = false;
+}
+
+void RenderSystem::batchSprite(TEXTURE_ASSET_ID texture_asset_id, const mat3& transform, vec3 color, vec4 frame) {
+	// Sprites on the same atlas page can share a run, a different page ends it
+	GLuint texture_id = texture_gl_handles[(GLuint)texture_asset_id];
+	if (!sprite_batch.empty() && texture_id != sprite_batch_texture) {
+		flushSprites();
+	}
+	sprite_batch_texture = texture_id;
+	sprite_batch.push_back({ transform, color, frame, texture_uv_rects[(GLuint)texture_asset_id] });
+}
+
+// Draws every batched sprite in a single instanced call, they all share the sprite_batch_texture page
+void RenderSystem::flushSprites() {
+	if (sprite_batch.empty()) {
+		return;
+	}
+
+	const GLuint program = effects[(GLuint)EFFECT_ASSET_ID::SPRITE];
+	glUseProgram(program);
+	glBindVertexArray(sprite_vao);
+	gl_has_errors();
+
+	// Orphan and refill the instance buffer, the driver can hand out fresh memory while the last run is still drawing
+	glBindBuffer(GL_ARRAY_BUFFER, instance_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE]);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteInfo) * sprite_batch.size(), sprite_batch.data(), GL_DYNAMIC_DRAW);
+	gl_has_errors();
+
+	GLuint projection_loc = glGetUniformLocation(program, "projection");
+	glUniformMatrix3fv(projection_loc, 1, GL_FALSE, (float*)&sprite_batch_projection);
+	gl_has_errors();
+
+	// Enabling and binding texture to slot 0
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, sprite_batch_texture);
+	gl_has_errors();
+
+	// Munn: setting texture filter to NEAREST, instead of the defeault LINEAR (for pixel art)
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // when scaling down
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); // when scaling up
+
+	glDrawElementsInstanced(GL_TRIANGLES, sprite_num_indices, GL_UNSIGNED_SHORT, nullptr, (GLsizei)sprite_batch.size());
+	gl_has_errors();
+
+	sprite_draw_calls++;
+	sprites_drawn += (int)sprite_batch.size();
+	sprite_batch.clear();
+
+	glBindVertexArray(m_vao);
+	gl_has_errors();
+}
+
+
 
 
 // first draw to an intermediate texture,
@@ -814,9 +903,106 @@ void RenderSystem::drawToScreen()
 }
 
 
+// Points the instance attributes of the bound particle vao at the given byte offset into the particle instance buffer
+void RenderSystem::setParticleInstanceOffset(GLintptr offset) {
+	for (int i = 0; i < 3; i++) {
+		glVertexAttribPointer(2 + i, 3, GL_FLOAT, GL_FALSE, sizeof(ParticleInfo), (void*)(offset + offsetof(ParticleInfo, transform_matrix) + i * sizeof(vec3)));
+	}
+	glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInfo), (void*)(offset + offsetof(ParticleInfo, color)));
+	glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInfo), (void*)(offset + offsetof(ParticleInfo, uv_rect)));
+}
+
 // Render particles using instanced rendering
-// Munn: At the moment, it uses one draw call for each particle_emitter, but we can change this to be one draw call for all the particles if we run into performance issues
+// Every alive particle goes into the streaming buffer in one pass, grouped by the atlas page of its emitter's sprite, so
+// it takes one draw call per page no matter how many emitters there are (the particle sprites share a page)
 void RenderSystem::drawParticles(const mat3& projection) {
+	PROFILE_SCOPE("drawParticles");
+
+	auto& containers = registry.particle_emitter_containers.components;
+
+	// Count the particles on every page, then turn the counts into where each page's run starts
+	particle_page_runs.assign(atlas_pages.size(), 0);
+	int num_particles = 0;
+	for (ParticleEmitterContainer& particle_emitter_container : containers) {
+		for (ParticleEmitter& particle_emitter : particle_emitter_container.emitters) {
+			if (particle_emitter.descriptor != nullptr && particle_emitter.particles.num_alive > 0) {
+				particle_page_runs[texture_atlas_pages[(int)particle_emitter.descriptor->sprite_id]] += particle_emitter.particles.num_alive;
+				num_particles += particle_emitter.particles.num_alive;
+			}
+		}
+	}
+	if (num_particles == 0) {
+		return;
+	}
+	for (int page = 0, first = 0; page < (int)particle_page_runs.size(); page++) {
+		int count = particle_page_runs[page];
+		particle_page_runs[page] = first;
+		first += count;
+	}
+
+	glBindVertexArray(particle_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, particle_instance_vbo);
+	gl_has_errors();
+
+	// Take the next part of the ring. When the frame doesn't fit the buffer is orphaned, the driver keeps the old storage
+	// alive for the draws still using it, so the parts already handed out are never written while the gpu reads them
+	GLsizeiptr num_bytes = (GLsizeiptr)sizeof(ParticleInfo) * num_particles;
+	if (num_bytes * PARTICLE_RING_FRAMES > particle_buffer_size) {
+		particle_buffer_size = num_bytes * PARTICLE_RING_FRAMES;
+		particle_buffer_head = particle_buffer_size;
+	}
+	if (particle_buffer_head + num_bytes > particle_buffer_size) {
+		glBufferData(GL_ARRAY_BUFFER, particle_buffer_size, nullptr, GL_STREAM_DRAW);
+		particle_buffer_head = 0;
+	}
+	GLintptr frame_offset = particle_buffer_head;
+	particle_buffer_head += num_bytes;
+
+	ParticleInfo* particle_info = (ParticleInfo*)glMapBufferRange(GL_ARRAY_BUFFER, frame_offset, num_bytes,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	gl_has_errors();
+	if (particle_info == nullptr) {
+		glBindVertexArray(m_vao);
+		return;
+	}
+
+	const float* position_x = particle_pool.field(ParticlePool::POSITION_X);
+	const float* position_y = particle_pool.field(ParticlePool::POSITION_Y);
+	const float* scale_x = particle_pool.field(ParticlePool::SCALE_X);
+	const float* scale_y = particle_pool.field(ParticlePool::SCALE_Y);
+	const float* color_r = particle_pool.field(ParticlePool::COLOR_R);
+	const float* color_g = particle_pool.field(ParticlePool::COLOR_G);
+	const float* color_b = particle_pool.field(ParticlePool::COLOR_B);
+	const float* color_a = particle_pool.field(ParticlePool::COLOR_A);
+	for (ParticleEmitterContainer& particle_emitter_container : containers) { // Get Container
+		for (ParticleEmitter& particle_emitter : particle_emitter_container.emitters) { // Get each particle_emitter
+			if (particle_emitter.descriptor == nullptr || particle_emitter.particles.num_alive == 0) {
+				continue;
+			}
+
+			TEXTURE_ASSET_ID sprite_id = particle_emitter.descriptor->sprite_id;
+			vec2 texture_dimension = texture_dimensions[(int)sprite_id];
+			vec4 uv_rect = texture_uv_rects[(int)sprite_id];
+			int& next = particle_page_runs[texture_atlas_pages[(int)sprite_id]];
+
+			int end = particle_emitter.particles.offset + particle_emitter.particles.num_alive;
+			for (int i = particle_emitter.particles.offset; i < end; i++) {
+				Transform transform;
+				transform.translate(vec2(position_x[i], position_y[i]));
+
+				vec2 trueScale = vec2(scale_x[i] * texture_dimension.x * PIXEL_SCALE_FACTOR,
+					scale_y[i] * texture_dimension.y * PIXEL_SCALE_FACTOR);
+				transform.scale(trueScale);
+
+				ParticleInfo& info = particle_info[next++];
+				info.transform_matrix = transform.mat;
+				info.color = vec4(color_r[i], color_g[i], color_b[i], color_a[i]);
+				info.uv_rect = uv_rect;
+			}
+		}
+	}
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+	gl_has_errors();
 
 	// Enable alpha
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -825,118 +1011,78 @@ void RenderSystem::drawParticles(const mat3& projection) {
 	// Use particle shader
 	const GLuint program = (GLuint)effects[(int)EFFECT_ASSET_ID::PARTICLE];
 	glUseProgram(program);
+	GLuint projection_loc = glGetUniformLocation(program, "projection");
+	glUniformMatrix3fv(projection_loc, 1, GL_FALSE, (float*)&projection);
+	glActiveTexture(GL_TEXTURE0);
 	gl_has_errors();
 
-	// Get and set vertex and index buffers
-	const GLuint vbo = vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE];
-	const GLuint ibo = index_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE];
+	// After the fill every run start has moved on to the next run's start, so the runs are walked from the front again
+	int first = 0;
+	for (int page = 0; page < (int)particle_page_runs.size(); page++) {
+		int count = particle_page_runs[page] - first;
+		if (count == 0) {
+			continue;
+		}
 
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-	gl_has_errors();
+		glBindTexture(GL_TEXTURE_2D, atlas_pages[page]);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-	// Set position and texcoord values
-	GLint in_position_loc = glGetAttribLocation(program, "in_position");
-	GLint in_texcoord_loc = glGetAttribLocation(program, "in_texcoord");
-	gl_has_errors();
-	assert(in_texcoord_loc >= 0);
+		setParticleInstanceOffset(frame_offset + (GLintptr)sizeof(ParticleInfo) * first);
+		glDrawElementsInstanced(GL_TRIANGLES, sprite_num_indices, GL_UNSIGNED_SHORT, nullptr, count);
+		gl_has_errors();
 
-	glEnableVertexAttribArray(in_position_loc);
-	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
-		sizeof(TexturedVertex), (void*)0);
-	gl_has_errors();
+		particle_draw_calls++;
+		particles_drawn += count;
+		first = particle_page_runs[page];
+	}
 
-	glEnableVertexAttribArray(in_texcoord_loc);
-	glVertexAttribPointer(
-		in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex),
-		(void*)sizeof(vec3)); // note the stride to skip the preceeding vertex position
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	gl_has_errors();
+}
 
-	
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); 
 
+// Make the texture when the map size changed, then upload the rect of tiles revealed since the last upload
+void RenderSystem::updateMinimapTexture(Minimap& minimap) {
+	if (minimap.map_size == 0) {
+		return;
+	}
 
-	for (ParticleEmitterContainer& particle_emitter_container : registry.particle_emitter_containers.components) { // Get Container
-		for (auto& pair : particle_emitter_container.particle_emitter_map) { // Get each particle_emitter from map
-			ParticleEmitter& particle_emitter = pair.second;
-			int num_alive_particles = 0;
+	if (minimap.is_resized || minimap_texture_size != minimap.map_size) {
+		if (minimap_texture == 0) {
+			glGenTextures(1, &minimap_texture);
+		}
+		glBindTexture(GL_TEXTURE_2D, minimap_texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, minimap.map_size, minimap.map_size, 0, GL_RED, GL_UNSIGNED_BYTE, minimap.revealed.data());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		gl_has_errors();
 
-			for (Particle particle : particle_emitter.particles) {
-				if (particle.lifetime > 0) {
-					num_alive_particles++;
-				}
-			}
+		minimap_texture_size = minimap.map_size;
+		minimap.is_resized = false;
+		minimap.clearDirty();
+		return;
+	}
 
-			if (num_alive_particles == 0) {
-				continue;
-			}
+	if (!minimap.isDirty()) {
+		return;
+	}
 
-            std::vector<ParticleInfo> particle_info(num_alive_particles);
-
-            int alive_index = 0;
-            for (const Particle& particle : particle_emitter.particles) {
-                if (particle.lifetime > 0) {
-                    Transform transform;
-                    transform.translate(particle.position);
-
-					vec2 texture_dimension = texture_dimensions[(int)particle_emitter.sprite_id];
-					vec2 trueScale = vec2(particle.scale.x * texture_dimension.x * PIXEL_SCALE_FACTOR,
-						particle.scale.y * texture_dimension.y * PIXEL_SCALE_FACTOR);
-					transform.scale(trueScale);
-
-
-					particle_info[alive_index].transform_matrix = transform.mat;
-					particle_info[alive_index].color = particle.color;
-                    alive_index++;
-                }
-            }
-
-            // Enabling and binding texture to slot 0
-            glActiveTexture(GL_TEXTURE0);
-            GLuint texture_id = texture_gl_handles[(GLuint)particle_emitter.sprite_id];
-            glBindTexture(GL_TEXTURE_2D, texture_id);
-            gl_has_errors();
-
-			transform_vbo = instance_buffers[(int)GEOMETRY_BUFFER_ID::PARTICLE];
-            glBindBuffer(GL_ARRAY_BUFFER, transform_vbo);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(ParticleInfo) * particle_info.size(), particle_info.data(), GL_DYNAMIC_DRAW);
-
-
-            GLint transform_loc = glGetAttribLocation(program, "in_transform_matrix");
-            for (int i = 0; i < 3; i++) {
-                glEnableVertexAttribArray(transform_loc + i);
-                glVertexAttribPointer(transform_loc + i, 3, GL_FLOAT, GL_FALSE, 
-                    sizeof(ParticleInfo), (void*)(sizeof(float) * 3 * i));
-                glVertexAttribDivisor(transform_loc + i, 1);
-            }
-
-            // Setup color attribute
-            GLint color_loc = glGetAttribLocation(program, "in_color");
-            glEnableVertexAttribArray(color_loc);
-            glVertexAttribPointer(color_loc, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInfo), (void*)(sizeof(float) * 3 * 3));
-            glVertexAttribDivisor(color_loc, 1);
-
-            GLuint projection_loc = glGetUniformLocation(program, "projection");
-            glUniformMatrix3fv(projection_loc, 1, GL_FALSE, (float*)&projection);
-
-            GLint size = 0;
-            glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
-            GLsizei num_indices = size / sizeof(uint16_t);
-            glDrawElementsInstanced(GL_TRIANGLES, num_indices, GL_UNSIGNED_SHORT, nullptr, num_alive_particles);
-            gl_has_errors();
-
-            // Reset attribute divisors
-            for (int i = 0; i < 3; i++) {
-                glVertexAttribDivisor(transform_loc + i, 0);
-            }
-            glVertexAttribDivisor(color_loc, 0);
-        }
-    }
+	// Rows of the rect are map_size apart in the revealed tiles
+	ivec2 size = minimap.dirty_max - minimap.dirty_min + 1;
+	glBindTexture(GL_TEXTURE_2D, minimap_texture);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, minimap.map_size);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, minimap.dirty_min.x, minimap.dirty_min.y, size.x, size.y, GL_RED, GL_UNSIGNED_BYTE,
+		minimap.revealed.data() + minimap.dirty_min.y * minimap.map_size + minimap.dirty_min.x);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	gl_has_errors();
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+	minimap.clearDirty();
 }
 
-
 void RenderSystem::drawMinimap() {
 	// Draw the Minimap
 	if (registry.minimaps.size() == 0) {
@@ -969,7 +1115,8 @@ void RenderSystem::drawMinimap() {
 	vec2 minimap_pos = vec2(minimap_transform.position);
 
 	// Get map size
-	vec2 MAP_SIZE = vec2(100, 100) * (float)TILE_SIZE; // HARD CODED MAP SIZE
+	Minimap& minimap = registry.minimaps.get(minimap_entity);
+	vec2 MAP_SIZE = vec2((float)max(minimap.map_size, 1)) * (float)TILE_SIZE;
 
 	// Get player position relative to map size (0-1)
 	vec2 relative_map_pos = vec2(
@@ -1039,9 +1186,7 @@ void RenderSystem::drawMinimap() {
 	gl_has_errors();
 
 	assert(registry.renderRequests.has(entity));
-	GLuint texture_id = texture_gl_handles[(GLuint)TEXTURE_ASSET_ID::PLAYER_ICON];
-
-	glBindTexture(GL_TEXTURE_2D, texture_id);
+	bindTexture(program, TEXTURE_ASSET_ID::PLAYER_ICON);
 	gl_has_errors();
 
 	// Getting uniform locations for glUniform* calls
@@ -1101,9 +1246,9 @@ void RenderSystem::drawPlayerHUD() {
 	);
 
 	Entity player_entity = registry.players.entities[0];
-	SpellSlotContainer player_spell_container = registry.spellSlotContainers.get(player_entity);
-	SpellSlot projectile_spell_slot = player_spell_container.spellSlots[0];
-	SpellSlot movement_spell_slot = player_spell_container.spellSlots[1];
+	SpellSlotContainer& player_spell_container = registry.spellSlotContainers.get(player_entity);
+	SpellSlot& projectile_spell_slot = player_spell_container.spellSlots[0];
+	SpellSlot& movement_spell_slot = player_spell_container.spellSlots[1];
 
 	ProjectileSpell* projectile_spell = projectile_spells[(int)projectile_spell_slot.spell_id];
 	TEXTURE_ASSET_ID projectile_spell_id = projectile_spell->getAssetID();
@@ -1204,6 +1349,20 @@ std::string getGoalText(GoalManager goal_manager, FloorGoal goal) {
 	return "Error: Invalid goal type";
 }
 
+void RenderSystem::drawProfilerOverlay(const mat3& projection) {
+	const std::vector<std::string>& lines = profiler.getOverlayLines();
+
+	Transform transform;
+	transform.translate(vec2(WINDOW_WIDTH_PX - 20, 40));
+	transform.scale(vec2(0.3));
+
+	vec3 text_color = vec3(1.0f, 1.0f, 0.6f);
+	for (const std::string& line : lines) {
+		drawText(line, text_color, transform, projection, 1.0f, TEXT_PIVOT::RIGHT);
+		transform.translate(vec2(0, 60));
+	}
+}
+
 void RenderSystem::drawFloorGoals(const mat3 projection) {
 	GoalManager& goal_manager = registry.goalManagers.components[0];
 
@@ -1307,8 +1466,7 @@ void RenderSystem::drawHealthPlayerBar() {
 
 	// Enabling and binding texture to slot 0
 	glActiveTexture(GL_TEXTURE0);
-	GLuint texture_id = texture_gl_handles[(GLuint)TEXTURE_ASSET_ID::HEALTH_BAR_BOTTOM];
-	glBindTexture(GL_TEXTURE_2D, texture_id);
+	bindTexture(program, TEXTURE_ASSET_ID::HEALTH_BAR_BOTTOM);
 	gl_has_errors();
 
 	// Get number of indices from index buffer, which has elements uint16_t
@@ -1384,8 +1542,7 @@ void RenderSystem::drawHealthPlayerBar() {
 
 	// Enabling and binding texture to slot 0
 	glActiveTexture(GL_TEXTURE0);
-	texture_id = texture_gl_handles[(GLuint)TEXTURE_ASSET_ID::HEALTH_BAR_FILL];
-	glBindTexture(GL_TEXTURE_2D, texture_id);
+	bindTexture(program, TEXTURE_ASSET_ID::HEALTH_BAR_FILL);
 	gl_has_errors();
 
 	// Get number of indices from index buffer, which has elements uint16_t
@@ -1464,8 +1621,7 @@ void RenderSystem::drawHealthPlayerBar() {
 
 	// Enabling and binding texture to slot 0
 	glActiveTexture(GL_TEXTURE0);
-	texture_id = texture_gl_handles[(GLuint)TEXTURE_ASSET_ID::HEART_CONTAINER];
-	glBindTexture(GL_TEXTURE_2D, texture_id);
+	bindTexture(program, TEXTURE_ASSET_ID::HEART_CONTAINER);
 	gl_has_errors();
 
 	// Get number of indices from index buffer, which has elements uint16_t
@@ -1546,8 +1702,7 @@ void RenderSystem::drawSpellUI(TEXTURE_ASSET_ID asset_id, vec2 screen_position)
 
 	// Enabling and binding texture to slot 0
 	glActiveTexture(GL_TEXTURE0);
-	GLuint texture_id = texture_gl_handles[(GLuint)TEXTURE_ASSET_ID::SPELL_CONTAINER_UI];
-	glBindTexture(GL_TEXTURE_2D, texture_id);
+	bindTexture(program, TEXTURE_ASSET_ID::SPELL_CONTAINER_UI);
 	gl_has_errors();
 
 	// Get number of indices from index buffer, which has elements uint16_t
@@ -1628,8 +1783,7 @@ void RenderSystem::drawSpellUI(TEXTURE_ASSET_ID asset_id, vec2 screen_position)
 
 	// Enabling and binding texture to slot 0
 	glActiveTexture(GL_TEXTURE0);
-	texture_id = texture_gl_handles[(GLuint)asset_id];
-	glBindTexture(GL_TEXTURE_2D, texture_id);
+	bindTexture(program, (TEXTURE_ASSET_ID)asset_id);
 	gl_has_errors();
 
 	// Get number of indices from index buffer, which has elements uint16_t
@@ -1674,18 +1828,53 @@ void RenderSystem::drawText(std::string text, const glm::vec3& color, Transform
 		glGetUniformLocation(program, "projection");
 	glUniformMatrix3fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
 
+	const std::vector<vec4>& vertices = getTextLayout(text, pivot);
+	if (vertices.empty()) {
+		return;
+	}
+
 	glBindVertexArray(m_font_VAO);
 	gl_has_errors();
-	
+
+	// all glyphs are in the font atlas
+	glBindTexture(GL_TEXTURE_2D, m_font_texture);
+	gl_has_errors();
+
+	// upload the whole string and draw it in one go
+	const GLuint vbo = vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::FONT];
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vec4) * vertices.size(), vertices.data(), GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	gl_has_errors();
+
+	glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertices.size());
+	gl_has_errors();
+
+	glBindVertexArray(m_vao);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	gl_has_errors();
+}
+
+const std::vector<vec4>& RenderSystem::getTextLayout(const std::string& text, TEXT_PIVOT pivot)
+{
+	std::string key = (char)pivot + text;
+	auto it = text_layouts.find(key);
+	if (it != text_layouts.end()) {
+		return it->second;
+	}
+
+	if (text_layouts.size() >= MAX_TEXT_LAYOUTS) {
+		text_layouts.clear();
+	}
+	std::vector<vec4>& vertices = text_layouts[key];
+	vertices.reserve(text.size() * 6);
+
 	// Get the width of the entire word
 	float text_width = 0;
-
-	std::string::const_iterator c1;
-	for (c1 = text.begin(); c1 != text.end(); c1++)
+	for (char c : text)
 	{
-		Character ch = m_ftCharacters[*c1];
-
-		text_width += (ch.Advance >> 6);
+		if ((unsigned char)c >= NUM_FONT_CHARACTERS) continue;
+		text_width += (m_ftCharacters[c].Advance >> 6);
 	}
 
 	float offset = 0;
@@ -1702,50 +1891,39 @@ void RenderSystem::drawText(std::string text, const glm::vec3& color, Transform
 	float x = offset;
 	float y = 0;
 	// iterate through all characters
-	std::string::const_iterator c;
-	for (c = text.begin(); c != text.end(); c++)
+	for (char c : text)
 	{
-		Character ch = m_ftCharacters[*c];
+		// chars we have no glyph for take no space, same as before the atlas
+		if ((unsigned char)c >= NUM_FONT_CHARACTERS) continue;
+		const Character& ch = m_ftCharacters[c];
 
 		float xpos = x + ch.Bearing.x;
 		float ypos = y + (ch.Size.y - ch.Bearing.y);
 
 		float w = ch.Size.x;
 		float h = ch.Size.y;
-		// update VBO for each character
-		float vertices[6][4] = {
-			{ xpos,     ypos + h,   0.0f, 0.0f },
-			{ xpos,     ypos,       0.0f, 1.0f },
-			{ xpos + w, ypos,       1.0f, 1.0f },
-
-			{ xpos, ypos + h, 0.0f, 0.0f },
-			{ xpos + w, ypos,       1.0f, 1.0f },
-			{ xpos + w, ypos + h,   1.0f, 0.0f }
-		};
-
-		// render glyph texture over quad
-		glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-		// std::cout << "binding texture: " << ch.character << " = " << ch.TextureID << std::endl;
-		gl_has_errors();
 
-		// update content of VBO memory
-		const GLuint vbo = vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::FONT];
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		gl_has_errors();
+		// texcoords of the glyph in the atlas
+		float u0 = ch.UVRect.x;
+		float v0 = ch.UVRect.y;
+		float u1 = ch.UVRect.x + ch.UVRect.z;
+		float v1 = ch.UVRect.y + ch.UVRect.w;
 
-		// render quad
-		glDrawArrays(GL_TRIANGLES, 0, 6);
-		gl_has_errors();
+		if (w > 0 && h > 0) {
+			vertices.push_back({ xpos,     ypos + h,   u0, v0 });
+			vertices.push_back({ xpos,     ypos,       u0, v1 });
+			vertices.push_back({ xpos + w, ypos,       u1, v1 });
+
+			vertices.push_back({ xpos,     ypos + h,   u0, v0 });
+			vertices.push_back({ xpos + w, ypos,       u1, v1 });
+			vertices.push_back({ xpos + w, ypos + h,   u1, v0 });
+		}
 
 		// now advance cursors for next glyph (note that advance is number of 1/64 pixels)
 		x += (ch.Advance >> 6); // bitshift by 6 to get value in pixels (2^6 = 64)
 	}
 
-	glBindVertexArray(m_vao);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	gl_has_errors();
+	return vertices;
 }
 
 
@@ -1761,12 +1939,24 @@ void RenderSystem::drawText(std::string text, const glm::vec3& color, Transform
 // http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-14-render-to-texture/
 void RenderSystem::draw(GAME_SCREEN_ID game_screen)
 {
+	if (is_headless) {
+		return;
+	}
+
 	// Getting size of window
 	int w, h;
 
 
 	glfwGetFramebufferSize(window, &w, &h); // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
 
+	tile_bytes_uploaded = 0;
+	tile_chunks_drawn = 0;
+	tile_instances_drawn = 0;
+	sprite_draw_calls = 0;
+	sprites_drawn = 0;
+	particle_draw_calls = 0;
+	particles_drawn = 0;
+
 	// First render to the custom framebuffer
 	glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
 	gl_has_errors();
@@ -1808,6 +1998,9 @@ void RenderSystem::draw(GAME_SCREEN_ID game_screen)
 	drawParticles(projection_2D);
 
 
+	// Decor, shadows, y-sorted entities and projectiles all go through the sprite batch
+	beginSpriteBatch(projection_2D);
+
 	for (Entity entity : registry.floorDecors.entities) {
 		if (isFrustumCulled(entity)) {
 			continue;
@@ -1901,6 +2094,8 @@ void RenderSystem::draw(GAME_SCREEN_ID game_screen)
 		drawTexturedMesh(entity, projection_2D);
 	}
 
+	endSpriteBatch();
+
 	// NEW
 	// Mark: In intro screen 
 	// DO NOT DRAW PLAYER UI IN INTRO, OR DURING CUTSCENES
@@ -2019,6 +2214,12 @@ void RenderSystem::draw(GAME_SCREEN_ID game_screen)
 			drawTexturedMesh(block_entity, screen_2D);
 		}
 	}
+
+	// Profiler overlay goes over everything, including the fade and the pause screen
+	if (profiler.is_overlay_enabled) {
+		glEnable(GL_BLEND);
+		drawProfilerOverlay(screen_2D);
+	}
 	
 	// flicker-free display with a double buffer
 	glfwSwapBuffers(window);
@@ -2202,6 +2403,7 @@ bool RenderSystem::isFrustumCulled(Entity entity) {
 
 // Sorts and returns a vector of entities based on the y position of the bottom of their sprite
 std::vector<Entity> RenderSystem::ySort(std::vector<Entity> entities) {
+	PROFILE_SCOPE("ySort");
 	
 	// Munn: just using built in sort with a lambda function - apparently std::sort generally runs in O(nlog(n)), hooray!
 	// https://stackoverflow.com/questions/1840121/which-type-of-sorting-is-used-in-the-stdsort
@@ -3,6 +3,7 @@
 #include <array>
 #include <utility>
 #include <map>
+#include <unordered_map>
 
 #include "common.hpp"
 #include "tinyECS/components.hpp"
@@ -19,8 +20,13 @@ class RenderSystem {
 	 * Whenever possible, add to these lists instead of creating dynamic state
 	 * it is easier to debug and faster to execute for the computer.
 	 */
-	std::array<GLuint, texture_count> texture_gl_handles;
-	std::array<ivec2, texture_count>  texture_dimensions;
+	std::array<GLuint, texture_count> texture_gl_handles;	// the atlas page each texture was packed into
+	std::array<ivec2, texture_count>  texture_dimensions;	// size of the original image
+	std::array<vec4, texture_count>   texture_uv_rects;	// where on its page the texture is, xy offset and zw size
+	std::array<int, texture_count>    texture_atlas_pages;	// index of the page in atlas_pages
+	std::vector<GLuint> atlas_pages;
+	const int ATLAS_PAGE_SIZE = 2048;
+	const int FONT_ATLAS_SIZE = 1024;
 
 	// Make sure these paths remain in sync with the associated enumerators.
 	// Associated id with .obj path
@@ -155,6 +161,7 @@ class RenderSystem {
 		shader_path("tile"),
 		shader_path("font"),
 		shader_path("minimap"),
+		shader_path("sprite"),
 	};
 
 	std::array<GLuint, geometry_count> vertex_buffers;
@@ -163,16 +170,69 @@ class RenderSystem {
 	std::array<Mesh, geometry_count> meshes;
 
 private:
-	GLuint transform_vbo = 0;
 	GLuint color_vbo = 0;
 
 	GLuint m_vao;
 
+	// Instance data for one layer of tiles (floors or walls). Tiles don't move once the level is created,
+	// so the instance buffer is only filled in when the level changes and drawing just binds the vao.
+	// The layer is split into square chunks of tiles, each one a range of the instance buffer with its bounds,
+	// so only the chunks the camera can see are drawn.
+	struct TileChunk {
+		vec2 min;
+		vec2 max;
+		GLint first_instance;
+		GLsizei instance_count;
+	};
+	struct TileLayer {
+		GLuint vao = 0;
+		GLuint instance_vbo = 0;
+		GLsizei instance_count = 0;
+		GLsizei num_indices = 0;
+		std::vector<TileChunk> chunks;	// in row order
+	};
+	const int TILE_CHUNK_SIZE = 8;	// in tiles
+	const GLint TILE_INSTANCE_ATTRIB_LOC = 2;	// instance_matrix takes 2-4, in_tilecoord 5
+	TileLayer floor_layer;
+	TileLayer wall_layer;
+	bool tile_layers_dirty = true;
+
+	// Sprites drawn with the TEXTURED or ANIMATED effect between beginSpriteBatch and endSpriteBatch are collected
+	// here and drawn instanced, one draw call per run of sprites sharing an atlas page. Any other draw flushes the
+	// batch first, so the draw order (ySort) is kept.
+	std::vector<SpriteInfo> sprite_batch;
+	GLuint sprite_batch_texture = 0;	// atlas page of the current run
+	mat3 sprite_batch_projection;
+	bool is_sprite_batching = false;
+	GLuint sprite_vao = 0;
+	GLsizei sprite_num_indices = 0;
+
+	// The particles of every emitter are written into one streaming instance buffer, grouped by atlas page, and drawn
+	// with one instanced call per page. The buffer is used as a ring, each frame goes after the previous one so it
+	// can be written without waiting for the gpu, and it is orphaned once it wraps around.
+	const int PARTICLE_RING_FRAMES = 3;	// frames that fit in the buffer before it is orphaned
+	const int INITIAL_PARTICLES_PER_FRAME = 4096;
+	GLuint particle_vao = 0;
+	GLuint particle_instance_vbo = 0;
+	GLsizeiptr particle_buffer_size = 0;	// in bytes
+	GLsizeiptr particle_buffer_head = 0;	// where the next frame's particles go
+	std::vector<int> particle_page_runs;	// per atlas page, the number of particles and then where its run starts
+
+	// Revealed tiles of the minimap, one byte per tile. Only the rect of tiles revealed since the last frame is uploaded
+	GLuint minimap_texture = 0;
+	int minimap_texture_size = 0;	// in tiles
+
 public:
 
 	// Initialize the window
 	bool init(GLFWwindow* window);
 
+	// Null backend for running the simulation without a display, no window or OpenGL is touched.
+	// Only what the game logic reads from the renderer is set up (texture sizes from the image headers, the screen state),
+	// meshes stay empty and draw does nothing
+	bool initHeadless();
+	bool isHeadless() const { return is_headless; }
+
 	template <class T>
 	void bindVBOandIBO(GEOMETRY_BUFFER_ID gid, std::vector<T> vertices, std::vector<uint16_t> indices);
 
@@ -190,6 +250,9 @@ public:
 
 	void initializeGlGeometryBuffers();
 
+	void initializeSpriteBatch();
+	void initializeParticleBatch();
+
 	// Initialize the screen texture used as intermediate render target
 	// The draw loop first renders to this texture, then it is used for the vignette shader
 	bool initScreenTexture();
@@ -205,6 +268,21 @@ public:
 
 	Entity get_screen_state_entity() { return screen_state_entity; }
 
+	// The floor/wall instance buffers are rebuilt on the next draw, call whenever the level's tiles change
+	void invalidateTileLayers() { tile_layers_dirty = true; }
+
+	// Bytes of tile instance data sent to the gpu during the last draw, 0 unless the level changed
+	size_t tile_bytes_uploaded = 0;
+	// Tile chunks and tile instances that passed the camera culling during the last draw
+	int tile_chunks_drawn = 0;
+	int tile_instances_drawn = 0;
+	// Draw calls issued by the sprite batch and the sprites they covered (before batching, one draw call per sprite)
+	int sprite_draw_calls = 0;
+	int sprites_drawn = 0;
+	// Draw calls issued for particles (one per atlas page with particles on it) and the particles drawn
+	int particle_draw_calls = 0;
+	int particles_drawn = 0;
+
 	// Guo: physics_system needs to get texture dimensions for correct bounding box
 	ivec2 getTextureDimensions(int texture_id) { 
 		return texture_dimensions[texture_id]; 
@@ -212,7 +290,9 @@ public:
 
 private:
 	// Internal drawing functions for each entity type
-	void drawTiles(std::vector<Entity> entities, TEXTURE_ASSET_ID texture_asset_id, const mat3& projection);
+	void buildTileLayer(TileLayer& layer, const std::vector<Entity>& entities, TEXTURE_ASSET_ID texture_asset_id);
+	void setTileInstanceOffset(GLint first_instance);
+	void drawTiles(const TileLayer& layer, TEXTURE_ASSET_ID texture_asset_id, vec2 num_tiles, const mat3& projection);
 
 	void drawEnvironment(const mat3& projection);
 	void drawGridLine(Entity entity, const mat3& projection);
@@ -224,9 +304,18 @@ private:
                                         vec3 color, float offsetX, float offsetY, float depth,
                                         GLuint program, const mat3& projection);
 	void drawParticles(const mat3& projection);
+	void setParticleInstanceOffset(GLintptr offset);
 
 	void drawIconOnInteractable(Entity entity, const mat3& projection);
 
+	void bindTexture(GLuint program, TEXTURE_ASSET_ID texture_asset_id);
+
+	bool isSpriteBatchable(const RenderRequest& render_request);
+	void beginSpriteBatch(const mat3& projection);
+	void endSpriteBatch();
+	void batchSprite(TEXTURE_ASSET_ID texture_asset_id, const mat3& transform, vec3 color, vec4 frame);
+	void flushSprites();
+
 	void drawShadow(Entity entity, const mat3& projection);
 	void drawWithShadow(Entity entity, const mat3& projection);
 
@@ -235,15 +324,26 @@ private:
 	void drawHealthPlayerBar();
 	void drawSpellUI(TEXTURE_ASSET_ID asset_id, vec2 screen_position);
 	void drawMinimap();
+	void updateMinimapTexture(Minimap& minimap);
+	void drawProfilerOverlay(const mat3& projection);
 
 	void drawText(std::string text, const glm::vec3& color, Transform trans, const glm::mat3& projection, float alpha = 1.0f, TEXT_PIVOT pivot = TEXT_PIVOT::LEFT);
-	std::map<char, Character> m_ftCharacters;
+	static const int NUM_FONT_CHARACTERS = 128;	// only the ASCII chars are loaded
+	std::array<Character, NUM_FONT_CHARACTERS> m_ftCharacters;
+	GLuint m_font_texture = 0;	// every glyph packed into one atlas
+
+	// Glyph quads of a string (6 vertices per glyph, xy position and zw texcoord), they only depend on the
+	// text and the pivot so they are built once and reused while the string stays the same
+	const std::vector<vec4>& getTextLayout(const std::string& text, TEXT_PIVOT pivot);
+	std::unordered_map<std::string, std::vector<vec4>> text_layouts;	// key is the pivot followed by the text
+	const size_t MAX_TEXT_LAYOUTS = 1024;	// the cache is emptied when it gets this big, timers and counters make new strings every frame
 
 	std::vector<Entity> ySort(std::vector<Entity> entities);
 	bool isFrustumCulled(Entity entity);
 
 	// Window handle
 	GLFWwindow* window;
+	bool is_headless = false;
 
 	// Screen texture handles
 	GLuint frame_buffer;
@@ -7,6 +7,7 @@
 // internal
 #include "../ext/stb_image/stb_image.h"
 #include "render_system.hpp"
+#include "texture_atlas.hpp"
 #include "tinyECS/registry.hpp"
 
 // Fonts
@@ -65,6 +66,8 @@ bool RenderSystem::init(GLFWwindow* window_arg)
     initializeGlTextures();
 	initializeGlEffects();
 	initializeGlGeometryBuffers();
+	initializeSpriteBatch();
+	initializeParticleBatch();
 
 	std::string font_filename = get_base_path() + "data/fonts/Kenney_Pixel_Square.ttf";
 	unsigned int font_default_size = FONT_SIZE;
@@ -74,31 +77,89 @@ bool RenderSystem::init(GLFWwindow* window_arg)
 	return true;
 }
 
+// Headless init for the scenario runner: no window or GL context, only the state the game logic reads
+bool RenderSystem::initHeadless()
+{
+	is_headless = true;
+	window = nullptr;
+
+	// create a single entry
+	registry.screenStates.emplace(screen_state_entity);
+
+	// Hitboxes are sized from the textures, so read the dimensions without decoding the images
+	for (uint i = 0; i < texture_paths.size(); i++)
+	{
+		const std::string& path = texture_paths[i];
+		ivec2& dimensions = texture_dimensions[i];
+		if (!stbi_info(path.c_str(), &dimensions.x, &dimensions.y, NULL))
+		{
+			const std::string message = "Could not load the file " + path + ".";
+			fprintf(stderr, "%s", message.c_str());
+			assert(false);
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void RenderSystem::initializeGlTextures()
 {
-    glGenTextures((GLsizei)texture_gl_handles.size(), texture_gl_handles.data());
+	// Load every image first, they are packed into atlas pages together
+	std::vector<stbi_uc*> images(texture_paths.size());
+	std::vector<ivec2> sizes(texture_paths.size());
 
     for(uint i = 0; i < texture_paths.size(); i++)
     {
 		const std::string& path = texture_paths[i];
 		ivec2& dimensions = texture_dimensions[i];
 
-		stbi_uc* data;
-		data = stbi_load(path.c_str(), &dimensions.x, &dimensions.y, NULL, 4);
+		images[i] = stbi_load(path.c_str(), &dimensions.x, &dimensions.y, NULL, 4);
 
-		if (data == NULL)
+		if (images[i] == NULL)
 		{
 			const std::string message = "Could not load the file " + path + ".";
 			fprintf(stderr, "%s", message.c_str());
 			assert(false);
 		}
-		glBindTexture(GL_TEXTURE_2D, texture_gl_handles[i]);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, dimensions.x, dimensions.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		gl_has_errors();
-		stbi_image_free(data);
+		sizes[i] = dimensions;
     }
+
+	// Pages as big as the driver allows, but no bigger than needed for our ~70 small sheets
+	GLint max_texture_size = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+	TextureAtlas atlas(std::min(max_texture_size, ATLAS_PAGE_SIZE));
+	atlas.pack(sizes);
+
+	atlas_pages.resize(atlas.numPages());
+	glGenTextures((GLsizei)atlas_pages.size(), atlas_pages.data());
+
+	for (int page = 0; page < atlas.numPages(); page++) {
+		ivec2 page_size = atlas.pageSize(page);
+		std::vector<unsigned char> pixels(4 * page_size.x * page_size.y, 0);
+
+		for (uint i = 0; i < texture_paths.size(); i++) {
+			if (atlas.getRects()[i].page == page) {
+				atlas.copyImage(i, images[i], pixels);
+			}
+		}
+
+		glBindTexture(GL_TEXTURE_2D, atlas_pages[page]);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, page_size.x, page_size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		gl_has_errors();
+	}
+
+	// Every texture id now points at its page, plus where on the page it is
+	for (uint i = 0; i < texture_paths.size(); i++) {
+		texture_gl_handles[i] = atlas_pages[atlas.getRects()[i].page];
+		texture_uv_rects[i] = atlas.getUVRect(i);
+		texture_atlas_pages[i] = atlas.getRects()[i].page;
+		stbi_image_free(images[i]);
+	}
 	gl_has_errors();
 }
 
@@ -180,8 +241,12 @@ void RenderSystem::initializeFonts(GLFWwindow* window, const std::string& font_f
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
 	// load each of the chars - note only first 128 ASCII chars
-	for (unsigned char c = (unsigned char)0; c < (unsigned char)128; c++)
+	std::vector<std::vector<unsigned char>> bitmaps(NUM_FONT_CHARACTERS);
+	std::vector<ivec2> sizes(NUM_FONT_CHARACTERS, ivec2(0));
+	for (int c = 0; c < NUM_FONT_CHARACTERS; c++)
 	{
+		m_ftCharacters[c] = { 0, ivec2(0), ivec2(0), 0, (char)c, vec4(0) };
+
 		// load character glyph 
 		if (FT_Load_Char(face, c, FT_LOAD_RENDER))
 		{
@@ -189,43 +254,51 @@ void RenderSystem::initializeFonts(GLFWwindow* window, const std::string& font_f
 			continue;
 		}
 
-		// generate texture
-		unsigned int texture;
-		glGenTextures(1, &texture);
-		glBindTexture(GL_TEXTURE_2D, texture);
-		gl_has_errors();
-
-		// std::cout << "texture: " << c << " = " << texture << std::endl;
-
-		glTexImage2D(
-			GL_TEXTURE_2D,
-			0,
-			GL_RED,
-			face->glyph->bitmap.width,
-			face->glyph->bitmap.rows,
-			0,
-			GL_RED,
-			GL_UNSIGNED_BYTE,
-			face->glyph->bitmap.buffer
-		);
-		gl_has_errors();
-
-		// set texture options
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		gl_has_errors();
+		// keep a tightly packed copy of the bitmap, the glyph slot is reused by the next char
+		const FT_Bitmap& bitmap = face->glyph->bitmap;
+		sizes[c] = ivec2(bitmap.width, bitmap.rows);
+		bitmaps[c].resize(bitmap.width * bitmap.rows);
+		for (unsigned int row = 0; row < bitmap.rows; row++) {
+			std::copy(bitmap.buffer + row * bitmap.pitch, bitmap.buffer + row * bitmap.pitch + bitmap.width, bitmaps[c].begin() + row * bitmap.width);
+		}
 
 		// now store character for later use
-		Character character = {
-			texture,
+		m_ftCharacters[c] = {
+			0,
 			glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
 			glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
 			static_cast<unsigned int>(face->glyph->advance.x),
-			(char)c
+			(char)c,
+			vec4(0)
 		};
-		m_ftCharacters.insert(std::pair<char, Character>(c, character));
+	}
+
+	// Pack all the glyphs into one texture, so a whole string is a single draw
+	TextureAtlas atlas(FONT_ATLAS_SIZE);
+	atlas.pack(sizes);
+	assert(atlas.numPages() == 1 && "Font does not fit in a single atlas page");
+
+	ivec2 atlas_size = atlas.pageSize(0);
+	std::vector<unsigned char> pixels(atlas_size.x * atlas_size.y, 0);
+	for (int c = 0; c < NUM_FONT_CHARACTERS; c++) {
+		atlas.copyImage(c, bitmaps[c].data(), pixels, 1);
+	}
+
+	glGenTextures(1, &m_font_texture);
+	glBindTexture(GL_TEXTURE_2D, m_font_texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, atlas_size.x, atlas_size.y, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+	gl_has_errors();
+
+	// set texture options
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	gl_has_errors();
+
+	for (int c = 0; c < NUM_FONT_CHARACTERS; c++) {
+		m_ftCharacters[c].TextureID = m_font_texture;
+		m_ftCharacters[c].UVRect = atlas.getUVRect(c);
 	}
 	glBindTexture(GL_TEXTURE_2D, 0);
 	gl_has_errors();
@@ -242,8 +315,6 @@ void RenderSystem::initializeFonts(GLFWwindow* window, const std::string& font_f
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
 	gl_has_errors();
 
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-	gl_has_errors();
 
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
@@ -446,17 +517,109 @@ void RenderSystem::initializeGlGeometryBuffers()
 
 }
 
+// The sprite batch draws the shared sprite quad once per instance, its vao keeps all the attribute bindings
+void RenderSystem::initializeSpriteBatch()
+{
+	glGenVertexArrays(1, &sprite_vao);
+	glBindVertexArray(sprite_vao);
+	gl_has_errors();
+
+	glBindBuffer(GL_ARRAY_BUFFER, vertex_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE]);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE]);
+
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)sizeof(vec3));
+	gl_has_errors();
+
+	// Per instance: transform (as 3 vec3s) at 2-4, color at 5, frame at 6, atlas rect at 7, see sprite.vs.glsl
+	glBindBuffer(GL_ARRAY_BUFFER, instance_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE]);
+	for (int i = 0; i < 3; i++) {
+		glEnableVertexAttribArray(2 + i);
+		glVertexAttribPointer(2 + i, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteInfo), (void*)(offsetof(SpriteInfo, transform_matrix) + i * sizeof(vec3)));
+		glVertexAttribDivisor(2 + i, 1);
+	}
+	glEnableVertexAttribArray(5);
+	glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteInfo), (void*)offsetof(SpriteInfo, color));
+	glVertexAttribDivisor(5, 1);
+	glEnableVertexAttribArray(6);
+	glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInfo), (void*)offsetof(SpriteInfo, frame));
+	glVertexAttribDivisor(6, 1);
+	glEnableVertexAttribArray(7);
+	glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInfo), (void*)offsetof(SpriteInfo, uv_rect));
+	glVertexAttribDivisor(7, 1);
+	gl_has_errors();
+
+	GLint size = 0;
+	glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+	sprite_num_indices = size / sizeof(uint16_t);
+
+	glBindVertexArray(m_vao);
+	gl_has_errors();
+}
+
+// Particles draw the same sprite quad, from their own streaming instance buffer
+void RenderSystem::initializeParticleBatch()
+{
+	glGenVertexArrays(1, &particle_vao);
+	glBindVertexArray(particle_vao);
+	gl_has_errors();
+
+	glBindBuffer(GL_ARRAY_BUFFER, vertex_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE]);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffers[(int)GEOMETRY_BUFFER_ID::SPRITE]);
+
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)sizeof(vec3));
+	gl_has_errors();
+
+	// Per instance: transform (as 3 vec3s) at 2-4, color at 5, atlas rect at 6, see particle.vs.glsl.
+	// The pointers are set for every draw (setParticleInstanceOffset), only the divisors are kept here
+	particle_buffer_size = (GLsizeiptr)sizeof(ParticleInfo) * INITIAL_PARTICLES_PER_FRAME * PARTICLE_RING_FRAMES;
+	glGenBuffers(1, &particle_instance_vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, particle_instance_vbo);
+	glBufferData(GL_ARRAY_BUFFER, particle_buffer_size, nullptr, GL_STREAM_DRAW);
+	for (int i = 2; i <= 6; i++) {
+		glEnableVertexAttribArray(i);
+		glVertexAttribDivisor(i, 1);
+	}
+	setParticleInstanceOffset(0);
+	gl_has_errors();
+
+	glBindVertexArray(m_vao);
+	gl_has_errors();
+}
+
 
 
 
 
 RenderSystem::~RenderSystem()
 {
+	// Nothing was created on the gpu
+	if (is_headless) {
+		while (registry.renderRequests.entities.size() > 0)
+			registry.remove_all_components_of(registry.renderRequests.entities.back());
+		return;
+	}
+
 	// Don't need to free gl resources since they last for as long as the program,
 	// but it's polite to clean after yourself.
 	glDeleteBuffers((GLsizei)vertex_buffers.size(), vertex_buffers.data());
 	glDeleteBuffers((GLsizei)index_buffers.size(), index_buffers.data());
-	glDeleteTextures((GLsizei)texture_gl_handles.size(), texture_gl_handles.data());
+	glDeleteBuffers((GLsizei)instance_buffers.size(), instance_buffers.data());
+	glDeleteBuffers(1, &floor_layer.instance_vbo);
+	glDeleteBuffers(1, &wall_layer.instance_vbo);
+	glDeleteVertexArrays(1, &floor_layer.vao);
+	glDeleteVertexArrays(1, &wall_layer.vao);
+	glDeleteVertexArrays(1, &sprite_vao);
+	glDeleteVertexArrays(1, &particle_vao);
+	glDeleteBuffers(1, &particle_instance_vbo);
+	glDeleteTextures(1, &m_font_texture);
+	glDeleteTextures(1, &minimap_texture);
+	glDeleteTextures((GLsizei)atlas_pages.size(), atlas_pages.data());
 	glDeleteTextures(1, &off_screen_render_buffer_color);
 	glDeleteRenderbuffers(1, &off_screen_render_buffer_depth);
 	gl_has_errors();
@@ -0,0 +1,284 @@
+#include "spatial_index.hpp"
+
+#include <cmath>
+
+SpatialIndex spatial_index;
+
+// Anything further out than MAX_CELL_COORD cells shares the cells on the edge, so one stray entity can't blow up the grid
+ivec2 SpatialIndex::cellOf(vec2 point) const
+{
+	// NaN gets through the clamp and turns into INT_MIN, park it in cell 0 instead
+	if (glm::any(glm::isnan(point))) {
+		return ivec2(0);
+	}
+	vec2 cell = glm::clamp(glm::floor(point / cell_size), vec2(-MAX_CELL_COORD), vec2(MAX_CELL_COORD));
+	return ivec2(cell);
+}
+
+// Make the grid cover cell too, with room to spare on that side so walking off the edge doesn't regrow it every step
+void SpatialIndex::growGrid(ivec2 cell)
+{
+	ivec2 new_min = grid_min;
+	ivec2 new_max = grid_max;
+	if (grid.empty()) {
+		new_min = cell - ivec2(8);
+		new_max = cell + ivec2(8);
+	}
+	else {
+		ivec2 size = grid_max - grid_min + 1;
+		if (cell.x < new_min.x) new_min.x = glm::min(cell.x, grid_min.x - size.x);
+		if (cell.y < new_min.y) new_min.y = glm::min(cell.y, grid_min.y - size.y);
+		if (cell.x > new_max.x) new_max.x = glm::max(cell.x, grid_max.x + size.x);
+		if (cell.y > new_max.y) new_max.y = glm::max(cell.y, grid_max.y + size.y);
+	}
+	// cellOf never gives anything outside of this, so the grid doesn't need to either
+	new_min = glm::max(new_min, ivec2(-MAX_CELL_COORD));
+	new_max = glm::min(new_max, ivec2(MAX_CELL_COORD));
+
+	grid_min = new_min;
+	grid_max = new_max;
+	int width = grid_max.x - grid_min.x + 1;
+	grid.assign((size_t)width * (grid_max.y - grid_min.y + 1), -1);
+	for (int cell_index = 0; cell_index < (int)cells.size(); cell_index++) {
+		ivec2 coord = cells[cell_index].coord;
+		grid[(coord.y - grid_min.y) * width + (coord.x - grid_min.x)] = cell_index;
+	}
+}
+
+int SpatialIndex::getOrCreateCell(ivec2 cell)
+{
+	int cell_index = findCell(cell);
+	if (cell_index != -1) {
+		return cell_index;
+	}
+
+	if (grid.empty() || cell.x < grid_min.x || cell.y < grid_min.y || cell.x > grid_max.x || cell.y > grid_max.y) {
+		growGrid(cell);
+	}
+
+	cell_index = (int)cells.size();
+	cells.push_back({ cell, {} });
+	grid[(cell.y - grid_min.y) * (grid_max.x - grid_min.x + 1) + (cell.x - grid_min.x)] = cell_index;
+
+	if (cells.size() == 1) {
+		cells_min = cell;
+		cells_max = cell;
+	}
+	else {
+		cells_min = glm::min(cells_min, cell);
+		cells_max = glm::max(cells_max, cell);
+	}
+	return cell_index;
+}
+
+void SpatialIndex::addToCell(int entry_index, int cell_index)
+{
+	Entry& entry = entries[entry_index];
+	std::vector<int>& cell_entries = cells[cell_index].entries;
+	entry.cell = cell_index;
+	entry.slot = (int)cell_entries.size();
+	cell_entries.push_back(entry_index);
+}
+
+void SpatialIndex::removeFromCell(int entry_index)
+{
+	Entry& entry = entries[entry_index];
+	std::vector<int>& cell_entries = cells[entry.cell].entries;
+
+	// The last one of the cell takes its slot
+	int last = cell_entries.back();
+	cell_entries[entry.slot] = last;
+	entries[last].slot = entry.slot;
+	cell_entries.pop_back();
+	entry.cell = -1;
+}
+
+void SpatialIndex::update(Entity entity, vec2 position, vec2 half_extent, int layer)
+{
+	unsigned int index = entity.index();
+	if (index >= entry_of.size()) {
+		entry_of.resize(Entity::num_indices(), -1);
+	}
+
+	int entry_index = entry_of[index];
+	if (entry_index != -1 && entries[entry_index].entity.id() != entity.id()) {
+		// The index was handed to a new entity since the last sync, the old one is gone
+		remove(entries[entry_index].entity);
+		entry_index = -1;
+	}
+
+	if (entry_index == -1) {
+		entry_index = (int)entries.size();
+		entries.push_back({ entity, position, half_extent, layer, -1, -1, sync_count });
+		entry_of[index] = entry_index;
+		addToCell(entry_index, getOrCreateCell(cellOf(position)));
+		num_synced++;
+	}
+	else {
+		Entry& entry = entries[entry_index];
+		if (entry.sync_count != sync_count) {
+			entry.sync_count = sync_count;
+			num_synced++;
+		}
+
+		// Most entities stand still most of the time, nothing else to do for them
+		if (entry.position == position && entry.half_extent == half_extent && entry.layer == layer) {
+			return;
+		}
+		entry.position = position;
+
+		// Only touch the cells when the centre crossed into another one
+		ivec2 cell = cellOf(position);
+		int cell_index = findCell(cell);
+		if (cell_index != entry.cell) {
+			removeFromCell(entry_index);
+			addToCell(entry_index, cell_index != -1 ? cell_index : getOrCreateCell(cell));
+		}
+
+		if (entry.half_extent == half_extent && entry.layer == layer) {
+			return;
+		}
+		entry.half_extent = half_extent;
+		entry.layer = layer;
+	}
+
+	for (int bit = 0; bit < 32; bit++) {
+		if (layer & (1 << bit)) {
+			max_half_extent[bit] = glm::max(max_half_extent[bit], glm::max(half_extent.x, half_extent.y));
+		}
+	}
+}
+
+void SpatialIndex::remove(Entity entity)
+{
+	unsigned int index = entity.index();
+	if (index >= entry_of.size() || entry_of[index] == -1 || entries[entry_of[index]].entity.id() != entity.id()) {
+		return;
+	}
+
+	int entry_index = entry_of[index];
+	if (entries[entry_index].sync_count == sync_count) {
+		num_synced--;
+	}
+	removeFromCell(entry_index);
+	entry_of[index] = -1;
+
+	// Keep the entries packed, the last one moves into the hole
+	int last = (int)entries.size() - 1;
+	if (entry_index != last) {
+		entries[entry_index] = entries[last];
+		Entry& moved = entries[entry_index];
+		entry_of[moved.entity.index()] = entry_index;
+		cells[moved.cell].entries[moved.slot] = entry_index;
+	}
+	entries.pop_back();
+}
+
+void SpatialIndex::clear()
+{
+	for (const Entry& entry : entries) {
+		entry_of[entry.entity.index()] = -1;
+	}
+	entries.clear();
+	num_synced = 0;
+	for (Cell& cell : cells) {
+		cell.entries.clear();
+	}
+	for (float& extent : max_half_extent) {
+		extent = 0;
+	}
+}
+
+void SpatialIndex::beginSync()
+{
+	sync_count++;
+	num_synced = 0;
+}
+
+void SpatialIndex::endSync()
+{
+	// Every entry was updated, so nothing left
+	if (num_synced == entries.size()) {
+		return;
+	}
+
+	// Backwards, so the entry moved into a hole has already been looked at
+	for (int i = (int)entries.size() - 1; i >= 0; i--) {
+		if (entries[i].sync_count != sync_count) {
+			remove(entries[i].entity);
+		}
+	}
+}
+
+float SpatialIndex::maxHalfExtent(int layer_mask) const
+{
+	float extent = 0;
+	for (int bit = 0; bit < 32; bit++) {
+		if (layer_mask & (1 << bit)) {
+			extent = glm::max(extent, max_half_extent[bit]);
+		}
+	}
+	return extent;
+}
+
+void SpatialIndex::queryRadius(vec2 center, float radius, int layer_mask, std::vector<Entity>& out_entities) const
+{
+	out_entities.clear();
+	if (entries.empty()) {
+		return;
+	}
+
+	ivec2 lo = glm::max(cellOf(center - vec2(radius)), cells_min);
+	ivec2 hi = glm::min(cellOf(center + vec2(radius)), cells_max);
+	for (int y = lo.y; y <= hi.y; y++) {
+		for (int x = lo.x; x <= hi.x; x++) {
+			int cell_index = findCell(ivec2(x, y));
+			if (cell_index == -1) {
+				continue;
+			}
+			for (int entry_index : cells[cell_index].entries) {
+				const Entry& entry = entries[entry_index];
+				if ((entry.layer & layer_mask) == 0 || !Entity::is_alive(entry.entity)) {
+					continue;
+				}
+				vec2 offset = entry.position - center;
+				if (glm::dot(offset, offset) <= radius * radius) {
+					out_entities.push_back(entry.entity);
+				}
+			}
+		}
+	}
+}
+
+void SpatialIndex::queryRect(vec2 min, vec2 max, int layer_mask, std::vector<Entity>& out_entities) const
+{
+	out_entities.clear();
+	if (entries.empty()) {
+		return;
+	}
+
+	// A box overlapping the rect can have its centre (and so its cell) up to its half extent outside of it
+	float margin = maxHalfExtent(layer_mask);
+	ivec2 lo = glm::max(cellOf(min - vec2(margin)), cells_min);
+	ivec2 hi = glm::min(cellOf(max + vec2(margin)), cells_max);
+	for (int y = lo.y; y <= hi.y; y++) {
+		for (int x = lo.x; x <= hi.x; x++) {
+			int cell_index = findCell(ivec2(x, y));
+			if (cell_index == -1) {
+				continue;
+			}
+			for (int entry_index : cells[cell_index].entries) {
+				const Entry& entry = entries[entry_index];
+				if ((entry.layer & layer_mask) == 0 || !Entity::is_alive(entry.entity)) {
+					continue;
+				}
+				vec2 entry_min = entry.position - entry.half_extent;
+				vec2 entry_max = entry.position + entry.half_extent;
+				if (max.x < entry_min.x || entry_max.x < min.x || max.y < entry_min.y || entry_max.y < min.y) {
+					continue;
+				}
+				out_entities.push_back(entry.entity);
+			}
+		}
+	}
+}
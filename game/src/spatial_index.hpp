@@ -0,0 +1,183 @@
+#pragma once
+
+#include "common.hpp"
+#include "tinyECS/entity.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Loose uniform grid over the entities with a hitbox, for "what is near here" questions (nearest enemy, everything in a
+// radius, everything overlapping a box) that used to loop over a whole component container.
+// Unlike the physics broadphase it isn't rebuilt, every entity sits in the cell of its centre and only moves to another
+// cell when its centre crosses into it. Boxes can stick out of their cell, so box queries look as far around as the
+// biggest box of the layers asked for. The grid grows to cover wherever entities go, and cells are created the first
+// time something enters them and are never freed, so once the level has been walked around, keeping it up to date
+// doesn't allocate.
+// Filled in by SpatialIndexSystem at the start of the frame, main thread only (everything that queries it is exclusive).
+class SpatialIndex
+{
+public:
+	SpatialIndex(float cell_size = 4 * TILE_SIZE) : cell_size(cell_size) {}
+
+	// Add the entity, or move it if it is already in the index
+	void update(Entity entity, vec2 position, vec2 half_extent, int layer);
+	void remove(Entity entity);
+	void clear();
+
+	// Everything not updated between beginSync and endSync is removed by endSync, that's how destroyed entities leave.
+	// Updating an entity that didn't move only marks it as seen, and endSync only looks for leftovers when some entity
+	// wasn't updated
+	void beginSync();
+	void endSync();
+
+	// Write the up to k entities whose layer is in layer_mask (and that pass filter) closest to point, nearest first.
+	// Distances are between centres, like the loops this replaces
+	template <typename Filter>
+	void queryNearest(vec2 point, int layer_mask, int k, std::vector<Entity>& out_entities, Filter filter) const;
+	void queryNearest(vec2 point, int layer_mask, int k, std::vector<Entity>& out_entities) const {
+		queryNearest(point, layer_mask, k, out_entities, [](Entity) { return true; });
+	}
+
+	// Write every entity whose layer is in layer_mask and whose centre is within radius of center
+	void queryRadius(vec2 center, float radius, int layer_mask, std::vector<Entity>& out_entities) const;
+
+	// Write every entity whose layer is in layer_mask and whose box overlaps [min, max]
+	void queryRect(vec2 min, vec2 max, int layer_mask, std::vector<Entity>& out_entities) const;
+
+	size_t size() const { return entries.size(); }
+	size_t numCells() const { return cells.size(); }
+
+private:
+	struct Entry {
+		Entity entity;
+		vec2 position;
+		vec2 half_extent;
+		int layer;
+		int cell;
+		int slot;	// in the entries of its cell
+		uint32_t sync_count;
+	};
+
+	struct Cell {
+		ivec2 coord;
+		std::vector<int> entries;
+	};
+
+	static const int MAX_CELL_COORD = 1024;
+
+	float cell_size;
+
+	std::vector<Entry> entries;	// packed, an entity's entry moves when one before it is removed
+	std::vector<int> entry_of;	// entry index by entity index, -1 if not in the index
+
+	std::vector<Cell> cells;
+	std::vector<int> grid;	// index in cells of every cell between grid_min and grid_max, row by row, -1 if not created yet
+	ivec2 grid_min = ivec2(0);
+	ivec2 grid_max = ivec2(-1);
+	ivec2 cells_min = ivec2(0);	// bounds of every cell ever created, inside the grid
+	ivec2 cells_max = ivec2(-1);
+
+	float max_half_extent[32] = {};	// by layer bit, only ever grows
+	uint32_t sync_count = 0;
+	size_t num_synced = 0;	// entries updated since beginSync
+
+	// Scratch space for queryNearest
+	mutable std::vector<float> nearest_distances;
+
+	ivec2 cellOf(vec2 point) const;
+	int findCell(ivec2 cell) const {
+		if (cell.x < grid_min.x || cell.y < grid_min.y || cell.x > grid_max.x || cell.y > grid_max.y) {
+			return -1;
+		}
+		return grid[(cell.y - grid_min.y) * (grid_max.x - grid_min.x + 1) + (cell.x - grid_min.x)];
+	}
+	int getOrCreateCell(ivec2 cell);
+	void growGrid(ivec2 cell);
+
+	void addToCell(int entry_index, int cell_index);
+	void removeFromCell(int entry_index);
+
+	float maxHalfExtent(int layer_mask) const;
+};
+
+// Defined in spatial_index.cpp
+extern SpatialIndex spatial_index;
+
+template <typename Filter>
+void SpatialIndex::queryNearest(vec2 point, int layer_mask, int k, std::vector<Entity>& out_entities, Filter filter) const
+{
+	out_entities.clear();
+	nearest_distances.clear();
+	if (k <= 0 || entries.empty()) {
+		return;
+	}
+
+	// Keeps the best k found so far sorted by distance, k is small so an insertion is cheap
+	auto visitCell = [&](int x, int y) {
+		int cell_index = findCell(ivec2(x, y));
+		if (cell_index == -1) {
+			return;
+		}
+		for (int entry_index : cells[cell_index].entries) {
+			const Entry& entry = entries[entry_index];
+			if ((entry.layer & layer_mask) == 0 || !Entity::is_alive(entry.entity) || !filter(entry.entity)) {
+				continue;
+			}
+
+			float distance = glm::distance(entry.position, point);
+			if ((int)out_entities.size() == k && distance >= nearest_distances.back()) {
+				continue;
+			}
+			if ((int)out_entities.size() == k) {
+				out_entities.pop_back();
+				nearest_distances.pop_back();
+			}
+			int i = (int)out_entities.size();
+			out_entities.push_back(entry.entity);
+			nearest_distances.push_back(distance);
+			for (; i > 0 && nearest_distances[i - 1] > distance; i--) {
+				std::swap(out_entities[i - 1], out_entities[i]);
+				std::swap(nearest_distances[i - 1], nearest_distances[i]);
+			}
+		}
+	};
+
+	// Go through rings of cells around the point. Anything in ring r is at least r - 1 cells away, so once we have k
+	// entities closer than that the rest can't win
+	ivec2 center = cellOf(point);
+	for (int r = 0; ; r++) {
+		if ((int)out_entities.size() == k && nearest_distances.back() <= (r - 1) * cell_size) {
+			break;
+		}
+		if (center.x - r < cells_min.x && center.x + r > cells_max.x && center.y - r < cells_min.y && center.y + r > cells_max.y) {
+			break;
+		}
+
+		int x_begin = glm::max(center.x - r, cells_min.x);
+		int x_end = glm::min(center.x + r, cells_max.x);
+		int y_begin = glm::max(center.y - r + 1, cells_min.y);
+		int y_end = glm::min(center.y + r - 1, cells_max.y);
+
+		// Top and bottom rows, then the columns in between
+		for (int y : { center.y - r, center.y + r }) {
+			if (y >= cells_min.y && y <= cells_max.y) {
+				for (int x = x_begin; x <= x_end; x++) {
+					visitCell(x, y);
+				}
+			}
+			if (r == 0) {
+				break;
+			}
+		}
+		if (r == 0) {
+			continue;
+		}
+		for (int x : { center.x - r, center.x + r }) {
+			if (x >= cells_min.x && x <= cells_max.x) {
+				for (int y = y_begin; y <= y_end; y++) {
+					visitCell(x, y);
+				}
+			}
+		}
+	}
+}
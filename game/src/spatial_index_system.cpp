@@ -0,0 +1,28 @@
+#include "spatial_index_system.hpp"
+#include "spatial_index.hpp"
+#include "physics_system.hpp"
+
+
+void SpatialIndexSystem::step(float elapsed_ms) {
+	// Level walls never move and are already in the physics system's static grid, so they are left out.
+	// Anything that lost its hitbox or was destroyed since the last step isn't updated, and endSync drops it.
+	// The registry doesn't say what changed, so every hitbox is looked at, but only the ones that moved into
+	// another cell touch the grid
+	spatial_index.beginSync();
+	auto& hitbox_registry = registry.hitboxes;
+	for (uint i = 0; i < hitbox_registry.size(); i++)
+	{
+		Entity entity = hitbox_registry.entities[i];
+		Transformation* transformation = registry.transforms.try_get(entity);
+		if (transformation == nullptr || registry.staticColliders.has(entity)) {
+			continue;
+		}
+
+		Hitbox& hitbox = hitbox_registry.components[i];
+
+		// Same box as the physics broadphase
+		vec2 half_extent = get_bounding_box(*transformation, abs(hitbox.hitbox_scale)) / 2.f;
+		spatial_index.update(entity, transformation->position, half_extent, hitbox.layer);
+	}
+	spatial_index.endSync();
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "tinyECS/tiny_ecs.hpp"
+#include "tinyECS/components.hpp"
+#include "tinyECS/registry.hpp"
+
+// Keeps spatial_index in step with the hitboxes in the registry
+class SpatialIndexSystem {
+public:
+	void step(float elapsed_ms);
+
+	SpatialIndexSystem(){}
+};
@@ -15,78 +15,70 @@
 // Static spell cast manager 
 
 class SpellCastManager {
-private:
-
-	static Spell applyRelicsAndCast(RenderSystem* renderer, SpellSlot& spell_slot, vec2 spawn_position, vec2 direction, Entity casted_by) {
-		switch (spell_slot.spell_type) {
+public:
 
+	// The slot's spell with all of its relics applied. Cloning the base spell and running the relics over it only happens
+	// when the slot's spell or relics changed since the last cast, otherwise it's the spell kept on the slot
+	static Spell* resolveSpell(SpellSlot& spell_slot) {
+		if (spell_slot.resolved_spell != nullptr && spell_slot.resolved_spell_id == spell_slot.spell_id
+			&& spell_slot.resolved_num_relics == spell_slot.relics.size()) {
+			return spell_slot.resolved_spell.get();
+		}
 
+		switch (spell_slot.spell_type) {
 		case (SPELL_TYPE::PROJECTILE): {
-
-			// Get base spell
-			ProjectileSpell* projectile_spell = projectile_spells[spell_slot.spell_id];
-
-
 			// Copy base spell (must be a pointer, otherwise it will cast to a ProjectileSpell, not an inherited class of ProjectileSpell)
 			// Munn: a solution to this is to add a Spell object to each projectile struct, but that causes a circular dependency, and I can't think of a solution to fix that?
-			ProjectileSpell* new_spell = projectile_spell->clone();
-
+			ProjectileSpell* new_spell = projectile_spells[spell_slot.spell_id]->clone();
 
 			// Apply relics to copied spell
-			for (int i = 0; i < spell_slot.relics.size(); i++) {
-
-				RELIC_ID relic_id = spell_slot.relics[i];
-				Relic* relic = relics[(int)relic_id];
-				new_spell = relic->modifyProjectileSpell(new_spell);
-
-				//std::cout << "Applied relic: " << (int)relic_id << " to projectile spell" << std::endl;
+			for (RELIC_ID relic_id : spell_slot.relics) {
+				new_spell = relics[(int)relic_id]->modifyProjectileSpell(new_spell);
 			}
-
-			// Cast copied spell
-
-			new_spell->cast(renderer, spawn_position, direction, (PROJECTILE_SPELL_ID)spell_slot.spell_id, casted_by);
-
-			// Copy spell to get cooldown information
-			Spell spell = *new_spell;
-
-			// Delete spell pointer
-			delete new_spell;
-			
-			// Return spell for cooldown information
-			return spell;
+			spell_slot.resolved_spell = std::shared_ptr<Spell>(new_spell);
+			break;
 		}
 		case (SPELL_TYPE::MOVEMENT): {
-			// Get base spell
-			MovementSpell* movement_spell = movement_spells[spell_slot.spell_id];
-
 			// Copy base spell
-			MovementSpell* new_spell = movement_spell->clone();
+			MovementSpell* new_spell = movement_spells[spell_slot.spell_id]->clone();
 
 			// Apply relics to copied spell
-			for (int i = 0; i < spell_slot.relics.size(); i++) {
-				RELIC_ID relic_id = spell_slot.relics[i];
-				Relic* relic = relics[(int)relic_id];
-				new_spell = relic->modifyMovementSpell(new_spell);
+			for (RELIC_ID relic_id : spell_slot.relics) {
+				new_spell = relics[(int)relic_id]->modifyMovementSpell(new_spell);
 			}
+			spell_slot.resolved_spell = std::shared_ptr<Spell>(new_spell);
+			break;
+		}
+		default: {
+			std::cout << "Error: Invalid spell type casted: " << (int)spell_slot.spell_type << std::endl;
+			return nullptr;
+		}
+		}
 
-			new_spell->cast(renderer, casted_by, direction);
-
-			spell_slot.remainingCooldown = new_spell->getCooldown();
+		spell_slot.resolved_spell_id = spell_slot.spell_id;
+		spell_slot.resolved_num_relics = spell_slot.relics.size();
+		return spell_slot.resolved_spell.get();
+	}
 
-			// Copy spell to get cooldown information
-			Spell spell = *new_spell;
+private:
 
-			// Delete spell pointer
-			delete new_spell;
+	// Casts the slot's spell and returns it for the cooldown information
+	static Spell& applyRelicsAndCast(RenderSystem* renderer, SpellSlot& spell_slot, vec2 spawn_position, vec2 direction, Entity casted_by) {
+		static Spell no_spell;
 
-			// Return spell for cooldown information
-			return spell;
+		Spell* spell = resolveSpell(spell_slot);
+		if (spell == nullptr) {
+			return no_spell;
 		}
-		default: {
-			std::cout << "Error: Invalid spell type casted: " << (int)spell_slot.spell_type << std::endl;
-			return Spell();
+
+		if (spell_slot.spell_type == SPELL_TYPE::PROJECTILE) {
+			((ProjectileSpell*)spell)->cast(renderer, spawn_position, direction, (PROJECTILE_SPELL_ID)spell_slot.spell_id, casted_by);
 		}
+		else {
+			((MovementSpell*)spell)->cast(renderer, casted_by, direction);
+			spell_slot.remainingCooldown = spell->getCooldown();
 		}
+		return *spell;
 	}
 	
 public:
@@ -102,7 +94,7 @@ public:
 		if (spell_slot.remainingCooldown > 0) {
 			if (spell_slot.num_casts > 0) {
 				spell_slot.num_casts -= 1;
-				Spell spell = applyRelicsAndCast(renderer, spell_slot, spawn_position, direction, casted_by);
+				Spell& spell = applyRelicsAndCast(renderer, spell_slot, spawn_position, direction, casted_by);
 
 				spell_slot.internalCooldown = spell.getInternalCastCooldown();
 			}
@@ -110,7 +102,7 @@ public:
 			return;
 		}
 
-		Spell spell = applyRelicsAndCast(renderer, spell_slot, spawn_position, direction, casted_by);
+		Spell& spell = applyRelicsAndCast(renderer, spell_slot, spawn_position, direction, casted_by);
 
 		spell_slot.num_casts = spell.getNumCasts() - 1;
 
@@ -120,15 +112,15 @@ public:
 	}
 
 	static void castBossSpell(RenderSystem* renderer, SpellSlot& spell_slot, vec2 spawn_position, vec2 direction, Entity casted_by) {
-		Spell spell = applyRelicsAndCast(renderer, spell_slot, spawn_position, direction, casted_by);
+		applyRelicsAndCast(renderer, spell_slot, spawn_position, direction, casted_by);
 	}
 	
 	// Cast a spell consecutively
 	static void castBurstSpell(RenderSystem* renderer, SpellSlot& spell_slot, vec2 spawn_position, vec2 direction, Entity casted_by, int burst_count, float delay_ms) {
 		for (int i = 0; i < burst_count; i++) {
-			std::function<void()> delayed_cast = [renderer, &spell_slot, spawn_position, direction, casted_by]() {
+			auto delayed_cast = [renderer, &spell_slot, spawn_position, direction, casted_by]() {
 				// Only cast if enemy is still alive - otherwise cast should be interrupted
-				if (registry.enemies.has(casted_by)) {
+				if (registry.is_alive(casted_by)) {
 					// Update position for subsequent casts
 					vec2 current_position = registry.transforms.get(casted_by).position;
 					applyRelicsAndCast(renderer, spell_slot, current_position, direction, casted_by);
@@ -43,12 +43,12 @@ void ProjectileSpell::onDeath(RenderSystem* renderer, Entity projectileEntity) {
 	registry.renderRequests.remove(projectileEntity);
 	registry.hitboxes.remove(projectileEntity);
 
-	std::function<void()> timeout = [projectileEntity]() { // pass in motion as a reference 
-		registry.remove_all_components_of(projectileEntity);
+	auto timeout = [projectileEntity]() { // pass in motion as a reference 
+		registry.commands.destroy(projectileEntity);
 		};
 
 	ParticleEmitterContainer& particle_container = registry.particle_emitter_containers.get(projectileEntity);
-	ParticleEmitter& particle_emitter = particle_container.particle_emitter_map[PARTICLE_EMITTER_ID::PROJECTILE_TRAIL];
+	ParticleEmitter& particle_emitter = particle_container.get(PARTICLE_EMITTER_ID::PROJECTILE_TRAIL);
 	particle_emitter.stop_emitting();
 
 	createTimer(particle_emitter.loop_duration, timeout);
@@ -154,9 +154,14 @@ void ShrapnelSpell::onDeath(RenderSystem* renderer, Entity projectileEntity) {
 		vec2 slightly_random_direction = shrapnelDirection;
 		slightly_random_direction = glm::rotate(slightly_random_direction, randRad);
 
+		// Cast at the next sync point, onDeath is called while the projectiles are being iterated
 		PROJECTILE_SPELL_ID shrapnels = PROJECTILE_SPELL_ID::THORN;
 		ProjectileSpell* spell = projectile_spells[(int)shrapnels];
-		spell->cast(renderer, transform.position, slightly_random_direction, shrapnels, projectile.owner);
+		vec2 position = transform.position;
+		Entity owner = projectile.owner;
+		registry.commands.create([spell, renderer, position, slightly_random_direction, shrapnels, owner]() {
+			spell->cast(renderer, position, slightly_random_direction, shrapnels, owner);
+		});
 
 		shrapnelDirection = glm::rotate(shrapnelDirection, (float)(2 * M_PI / numShrapnel));
 	}
@@ -210,8 +215,8 @@ void SeekingSpell::stepProjectile(Entity projectileEntity, float elapsed_ms) {
 		}
 	}
 
-	// If enemy to follow no longer exists, reset
-	if (!registry.transforms.has(seeking.target)) {
+	// If enemy to follow no longer exists (or its id was handed to another entity), reset
+	if (!registry.is_alive(seeking.target)) {
 		seeking.target = -1;
 	}
 
@@ -236,26 +241,32 @@ void SeekingSpell::stepProjectile(Entity projectileEntity, float elapsed_ms) {
 	}
 }
 
-Entity SeekingSpell::getNearestEnemyEntity(Entity projectileEntity) {
-	Transformation projectile_transform = registry.transforms.get(projectileEntity);
-	float nearest_dist = 9999999; 
+// Every enemy at its current position, whatever its hitbox layer is right now (boss_2 takes its segments off the enemy
+// layer while they're shielded) and even if it was spawned this frame. The spatial index only has the enemy layer as of
+// the start of the frame, and seeking only looks for a target when it has none, so the scan stays
+static Entity findNearestEnemy(vec2 position) {
+	float nearest_dist = 9999999;
 	Entity nearest_enemy = -1;
 	for (Entity enemy_entity : registry.enemies.entities) {
-		if (!registry.transforms.has(enemy_entity)) {
+		Transformation* enemy_transform = registry.transforms.try_get(enemy_entity);
+		if (enemy_transform == nullptr) {
 			continue;
 		}
 
-		Transformation enemy_transform = registry.transforms.get(enemy_entity);
-		float dist = glm::distance(enemy_transform.position, projectile_transform.position);
+		float dist = glm::distance(enemy_transform->position, position);
 		if (dist < nearest_dist) {
 			nearest_dist = dist;
 			nearest_enemy = enemy_entity;
 		}
 	}
-
 	return nearest_enemy;
 }
 
+Entity SeekingSpell::getNearestEnemyEntity(Entity projectileEntity) {
+	Transformation& projectile_transform = registry.transforms.get(projectileEntity);
+	return findNearestEnemy(projectile_transform.position);
+}
+
 Entity SeekingSpell::getNearestEnemyToMouse() {
 	vec2 mouse_pos = vec2(mouse_pos_x, mouse_pos_y);
 
@@ -263,24 +274,7 @@ Entity SeekingSpell::getNearestEnemyToMouse() {
 	Transformation camera_transform = registry.transforms.get(camera_entity);
 
 	vec2 mouse_world_pos = mouse_pos + camera_transform.position;
-
-	float nearest_dist = 9999999;
-	Entity nearest_enemy = -1;
-	for (Entity enemy_entity : registry.enemies.entities) {
-		if (!registry.transforms.has(enemy_entity)) {
-			continue;
-		}
-
-		Transformation enemy_transform = registry.transforms.get(enemy_entity);
-		float dist = glm::distance(enemy_transform.position, mouse_world_pos);
-
-		if (dist < nearest_dist) {
-			nearest_dist = dist;
-			nearest_enemy = enemy_entity;
-		}
-	}
-
-	return nearest_enemy;
+	return findNearestEnemy(mouse_world_pos);
 }
 
 
@@ -303,7 +297,11 @@ void BoomerangSpell::onDeath(RenderSystem* renderer, Entity projectileEntity) {
 
 	PROJECTILE_SPELL_ID shrapnels = PROJECTILE_SPELL_ID::BOOMERANG_RETURN;
 	ProjectileSpell* spell = projectile_spells[(int)shrapnels];
-	spell->cast(renderer, transform.position, direction, shrapnels, projectile.owner);
+	vec2 position = transform.position;
+	Entity owner = projectile.owner;
+	registry.commands.create([spell, renderer, position, direction, shrapnels, owner]() {
+		spell->cast(renderer, position, direction, shrapnels, owner);
+	});
 
 	ProjectileSpell::onDeath(renderer, projectileEntity); 
 }
@@ -424,7 +422,11 @@ void AreaOnDeathSpell::onDeath(RenderSystem* renderer, Entity projectileEntity)
 	// Create an AOE that lingers for duration
 	PROJECTILE_SPELL_ID aoeEffect = PROJECTILE_SPELL_ID::ACID_EFFECT;
 	ProjectileSpell* spell = projectile_spells[(int)aoeEffect];
-	spell->cast(renderer, transform.position, vec2(0), aoeEffect, projectile.owner);
+	vec2 position = transform.position;
+	Entity owner = projectile.owner;
+	registry.commands.create([spell, renderer, position, aoeEffect, owner]() {
+		spell->cast(renderer, position, vec2(0), aoeEffect, owner);
+	});
 
 	ProjectileSpell::onDeath(renderer, projectileEntity);
 }
@@ -644,13 +646,13 @@ void DashSpell::cast(RenderSystem* renderer, Entity entity, vec2 direction) {
 	motion.is_dashing = true;
 
 	ParticleEmitterContainer& particle_container = registry.particle_emitter_containers.get(entity);
-	ParticleEmitter& particle_emitter = particle_container.particle_emitter_map[PARTICLE_EMITTER_ID::DASH_TRAIL];
+	ParticleEmitter& particle_emitter = particle_container.get(PARTICLE_EMITTER_ID::DASH_TRAIL);
 
 	particle_emitter.setLoopDuration(duration);
 	particle_emitter.start_emitting();
 
 	// Munn: Using lambda functions for timer timeout callback 
-	std::function<void()> timeout = [entity]() { // pass in motion as a reference 
+	auto timeout = [entity]() { // pass in motion as a reference 
 		// DO NOT CALL FUNCTION IF ENTITY HAS DIED BEFORE TIMER TIMEOUT OCCURS
 		if (!registry.motions.has(entity) || !registry.particle_emitter_containers.has(entity)) {
 			return;
@@ -658,13 +660,13 @@ void DashSpell::cast(RenderSystem* renderer, Entity entity, vec2 direction) {
 
 		Motion& motion = registry.motions.get(entity);
 		ParticleEmitterContainer& particle_container = registry.particle_emitter_containers.get(entity);
-		ParticleEmitter& particle_emitter = particle_container.particle_emitter_map[PARTICLE_EMITTER_ID::DASH_TRAIL];
+		ParticleEmitter& particle_emitter = particle_container.get(PARTICLE_EMITTER_ID::DASH_TRAIL);
 
 		motion.is_dashing = false;
 		particle_emitter.stop_emitting();
 		};
 
-	Entity timerEntity = createTimer(duration, timeout);
+	createTimer(duration, timeout);
 }
 
 void BlinkSpell::cast(RenderSystem* renderer, Entity entity, vec2 direction) {
@@ -680,7 +682,7 @@ void BlinkSpell::cast(RenderSystem* renderer, Entity entity, vec2 direction) {
 	vec2 blink_distance = glm::normalize(direction) * this->getDistance() * num_cast_multiplier;
 
 	// Munn: Using lambda functions for timer timeout callback 
-	std::function<void()> timeout = [entity, blink_distance]() { // pass in motion as a reference 
+	auto timeout = [entity, blink_distance]() { // pass in motion as a reference 
 		
 		// DO NOT CALL FUNCTION IF ENTITY HAS DIED BEFORE TIMER TIMEOUT OCCURS
 		if (!registry.motions.has(entity) || !registry.transforms.has(entity)) {
@@ -694,5 +696,5 @@ void BlinkSpell::cast(RenderSystem* renderer, Entity entity, vec2 direction) {
 		motion.is_dashing = false;
 		};
 
-	Entity timerEntity = createTimer(castTime, timeout);
+	createTimer(castTime, timeout);
 }
\ No newline at end of file
@@ -66,14 +66,14 @@ private:
 	int damage;
 	float speed;
 	float lifetime;
-	ParticleEmitter particle_emitter;
+	const ParticleEmitterDescriptor* particle_emitter;	// shared, see the descriptors at the bottom
 public:
-	ProjectileSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, ParticleEmitter particle_emitter) : Spell(cooldown, asset_id) {
+	ProjectileSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, const ParticleEmitterDescriptor& particle_emitter) : Spell(cooldown, asset_id) {
  
 		this->damage = damage;
 		this->speed = speed;
 		this->lifetime = lifetime;
-		this->particle_emitter = particle_emitter;
+		this->particle_emitter = &particle_emitter;
 
 		setInternalCastCooldown(0.05);
 	} 
@@ -85,7 +85,7 @@ public:
 	virtual void stepProjectile(Entity projectileEntity, float elapsed_ms);
 
 	virtual ProjectileSpell* clone() {
-		ProjectileSpell* clone = new ProjectileSpell(getCooldown(), getAssetID(), this->damage, this->speed, this->lifetime, this->particle_emitter);
+		ProjectileSpell* clone = new ProjectileSpell(getCooldown(), getAssetID(), this->damage, this->speed, this->lifetime, *this->particle_emitter);
 
 		return clone;
 	}
@@ -109,11 +109,11 @@ public:
 	void setLifetime(float lifetime) {
 		this->lifetime = lifetime;
 	}
-	ParticleEmitter getParticleEmitter() {
-		return this->particle_emitter;
+	const ParticleEmitterDescriptor& getParticleEmitter() {
+		return *this->particle_emitter;
 	}
-	void setParticleEmitter(ParticleEmitter particle_emitter) {
-		this->particle_emitter = particle_emitter;
+	void setParticleEmitter(const ParticleEmitterDescriptor& particle_emitter) {
+		this->particle_emitter = &particle_emitter;
 	}
 };
 
@@ -123,7 +123,7 @@ class DeceleratingSpell : public ProjectileSpell {
 private:
 	float decelStrength;
 public:
-	DeceleratingSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float decelStrength, ParticleEmitter particle_emitter)
+	DeceleratingSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float decelStrength, const ParticleEmitterDescriptor& particle_emitter)
 		: ProjectileSpell(cooldown, asset_id, damage, speed, lifetime, particle_emitter) {
 		this->decelStrength = decelStrength;
 	}
@@ -148,7 +148,7 @@ class AcceleratingSpell : public ProjectileSpell {
 private:
 	float accelStrength;
 public:
-	AcceleratingSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float accelStrength, ParticleEmitter particle_emitter)
+	AcceleratingSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float accelStrength, const ParticleEmitterDescriptor& particle_emitter)
 		: ProjectileSpell(cooldown, asset_id, damage, speed, lifetime, particle_emitter) {
 		this->accelStrength = accelStrength;
 	}
@@ -175,7 +175,7 @@ private:
 	int numProjectiles;
 	float spreadDegrees;
 public:
-	ShotgunSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, int numProjectiles, float spreadDegrees, ParticleEmitter particle_emitter)
+	ShotgunSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, int numProjectiles, float spreadDegrees, const ParticleEmitterDescriptor& particle_emitter)
 		: ProjectileSpell(cooldown, asset_id, damage, speed, lifetime, particle_emitter) {
 		this->numProjectiles = numProjectiles;
 		this->spreadDegrees = spreadDegrees;
@@ -209,7 +209,7 @@ class ShrapnelSpell : public DeceleratingSpell {
 private:
 	int numShrapnel;
 public:
-	ShrapnelSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float decelStrength, int numShrapnel, ParticleEmitter particle_emitter)
+	ShrapnelSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float decelStrength, int numShrapnel, const ParticleEmitterDescriptor& particle_emitter)
 		: DeceleratingSpell (cooldown, asset_id, damage, speed, lifetime, decelStrength, particle_emitter) {
 		this->numShrapnel = numShrapnel;
 	}
@@ -235,7 +235,7 @@ class BoomerangSpell : public DeceleratingSpell {
 private:
 	float rotationSpeed;
 public:
-	BoomerangSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float decelStrength, float rotationSpeed, ParticleEmitter particle_emitter)
+	BoomerangSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float decelStrength, float rotationSpeed, const ParticleEmitterDescriptor& particle_emitter)
 		: DeceleratingSpell(cooldown, asset_id, damage, speed, lifetime, decelStrength, particle_emitter) {
 		this->rotationSpeed = rotationSpeed;
 	}
@@ -267,7 +267,7 @@ private:
 	Entity getNearestEnemyEntity(Entity projectileEntity);
 	Entity getNearestEnemyToMouse();
 public:
-	SeekingSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float seek_strength, ParticleEmitter particle_emitter)
+	SeekingSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float seek_strength, const ParticleEmitterDescriptor& particle_emitter)
 		: ProjectileSpell(cooldown, asset_id, damage, speed, lifetime, particle_emitter) {
 		this->seek_strength = seek_strength;
 	}
@@ -296,7 +296,7 @@ class BoomerangReturnSpell : public SeekingSpell {
 private:
 	float rotationSpeed;
 public:
-	BoomerangReturnSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float seek_strength, float rotationSpeed, ParticleEmitter particle_emitter)
+	BoomerangReturnSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float seek_strength, float rotationSpeed, const ParticleEmitterDescriptor& particle_emitter)
 		: SeekingSpell(cooldown, asset_id, damage, speed, lifetime, seek_strength, particle_emitter) {
 		this->rotationSpeed = rotationSpeed;
 	}
@@ -327,7 +327,7 @@ class RicochetSpell : public ProjectileSpell {
 private:
 	int numBounces;
 public:
-	RicochetSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, int numBounces, ParticleEmitter particle_emitter)
+	RicochetSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, int numBounces, const ParticleEmitterDescriptor& particle_emitter)
 		: ProjectileSpell(cooldown, asset_id, damage, speed, lifetime, particle_emitter) {
 		this->numBounces = numBounces;
 	}
@@ -355,7 +355,7 @@ class AreaOnDeathSpell : public ProjectileSpell {
 private:
 	float areaLifetime;
 public:
-	AreaOnDeathSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float areaLifetime, ParticleEmitter particle_emitter)
+	AreaOnDeathSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float areaLifetime, const ParticleEmitterDescriptor& particle_emitter)
 		: ProjectileSpell(cooldown, asset_id, damage, speed, lifetime, particle_emitter) {
 		this->areaLifetime = areaLifetime;
 	}
@@ -384,7 +384,7 @@ class ArcSpell : public ProjectileSpell {
 private:
 	float rotationSpeed;
 public:
-	ArcSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float rotationSpeed, ParticleEmitter particle_emitter)
+	ArcSpell(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float rotationSpeed, const ParticleEmitterDescriptor& particle_emitter)
 		: ProjectileSpell(cooldown, asset_id, damage, speed, lifetime, particle_emitter) {
 		this->rotationSpeed = rotationSpeed;
 	}
@@ -414,7 +414,7 @@ class ArcSpellLeft : public ProjectileSpell {
 private:
 	float rotationSpeed;
 public:
-	ArcSpellLeft(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float rotationSpeed, ParticleEmitter particle_emitter)
+	ArcSpellLeft(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float rotationSpeed, const ParticleEmitterDescriptor& particle_emitter)
 		: ProjectileSpell(cooldown, asset_id, damage, speed, lifetime, particle_emitter) {
 		this->rotationSpeed = rotationSpeed;
 	}
@@ -442,7 +442,7 @@ class ArcSpellRight : public ProjectileSpell {
 private:
 	float rotationSpeed;
 public:
-	ArcSpellRight(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float rotationSpeed, ParticleEmitter particle_emitter)
+	ArcSpellRight(float cooldown, TEXTURE_ASSET_ID asset_id, int damage, float speed, float lifetime, float rotationSpeed, const ParticleEmitterDescriptor& particle_emitter)
 		: ProjectileSpell(cooldown, asset_id, damage, speed, lifetime, particle_emitter) {
 		this->rotationSpeed = rotationSpeed;
 	}
@@ -472,7 +472,7 @@ public:
 // Projectile Particles
 
 const int FIREBALL_PARTICLE_SPEED = 50;
-const ParticleEmitter fireball_particles(
+const ParticleEmitterDescriptor fireball_particles(
 	12,													// number of particles
 	vec4(0.647, 0.188, 0.188, 0.75),					// color
 	vec2(-4, -4) * (float)PIXEL_SCALE_FACTOR,			// min pos offset (random)
@@ -481,7 +481,7 @@ const ParticleEmitter fireball_particles(
 	vec2(1, 1) * (float)FIREBALL_PARTICLE_SPEED			// max velocity
 );
 
-const ParticleEmitter waterball_particles(
+const ParticleEmitterDescriptor waterball_particles(
 	12,							
 	vec4(0.643, 0.867, 0.859, 0.75),
 	vec2(-1, -1) * (float)PIXEL_SCALE_FACTOR,
@@ -490,7 +490,7 @@ const ParticleEmitter waterball_particles(
 	vec2()
 );
 
-const ParticleEmitter shotgun_particles(
+const ParticleEmitterDescriptor shotgun_particles(
 	10,						
 	vec4(0, 0, 0, 0.5),
 	vec2(-3, -3) * (float)PIXEL_SCALE_FACTOR,
@@ -500,7 +500,7 @@ const ParticleEmitter shotgun_particles(
 );
 
 const int THORN_BOMB_PARTICLE_SPEED = 100;
-const ParticleEmitter thorn_bomb_particles(
+const ParticleEmitterDescriptor thorn_bomb_particles(
 	10,							
 	vec4(0.275, 0.51, 0.196, 0.5),
 	vec2(-4, -4) * (float)PIXEL_SCALE_FACTOR,
@@ -509,7 +509,7 @@ const ParticleEmitter thorn_bomb_particles(
 	vec2(1, 1) * (float)THORN_BOMB_PARTICLE_SPEED
 );
 
-const ParticleEmitter thorn_particles(
+const ParticleEmitterDescriptor thorn_particles(
 	10,							
 	vec4(0.275, 0.51, 0.196, 0.5),
 	vec2(-2, -2) * (float)PIXEL_SCALE_FACTOR,
@@ -518,7 +518,7 @@ const ParticleEmitter thorn_particles(
 	vec2()
 );
 
-const ParticleEmitter boomerang_particles(
+const ParticleEmitterDescriptor boomerang_particles(
 	15,							
 	vec4(0.533, 0.294, 0.169, 0.75),
 	vec2(-2, -2) * (float)PIXEL_SCALE_FACTOR,
@@ -527,7 +527,7 @@ const ParticleEmitter boomerang_particles(
 	vec2()
 );
 
-const ParticleEmitter magnet_particles(
+const ParticleEmitterDescriptor magnet_particles(
 	15,
 	vec4(1, 1, 1, 0.5),
 	vec2(-1, -1) * (float)PIXEL_SCALE_FACTOR,
@@ -536,7 +536,7 @@ const ParticleEmitter magnet_particles(
 	vec2()
 );
 
-const ParticleEmitter red_orb_particles(
+const ParticleEmitterDescriptor red_orb_particles(
 	5,											// number of particles
 	vec4(0.62, 0, 0, 0.75),						// color
 	vec2(-4, -4)* (float)PIXEL_SCALE_FACTOR,	// min pos offset (random)
@@ -545,7 +545,7 @@ const ParticleEmitter red_orb_particles(
 	vec2(1, 1)* (float)10						// max velocity
 );
 
-const ParticleEmitter lightning_particles(
+const ParticleEmitterDescriptor lightning_particles(
 	20,
 	vec4(1.0, 0.972, 0, 1.0),
 	vec2(-1, -1)* (float)PIXEL_SCALE_FACTOR,
@@ -554,7 +554,7 @@ const ParticleEmitter lightning_particles(
 	vec2()
 );
 
-const ParticleEmitter cutter_particles(
+const ParticleEmitterDescriptor cutter_particles(
 	10,
 	vec4(0.712, 0.775, 1, 1.0),
 	vec2(-1, -1)* (float)PIXEL_SCALE_FACTOR,
@@ -564,6 +564,25 @@ const ParticleEmitter cutter_particles(
 );
 
 
+// Movement Particles
+
+const ParticleEmitterDescriptor footstep_particles = []() {
+	ParticleEmitterDescriptor descriptor;
+	descriptor.setNumParticles(4);
+	descriptor.setInitialPosition(vec2(0, 10 * PIXEL_SCALE_FACTOR));
+	descriptor.setRandomPositionRange(vec2(-3 * PIXEL_SCALE_FACTOR, 0), vec2(3 * PIXEL_SCALE_FACTOR, 0));
+	descriptor.setInitialColor(vec4(1, 1, 1, 1));
+	return descriptor;
+}();
+
+const ParticleEmitterDescriptor dash_particles = []() {
+	ParticleEmitterDescriptor descriptor;
+	descriptor.setNumParticles(8);
+	descriptor.setInitialColor(vec4(0.75, 0.75, 1, 0.25));
+	descriptor.setTextureAssetId(TEXTURE_ASSET_ID::PLAYER_DASH_PARTICLES);
+	return descriptor;
+}();
+
 
 // Projectile Declarations
 
@@ -0,0 +1,91 @@
+#include "system_scheduler.hpp"
+
+#include "job_system.hpp"
+#include "profiler.hpp"
+#include "tinyECS/registry.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+	bool overlaps(const std::vector<const void*>& a, const std::vector<const void*>& b) {
+		for (const void* resource : a) {
+			if (std::find(b.begin(), b.end(), resource) != b.end()) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+bool SystemAccess::conflictsWith(const SystemAccess& other) const
+{
+	if (is_exclusive || other.is_exclusive) {
+		return true;
+	}
+	return overlaps(writes, other.writes) || overlaps(writes, other.reads) || overlaps(reads, other.writes);
+}
+
+void SystemScheduler::add(const char* name, SystemAccess access, std::function<void(float)> step, bool is_gameplay)
+{
+	systems.push_back({ name, access, step, is_gameplay });
+	buildStages();
+}
+
+void SystemScheduler::buildStages()
+{
+	stages.clear();
+	for (int i = 0; i < (int)systems.size(); i++) {
+		bool fits = !stages.empty();
+		if (fits) {
+			for (int other : stages.back()) {
+				if (systems[i].access.conflictsWith(systems[other].access)) {
+					fits = false;
+					break;
+				}
+			}
+		}
+
+		if (fits) {
+			stages.back().push_back(i);
+		}
+		else {
+			stages.push_back({ i });
+		}
+	}
+}
+
+void SystemScheduler::stepSystem(ScheduledSystem& system, float elapsed_ms)
+{
+	ProfileScope profile_scope(system.name);
+	auto start = std::chrono::steady_clock::now();
+	system.step(elapsed_ms);
+	system.total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void SystemScheduler::step(float elapsed_ms, bool is_gameplay_running)
+{
+	std::vector<int> stage_systems;
+	for (const std::vector<int>& stage : stages) {
+		stage_systems.clear();
+		for (int i : stage) {
+			if (!systems[i].is_gameplay || is_gameplay_running) {
+				stage_systems.push_back(i);
+			}
+		}
+
+		if (stage_systems.size() == 1) {
+			stepSystem(systems[stage_systems[0]], elapsed_ms);
+		}
+		else if (stage_systems.size() > 1) {
+			JobGroup group;
+			for (int i : stage_systems) {
+				job_system.run(group, [this, i, elapsed_ms]() { stepSystem(systems[i], elapsed_ms); });
+			}
+			job_system.wait(group);
+		}
+
+		// Sync point, entities created or destroyed during the stage are only added/removed once it is over
+		registry.apply_commands();
+	}
+}
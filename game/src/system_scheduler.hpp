@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+// What a system reads and writes during its step. Component containers (and other shared state, like rng) are told
+// apart by address, eg. reads = { &registry.transforms }. Two systems conflict if either one writes something the
+// other touches. Systems that create or destroy entities, or run callbacks that could touch anything, are exclusive.
+struct SystemAccess {
+	std::vector<const void*> reads;
+	std::vector<const void*> writes;
+	bool is_exclusive = false;
+
+	static SystemAccess exclusive() {
+		SystemAccess access;
+		access.is_exclusive = true;
+		return access;
+	}
+
+	bool conflictsWith(const SystemAccess& other) const;
+};
+
+// Steps a list of systems every frame. Neighbouring systems that don't conflict are put into one stage and run as
+// jobs at the same time, stages run one after another and the registry's recorded commands are applied in between.
+// A system is never moved past one it conflicts with, so the outcome is the same as stepping the list in order,
+// whatever the number of threads.
+class SystemScheduler
+{
+public:
+	// is_gameplay systems are skipped on the intro screen and while paused
+	void add(const char* name, SystemAccess access, std::function<void(float)> step, bool is_gameplay = true);
+
+	void step(float elapsed_ms, bool is_gameplay_running);
+
+	// Time spent in every system since the start, in the order they were added
+	int numSystems() const { return (int)systems.size(); }
+	const char* getName(int system) const { return systems[system].name; }
+	double getTotalMs(int system) const { return systems[system].total_ms; }
+
+private:
+	struct ScheduledSystem {
+		const char* name;
+		SystemAccess access;
+		std::function<void(float)> step;
+		bool is_gameplay;
+		double total_ms = 0;	// only written by the thread running the system
+	};
+	std::vector<ScheduledSystem> systems;
+	std::vector<std::vector<int>> stages;	// rebuilt when a system is added
+
+	void buildStages();
+	void stepSystem(ScheduledSystem& system, float elapsed_ms);
+};
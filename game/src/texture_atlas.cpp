@@ -0,0 +1,80 @@
+#include "texture_atlas.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+void TextureAtlas::pack(const std::vector<ivec2>& sizes)
+{
+	rects.assign(sizes.size(), { 0, ivec2(0), ivec2(0) });
+	page_heights.clear();
+	if (sizes.empty()) {
+		return;
+	}
+
+	// Tallest first keeps the shelves tight
+	std::vector<int> order(sizes.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](int a, int b) {
+		if (sizes[a].y != sizes[b].y)
+			return sizes[a].y > sizes[b].y;
+		return sizes[a].x > sizes[b].x;
+	});
+
+	int page = 0;
+	int shelf_x = 0;
+	int shelf_y = 0;
+	int shelf_height = 0;
+	page_heights.push_back(0);
+
+	for (int i : order) {
+		ivec2 padded = sizes[i] + 2 * padding;
+		assert(padded.x <= page_size && padded.y <= page_size && "Image does not fit in an atlas page");
+
+		// Row is full, start a new shelf
+		if (shelf_x + padded.x > page_size) {
+			shelf_y += shelf_height;
+			shelf_x = 0;
+			shelf_height = 0;
+		}
+		// Page is full, start a new page
+		if (shelf_y + padded.y > page_size) {
+			page++;
+			page_heights.push_back(0);
+			shelf_x = 0;
+			shelf_y = 0;
+			shelf_height = 0;
+		}
+
+		rects[i] = { page, ivec2(shelf_x, shelf_y) + padding, sizes[i] };
+		shelf_x += padded.x;
+		shelf_height = std::max(shelf_height, padded.y);
+		page_heights[page] = std::max(page_heights[page], shelf_y + shelf_height);
+	}
+}
+
+void TextureAtlas::copyImage(int index, const unsigned char* image, std::vector<unsigned char>& page_pixels, int channels) const
+{
+	const AtlasRect& rect = rects[index];
+	int page_width = page_size;
+	if (rect.size.x == 0 || rect.size.y == 0) {
+		return;
+	}
+
+	// Walk the padded area, clamping into the image repeats its edge pixels out into the padding
+	for (int y = -padding; y < rect.size.y + padding; y++) {
+		int src_y = glm::clamp(y, 0, rect.size.y - 1);
+		for (int x = -padding; x < rect.size.x + padding; x++) {
+			int src_x = glm::clamp(x, 0, rect.size.x - 1);
+			const unsigned char* src = image + channels * (src_y * rect.size.x + src_x);
+			unsigned char* dst = &page_pixels[channels * ((rect.position.y + y) * page_width + rect.position.x + x)];
+			std::copy(src, src + channels, dst);
+		}
+	}
+}
+
+vec4 TextureAtlas::getUVRect(int index) const
+{
+	const AtlasRect& rect = rects[index];
+	vec2 page = vec2(pageSize(rect.page));
+	return vec4(vec2(rect.position) / page, vec2(rect.size) / page);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "common.hpp"
+
+#include <vector>
+
+// Where a packed image ended up
+struct AtlasRect {
+	int page;
+	ivec2 position;	// of the image itself, the padding is around it
+	ivec2 size;
+};
+
+// Packs images into as few atlas pages as possible, so sprites that use different images can share a texture
+// (and a draw call). Shelf packing: images go left to right tallest first, a new shelf starts when a row is full,
+// a new page when the page is full. Every image gets `padding` pixels around it, which copyImage fills with
+// the image's edge pixels so nearest sampling right at the border never picks up a neighbour.
+class TextureAtlas
+{
+public:
+	TextureAtlas(int page_size, int padding = 1) : page_size(page_size), padding(padding) {}
+
+	// Pack all the sizes at once, rects[i] is where sizes[i] went. Images bigger than a page can't be packed
+	void pack(const std::vector<ivec2>& sizes);
+
+	const std::vector<AtlasRect>& getRects() const { return rects; }
+	int numPages() const { return (int)page_heights.size(); }
+	ivec2 pageSize(int page) const { return ivec2(page_size, page_heights[page]); }
+
+	// Copy an image into its spot of the page's pixels, including the padding. Both have `channels` bytes per pixel
+	void copyImage(int index, const unsigned char* image, std::vector<unsigned char>& page_pixels, int channels = 4) const;
+
+	// The rect of an image in page texture coordinates, xy is the offset and zw the size
+	vec4 getUVRect(int index) const;
+
+private:
+	int page_size;
+	int padding;
+	std::vector<AtlasRect> rects;
+	std::vector<int> page_heights;	// pages are only as tall as their shelves need
+};
@@ -0,0 +1,227 @@
+#include "timer_wheel.hpp"
+
+#include <cmath>
+
+TimerWheel timer_wheel;
+
+TimerWheel::TimerWheel()
+{
+}
+
+uint32_t TimerWheel::durationToTicks(float duration)
+{
+	// At least a tick, so a timer never fires in the same tick it was scheduled in. The top is kept well inside the
+	// range of the wheel, which wraps around after 2^32 ticks
+	const float MAX_TICKS = (float)(1u << 31);
+	float ticks = std::round(duration * 1000.0f / TICK_MS);
+	if (ticks < 1) {
+		return 1;
+	}
+	return ticks < MAX_TICKS ? (uint32_t)ticks : (uint32_t)MAX_TICKS;
+}
+
+int TimerWheel::allocateNode()
+{
+	int index = free_head;
+	if (index != -1) {
+		free_head = getNode(index).next;
+	}
+	else {
+		if (num_nodes == (int)pages.size() * PAGE_SIZE) {
+			pages.emplace_back(new Node[PAGE_SIZE]);
+		}
+		index = num_nodes++;
+	}
+
+	Node& node = getNode(index);
+	node.prev = -1;
+	node.next = -1;
+	num_scheduled++;
+	return index;
+}
+
+void TimerWheel::freeNode(int index)
+{
+	Node& node = getNode(index);
+	node.callback.reset();
+	node.generation++;	// outstanding handles stop matching
+	node.bucket = -1;
+	node.is_looping = false;
+	node.is_firing = false;
+	node.is_cancelled = false;
+	node.prev = -1;
+	node.next = free_head;
+	free_head = index;
+	num_scheduled--;
+}
+
+// Put the node in the bucket of the lowest level whose span still reaches its expiry. That's the first level above
+// which the expiry and the current tick have the same bits, so the slot is always one that hasn't come round yet
+void TimerWheel::link(int index)
+{
+	Node& node = getNode(index);
+	int level = 0;
+	while (level < NUM_LEVELS - 1 && (node.expires >> (LEVEL_BITS * (level + 1))) != (now >> (LEVEL_BITS * (level + 1)))) {
+		level++;
+	}
+	int slot = (node.expires >> (LEVEL_BITS * level)) & (SLOTS_PER_LEVEL - 1);
+	int bucket_index = level * SLOTS_PER_LEVEL + slot;
+
+	// Append, so timers expiring in the same tick fire in the order they were scheduled
+	Bucket& bucket = buckets[bucket_index];
+	node.bucket = bucket_index;
+	node.prev = bucket.tail;
+	node.next = -1;
+	if (bucket.tail != -1) {
+		getNode(bucket.tail).next = index;
+	}
+	else {
+		bucket.head = index;
+	}
+	bucket.tail = index;
+}
+
+void TimerWheel::unlink(int index)
+{
+	Node& node = getNode(index);
+	Bucket& bucket = buckets[node.bucket];
+	if (node.prev != -1) {
+		getNode(node.prev).next = node.next;
+	}
+	else {
+		bucket.head = node.next;
+	}
+	if (node.next != -1) {
+		getNode(node.next).prev = node.prev;
+	}
+	else {
+		bucket.tail = node.prev;
+	}
+	node.bucket = -1;
+	node.prev = -1;
+	node.next = -1;
+}
+
+// The current slot of a level above the first came round, its timers now expire within the span of a lower level
+void TimerWheel::cascade(int level)
+{
+	int slot = (now >> (LEVEL_BITS * level)) & (SLOTS_PER_LEVEL - 1);
+	Bucket& bucket = buckets[level * SLOTS_PER_LEVEL + slot];
+	int index = bucket.head;
+	bucket.head = -1;
+	bucket.tail = -1;
+	while (index != -1) {
+		int next = getNode(index).next;
+		link(index);
+		index = next;
+	}
+}
+
+void TimerWheel::fire(int index)
+{
+	unlink(index);
+
+	Node& node = getNode(index);
+	node.is_firing = true;
+	node.callback();
+
+	// Pages don't move, node is still good even if the callback scheduled more timers
+	node.is_firing = false;
+	if (node.is_looping && !node.is_cancelled) {
+		node.expires = now + node.period;
+		link(index);
+	}
+	else {
+		freeNode(index);
+	}
+}
+
+void TimerWheel::advance(float elapsed_ms)
+{
+	leftover_ms += elapsed_ms;
+	uint32_t num_ticks = (uint32_t)(leftover_ms / TICK_MS);
+	leftover_ms -= (float)num_ticks * TICK_MS;
+
+	// Nothing to fire, the buckets are all empty so there is nothing to cascade either
+	if (num_scheduled == 0) {
+		now += num_ticks;
+		return;
+	}
+
+	advance_end = now + num_ticks;
+	is_advancing = true;
+	while (now != advance_end) {
+		if (num_scheduled == 0) {
+			now = advance_end;
+			break;
+		}
+		now++;
+
+		// Crossing the boundary of a level brings its next slot down, the highest level first so its timers can
+		// carry on down through the slots of the levels below that come round at the same tick
+		int top_level = 0;
+		while (top_level < NUM_LEVELS - 1 && (now & ((1u << (LEVEL_BITS * (top_level + 1))) - 1)) == 0) {
+			top_level++;
+		}
+		for (int level = top_level; level > 0; level--) {
+			cascade(level);
+		}
+
+		Bucket& expiring = buckets[now & (SLOTS_PER_LEVEL - 1)];
+		while (expiring.head != -1) {
+			fire(expiring.head);
+		}
+	}
+	is_advancing = false;
+}
+
+bool TimerWheel::cancel(TimerHandle handle)
+{
+	if (!isScheduled(handle)) {
+		return false;
+	}
+
+	Node& node = getNode(handle.index);
+	if (node.is_firing) {
+		node.is_cancelled = true;	// freed once its callback returns
+	}
+	else {
+		unlink(handle.index);
+		freeNode(handle.index);
+	}
+	return true;
+}
+
+bool TimerWheel::isScheduled(TimerHandle handle) const
+{
+	if (handle.index < 0 || handle.index >= num_nodes) {
+		return false;
+	}
+	const Node& node = getNode(handle.index);
+	if (node.generation != handle.generation) {
+		return false;
+	}
+	return node.bucket != -1 || (node.is_firing && node.is_looping && !node.is_cancelled);
+}
+
+void TimerWheel::clear()
+{
+	for (Bucket& bucket : buckets) {
+		int index = bucket.head;
+		bucket.head = -1;
+		bucket.tail = -1;
+		while (index != -1) {
+			int next = getNode(index).next;
+			freeNode(index);
+			index = next;
+		}
+	}
+
+	// A callback clearing the wheel still has its own timer, it goes once the callback returns
+	for (int index = 0; index < num_nodes; index++) {
+		Node& node = getNode(index);
+		if (node.is_firing) {
+			node.is_cancelled = true;
+		}
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A void() callable kept in a fixed size buffer inside the object instead of on the heap like std::function does.
+// Anything that doesn't fit is a compile error rather than a hidden allocation, capture handles and values, not
+// containers. A std::function fits too (that's how createTimer keeps working), but whatever it captured is still on
+// the heap then.
+class InlineCallback
+{
+public:
+	static const size_t CAPACITY = 48;	// bytes, enough for a renderer, a spell slot, two vec2s and an entity
+
+	InlineCallback() {}
+	InlineCallback(const InlineCallback&) = delete;
+	InlineCallback& operator=(const InlineCallback&) = delete;
+	~InlineCallback() { reset(); }
+
+	template <typename Func>
+	void set(Func&& func) {
+		using Stored = std::decay_t<Func>;
+		static_assert(sizeof(Stored) <= CAPACITY, "Callback captures too much to be stored inline");
+		static_assert(alignof(Stored) <= alignof(std::max_align_t), "Callback is over aligned");
+		reset();
+		new (storage) Stored(std::forward<Func>(func));
+		invoke_func = [](void* callable) { (*(Stored*)callable)(); };
+		destroy_func = [](void* callable) { ((Stored*)callable)->~Stored(); };
+	}
+
+	void reset() {
+		if (destroy_func != nullptr) {
+			destroy_func(storage);
+		}
+		invoke_func = nullptr;
+		destroy_func = nullptr;
+	}
+
+	void operator()() { invoke_func(storage); }
+	explicit operator bool() const { return invoke_func != nullptr; }
+
+private:
+	alignas(std::max_align_t) unsigned char storage[CAPACITY];
+	void (*invoke_func)(void*) = nullptr;
+	void (*destroy_func)(void*) = nullptr;
+};
+
+// Identifies a scheduled timer, it stays safe to use after the timer fired or was cancelled (it just doesn't match anymore)
+struct TimerHandle {
+	int index = -1;
+	uint32_t generation = 0;
+};
+
+// Hierarchical timing wheel (Varghese & Lauck). Time advances in ticks of TICK_MS, the first level has a bucket for
+// each of the next 256 ticks and every level above covers 256 times the span of the one below. Scheduling and
+// cancelling are O(1), and advancing a tick only touches the bucket expiring at that tick, plus once every 256 ticks
+// the bucket of the level above that gets spread out over the lower levels.
+// Timers live in fixed size pages that never move, so a callback can schedule or cancel timers while it runs.
+// Main thread only, like the systems that create timers (they are all exclusive).
+class TimerWheel
+{
+public:
+	static const int TICK_MS = 1;
+	static const int NUM_LEVELS = 4;
+	static const int LEVEL_BITS = 8;
+	static const int SLOTS_PER_LEVEL = 1 << LEVEL_BITS;
+
+	TimerWheel();
+
+	// Call func once duration seconds from now, or every duration seconds until cancelled if is_looping.
+	// Timers scheduled from a callback start counting after the current advance
+	template <typename Func>
+	TimerHandle schedule(float duration, Func&& func, bool is_looping = false) {
+		int index = allocateNode();
+		Node& node = getNode(index);
+		node.callback.set(std::forward<Func>(func));
+		node.period = durationToTicks(duration);
+		node.is_looping = is_looping;
+		node.expires = (is_advancing ? advance_end : now) + node.period;
+		link(index);
+		return { index, node.generation };
+	}
+
+	// Returns false if the timer already fired (and wasn't looping) or was cancelled
+	bool cancel(TimerHandle handle);
+	bool isScheduled(TimerHandle handle) const;
+
+	// Run every callback that expires in the next elapsed_ms, in the order they expire
+	void advance(float elapsed_ms);
+
+	// Drop every timer without calling it
+	void clear();
+
+	int getNumScheduled() const { return num_scheduled; }
+
+private:
+	static const int PAGE_BITS = 10;
+	static const int PAGE_SIZE = 1 << PAGE_BITS;
+
+	struct Node {
+		InlineCallback callback;
+		uint32_t expires = 0;	// tick
+		uint32_t period = 0;	// in ticks
+		uint32_t generation = 1;
+		int prev = -1;
+		int next = -1;	// in its bucket, or in the free list
+		int bucket = -1;	// -1 if not in a bucket (free, or firing right now)
+		bool is_looping = false;
+		bool is_firing = false;
+		bool is_cancelled = false;
+	};
+
+	struct Bucket {
+		int head = -1;
+		int tail = -1;
+	};
+
+	std::vector<std::unique_ptr<Node[]>> pages;
+	int free_head = -1;
+	int num_nodes = 0;
+	int num_scheduled = 0;
+
+	Bucket buckets[NUM_LEVELS * SLOTS_PER_LEVEL];
+	uint32_t now = 0;	// ticks
+	uint32_t advance_end = 0;	// tick the current advance runs to
+	float leftover_ms = 0;	// the part of the last advance that didn't make a whole tick
+	bool is_advancing = false;
+
+	Node& getNode(int index) { return pages[index >> PAGE_BITS][index & (PAGE_SIZE - 1)]; }
+	const Node& getNode(int index) const { return pages[index >> PAGE_BITS][index & (PAGE_SIZE - 1)]; }
+
+	static uint32_t durationToTicks(float duration);
+
+	int allocateNode();
+	void freeNode(int index);
+
+	void link(int index);
+	void unlink(int index);
+	void cascade(int level);
+	void fire(int index);
+};
+
+// Defined in timer_wheel.cpp, advanced by TimerSystem
+extern TimerWheel timer_wheel;
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "entity.hpp"
+
+// Set of entities with O(1) insert and lookup, one slot per entity index. The slot keeps the whole id so a newer entity
+// that got the same index isn't mistaken for the one that was inserted. Clearing only resets the slots that were used.
+class EntitySet
+{
+	std::vector<unsigned int> ids;	// by entity index, 0 if not in the set
+	std::vector<Entity> entities;	// insertion order
+
+public:
+	// Returns false if the entity was already in the set
+	bool insert(Entity e) {
+		unsigned int index = e.index();
+		if (index >= ids.size())
+			ids.resize(Entity::num_indices(), 0);
+		if (ids[index] == e.id())
+			return false;
+		ids[index] = e.id();
+		entities.push_back(e);
+		return true;
+	}
+
+	bool contains(Entity e) const {
+		unsigned int index = e.index();
+		return index < ids.size() && ids[index] == e.id();
+	}
+
+	void clear() {
+		for (Entity e : entities)
+			ids[e.index()] = 0;
+		entities.clear();
+	}
+
+	const std::vector<Entity>& get_entities() const { return entities; }
+	bool empty() const { return entities.empty(); }
+	size_t size() const { return entities.size(); }
+};
+
+// Structural changes recorded while systems iterate, and applied later at a sync point (registry.apply_commands(),
+// called by the scheduler between stages). Nothing is added to or removed from a container mid-loop this way, so the
+// loops can't be invalidated and systems running as jobs can record changes too.
+// Recording is thread safe, the lookups and taking the commands are for the main thread between stages.
+class CommandBuffer
+{
+	std::mutex mutex;
+	std::vector<std::function<void()>> creations;
+	EntitySet destructions;
+
+public:
+	// Run func at the next sync point, for anything that emplaces components (createProjectile etc.)
+	void create(std::function<void()> func) {
+		std::lock_guard<std::mutex> lock(mutex);
+		creations.push_back(std::move(func));
+	}
+
+	// Remove all components of e at the next sync point. Destroying it twice, or destroying a stale handle, does nothing
+	void destroy(Entity e) {
+		if (!Entity::is_alive(e))
+			return;
+		std::lock_guard<std::mutex> lock(mutex);
+		destructions.insert(e);
+	}
+
+	// Will e be removed at the next sync point?
+	bool is_destroyed(Entity e) const { return destructions.contains(e); }
+	const std::vector<Entity>& get_destroyed() const { return destructions.get_entities(); }
+
+	bool empty() const { return creations.empty() && destructions.empty(); }
+
+	// Drop the creations recorded so far, for when the world they were meant for is torn down (eg. a level change)
+	void discard_creations() {
+		std::lock_guard<std::mutex> lock(mutex);
+		creations.clear();
+	}
+
+	// Hand over everything recorded so far, the buffer is empty afterwards
+	void take(std::vector<std::function<void()>>& out_creations, std::vector<Entity>& out_destructions) {
+		std::lock_guard<std::mutex> lock(mutex);
+		out_creations.swap(creations);
+		creations.clear();
+		out_destructions = destructions.get_entities();
+		destructions.clear();
+	}
+};
@@ -1,12 +1,16 @@
 #pragma once
 #include "common.hpp"
 #include <vector>
+#include <array>
+#include <memory>
+#include <climits>
 #include <unordered_map>
 #include <iostream>
 #include "../ext/stb_image/stb_image.h"
 
 #include "map_gen/map_node.hpp" // Munn: Kinda sus including this here
 #include "dialogue/dialogue.hpp"
+#include "particle_pool.hpp"
 
 /*
  * Munn: I'm not going to remove any components yet, so we can refer to these for inspiration for what components we'll need. 
@@ -124,6 +128,8 @@ const int movement_spell_count = (int)MOVEMENT_SPELL_ID::MOVEMENT_SPELL_COUNT;
 
 const int spell_count = projectile_spell_count + movement_spell_count;
 
+class Spell;
+
 struct SpellSlot {
 	SPELL_TYPE spell_type;
 	int spell_id;
@@ -133,6 +139,17 @@ struct SpellSlot {
 
 	float internalCooldown;
 	int num_casts;
+
+	// The spell with the relics applied, made on the first cast and reused after that (see SpellCastManager).
+	// It remembers the spell and number of relics it was made from, so changing either makes it again. Relics are only
+	// ever added, call invalidateResolvedSpell() if they are changed some other way
+	std::shared_ptr<Spell> resolved_spell;
+	int resolved_spell_id = -1;
+	size_t resolved_num_relics = 0;
+
+	void invalidateResolvedSpell() {
+		resolved_spell.reset();
+	}
 };
 
 struct SpellSlotContainer {
@@ -145,13 +162,13 @@ struct Projectile {
 	PROJECTILE_SPELL_ID spell_id;
 	float lifetime;
 	bool is_dead;
-	Entity owner; // Munn: The entity who shot it
+	Entity owner = 0; // Munn: The entity who shot it
 	float damage;
 };
 
 // Munn: Useful components to add to spells
 struct Seeking {
-	Entity target; 
+	Entity target = -1; 
 };
 
 // All data relevant to the shape and motion of entities
@@ -199,34 +216,11 @@ enum class COLLISION_MASK {
 	ENEMY_ROOM_TRIGGER = 0b1000000,
 };
 
-// Stucture to store collision information
-struct Collision
-{
-	Entity other; // the second object involved in the collision
-	Collision(Entity& other) { this->other = other; };
-};
-
 struct WallCollision {};
 
-// Create a timer, and give it a function to call on timeout 
-// Munn: This can have other functionality too, such as looping, pausing, slow motion, etc. if we decide we need functionality like that
-struct Timer {
-	float duration;
-	float current_time;
-	bool is_active;
-	bool is_looping;
-	std::function<void()> timeout;
-
-	void start() {
-		is_active = true;
-		current_time = duration;
-	}
-
-	void stop() {
-		is_active = false;
-	}
-};
-
+// Wall collisions that are baked into the level and never move or get removed until the next level loads.
+// These skip the per-frame broadphase, and are only checked against moving bodies (see PhysicsSystem::rebuildStaticGeometry)
+struct StaticCollider {};
 
 enum class TWEEN_TYPE {
 	FLOAT = 0,
@@ -497,7 +491,8 @@ enum class EFFECT_ASSET_ID {
 	TILE = HEALTH_BAR + 1,
 	FONT = TILE + 1,
 	MINIMAP = FONT + 1,
-	EFFECT_COUNT = MINIMAP + 1
+	SPRITE = MINIMAP + 1,
+	EFFECT_COUNT = SPRITE + 1
 };
 const int effect_count = (int)EFFECT_ASSET_ID::EFFECT_COUNT;
 
@@ -605,34 +600,11 @@ struct AnimationManager {
 
 
 // Particle system
-struct Particle {
-	// Runtime values
-	vec2 position = vec2(0, 0);
-	vec2 velocity = vec2(0, 0);
-	vec2 scale = vec2(1, 1);
-	vec4 color = vec4(1, 0, 0, 1);
-	float lifetime = 0;
-
-	Particle() {}
-
-	Particle(vec2 position, vec2 velocity, vec4 color, float lifetime) {
-		this->position = position;
-		this->velocity = velocity;
-		this->color = color;
-		this->lifetime = lifetime;
-	}
-};
-
-struct ParticleEmitter {
+// How an emitter spawns its particles. These are shared and never change once made (eg. fireball_particles in
+// spells.hpp), the emitters only point at them
+struct ParticleEmitterDescriptor {
 	int max_particles = 50;
-	std::vector<Particle> particles;
-
-	bool is_emitting = false;
 	float loop_duration = 1.0;
-	float current_respawn_time = 0.0;
-
-	// reference to parent transformation
-	int parent_entity = -1;
 
 	// Initial values
 	vec2 position_i = vec2(0, 0);
@@ -651,20 +623,10 @@ struct ParticleEmitter {
 
 	TEXTURE_ASSET_ID sprite_id = TEXTURE_ASSET_ID::PARTICLE;
 
-	ParticleEmitter() {
-		particles.resize(max_particles);
-		for (int i = 0; i < max_particles; i++) {
-			particles.push_back(Particle());
-		}
-	}
+	ParticleEmitterDescriptor() {}
 
 	// Parameters: num_particles, color, random_pos_range_min, random_pos_range_max, random_velocity_range_min, random_velocity_range_max
-	ParticleEmitter(int num_particles, vec4 color, vec2 random_pos_range_min, vec2 random_pos_range_max, vec2 random_velocity_range_min, vec2 random_velocity_range_max) {
-		particles.resize(max_particles);
-		for (int i = 0; i < max_particles; i++) {
-			particles.push_back(Particle());
-		}
-
+	ParticleEmitterDescriptor(int num_particles, vec4 color, vec2 random_pos_range_min, vec2 random_pos_range_max, vec2 random_velocity_range_min, vec2 random_velocity_range_max) {
 		this->max_particles = num_particles;
 		this->color_i = color;
 		this->random_position_min = random_pos_range_min;
@@ -673,14 +635,6 @@ struct ParticleEmitter {
 		this->random_velocity_max = random_velocity_range_max;
 	}
 
-	void start_emitting() {
-		is_emitting = true;
-	}
-
-	void stop_emitting() {
-		is_emitting = false;
-	}
-
 	void setNumParticles(int particles) {
 		this->max_particles = particles;
 	}
@@ -689,10 +643,6 @@ struct ParticleEmitter {
 		this->loop_duration = duration;
 	}
 
-	void setParentEntity(int entity_id) {
-		this->parent_entity = entity_id;
-	}
-
 	void setRandomPositionRange(vec2 random_position_min, vec2 random_position_max) {
 		this->random_position_min = random_position_min;
 		this->random_position_max = random_position_max;
@@ -711,21 +661,67 @@ struct ParticleEmitter {
 	}
 };
 
+// A running emitter, the particles themselves are in the particle pool and follow the entity the emitter is on
+struct ParticleEmitter {
+	const ParticleEmitterDescriptor* descriptor = nullptr; // nullptr if the slot in its container isn't used
+	ParticleRange particles;	// allocated on the first spawn
+
+	float loop_duration = 1.0;	// starts as the descriptor's, the dash trail stretches it to the dash
+	float current_respawn_time = 0.0;
+	bool is_emitting = false;
+
+	void start_emitting() {
+		is_emitting = true;
+	}
+
+	void stop_emitting() {
+		is_emitting = false;
+	}
+
+	void setLoopDuration(float duration) {
+		this->loop_duration = duration;
+	}
+};
+
 
 enum class PARTICLE_EMITTER_ID {
 	PLAYER_FOOTSTEPS = 0,
 	DASH_TRAIL = PLAYER_FOOTSTEPS + 1,
-	PROJECTILE_TRAIL = DASH_TRAIL + 1
+	PROJECTILE_TRAIL = DASH_TRAIL + 1,
+	PARTICLE_EMITTER_COUNT = PROJECTILE_TRAIL + 1
 };
+const int particle_emitter_count = (int)PARTICLE_EMITTER_ID::PARTICLE_EMITTER_COUNT;
 
+// The emitters of one entity, one slot per PARTICLE_EMITTER_ID
 struct ParticleEmitterContainer {
-	std::unordered_map<PARTICLE_EMITTER_ID, ParticleEmitter> particle_emitter_map;
+	std::array<ParticleEmitter, particle_emitter_count> emitters;
+
+	ParticleEmitter& add(PARTICLE_EMITTER_ID id, const ParticleEmitterDescriptor& descriptor) {
+		ParticleEmitter& emitter = emitters[(int)id];
+		emitter.descriptor = &descriptor;
+		emitter.loop_duration = descriptor.loop_duration;
+		return emitter;
+	}
+
+	ParticleEmitter& get(PARTICLE_EMITTER_ID id) {
+		return emitters[(int)id];
+	}
 };
 
 
+// Instance data of a particle, see particle.vs.glsl
 struct ParticleInfo {
 	mat3 transform_matrix;
 	vec4 color;
+	vec4 uv_rect;	// where the texture is on its atlas page
+};
+
+// Instance data of a batched sprite (TEXTURED and ANIMATED effects)
+struct SpriteInfo {
+	mat3 transform_matrix;
+	vec3 color;
+	vec4 frame;	// h_frames, v_frames, current_frame, is_hitflash
+	vec4 uv_rect;	// where the texture is on its atlas page
 };
 
 // Munn: the only one implemented is spells, the rest are just examples for later
@@ -810,11 +806,12 @@ struct Lootable {
 };
 
 struct Character {
-	unsigned int TextureID;  // ID handle of the glyph texture
+	unsigned int TextureID;  // ID handle of the glyph texture (the font atlas)
 	glm::ivec2   Size;       // Size of glyph
 	glm::ivec2   Bearing;    // Offset from baseline to left/top of glyph
 	unsigned int Advance;    // Offset to advance to next glyph
 	char character;
+	glm::vec4    UVRect;     // Where the glyph is in the atlas, xy offset and zw size
 };
 
 struct Text {
@@ -894,20 +891,42 @@ struct GoalManager {
 };
 
 struct NPC {
-	Entity text_entity;
+	Entity text_entity = 0;
 	NPC_NAME npc_name;
 	NPC_CONVERSATION npc_conversation;
 	int current_dialogue_index = 0;
 };
 
+// Fog of war over the walls of the level, one byte per tile (row by row, 255 once revealed) so it can be uploaded to
+// the minimap texture as is. The map is map_size x map_size tiles from tile (0, 0), found from the walls of the level.
+// Only the tiles in range of the player are looked at, and only when the player moves to another tile. Anything newly
+// revealed grows the dirty rect, which the renderer uploads and then resets
 struct Minimap {
-	std::vector<int> walls_revealed;
-	std::vector<vec2> wall_positions;
+	int map_size = 0;	// in tiles, 0 until the walls of the level have been seen
+	int num_walls = -1;	// walls the tile map was made from, it's made again when the level changes
+	std::vector<uint8_t> is_wall;
+	std::vector<uint8_t> revealed;
+	ivec2 player_tile = ivec2(INT_MIN);	// tile the last reveal was done from
+
+	ivec2 dirty_min = ivec2(INT_MAX);
+	ivec2 dirty_max = ivec2(INT_MIN);
+	bool is_resized = false;	// the texture has to be made again at the new size
+
 	float reveal_range = TILE_SIZE * 15;
 
+	bool isDirty() const { return dirty_min.x <= dirty_max.x; }
+	void clearDirty() {
+		dirty_min = ivec2(INT_MAX);
+		dirty_max = ivec2(INT_MIN);
+	}
+
 	void clear() {
-		walls_revealed.clear();
-		wall_positions.clear();
+		map_size = 0;
+		num_walls = -1;
+		is_wall.clear();
+		revealed.clear();
+		player_tile = ivec2(INT_MIN);
+		clearDirty();
 	}
 };
 
@@ -1,17 +1,42 @@
 #pragma once
 
+#include <vector>
+#include <deque>
+#include <cassert>
+
 // Unique identifier for all entities
+// The id packs an index (low bits) and a generation (high bits). Indices are recycled once an entity is released,
+// and the generation is bumped every time, so an old handle to a recycled index can be told apart from the new entity.
 class Entity
 {
     unsigned int m_id;
-    static unsigned int id_count;   // defaults to 0 (invalid), need to init 1
+
+    static unsigned int id_count;   // next never used index, defaults to 0 (invalid), need to init 1
+    static std::vector<unsigned int> generations;  // current generation of every index handed out so far
+    static std::deque<unsigned int> free_indices;  // released indices, reused oldest first
 
 public:
+    static const unsigned int INDEX_BITS = 20;
+    static const unsigned int INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static const unsigned int GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+    // Only start reusing indices once this many are free, so a single index isn't cycled through its generations too fast
+    static const unsigned int MIN_FREE_INDICES = 1024;
 
     Entity()
     {
         // ensure that each entity gets a unique ID
-        m_id = id_count++; // assign and increment
+        unsigned int index;
+        if (free_indices.size() > MIN_FREE_INDICES) {
+            index = free_indices.front();
+            free_indices.pop_front();
+        }
+        else {
+            index = id_count++; // assign and increment
+            assert(index <= INDEX_MASK && "Ran out of entity indices");
+            generations.resize(index + 1, 0);
+        }
+        m_id = (generations[index] << INDEX_BITS) | index;
     }
 
     Entity(int id) {
@@ -32,4 +57,24 @@ public:
     operator unsigned int() { return m_id; } // enables automatic casting to int
 
     unsigned int id() { return m_id; }
-};
\ No newline at end of file
+    unsigned int index() const { return m_id & INDEX_MASK; }
+    unsigned int generation() const { return m_id >> INDEX_BITS; }
+
+    // Is this handle still the live entity at its index? Stale handles (the entity was released) return false
+    static bool is_alive(Entity e) {
+        unsigned int index = e.index();
+        return index != 0 && index < generations.size() && generations[index] == e.generation();
+    }
+
+    // Give the index back for reuse, any handle still pointing at it goes stale. Releasing a stale handle does nothing
+    static void release(Entity e) {
+        if (!is_alive(e))
+            return;
+        unsigned int index = e.index();
+        generations[index] = (generations[index] + 1) & GENERATION_MASK;
+        free_indices.push_back(index);
+    }
+
+    // Number of indices ever handed out, this is what bounds the size of the sparse component indices
+    static unsigned int num_indices() { return id_count; }
+};
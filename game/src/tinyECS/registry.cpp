@@ -1,3 +1,6 @@
 #include "registry.hpp"
 
+// Before the registry, so it is destroyed after the particle emitters that hold blocks of it
+ParticlePool particle_pool;
+
 ECSRegistry registry;
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <vector>
 
 #include "tiny_ecs.hpp"
+#include "command_buffer.hpp"
 #include "components.hpp"
 #include <enemy_types/enemy_components.hpp>
 #include "enemy_room_manager.hpp"
@@ -12,43 +13,46 @@ public:
 	// callbacks to remove a particular or all entities in the system
 	std::vector<ContainerInterface*> registry_list;
 
+	// Creations and destructions recorded during a step, applied by apply_commands()
+	CommandBuffer commands;
+
 	// Manually created list of all components this game has
+	// Components that every system looks up per entity per frame use the SparseEntityIndex, the rest stay on the hash map
 	ComponentContainer<DeathTimer> deathTimers;
-	ComponentContainer<Motion> motions;
-	ComponentContainer<Transformation> transforms; // separated position from motion
-	ComponentContainer<Collision> collisions;
+	ComponentContainer<Motion, SparseEntityIndex> motions;
+	ComponentContainer<Transformation, SparseEntityIndex> transforms; // separated position from motion
 	ComponentContainer<Player> players;
-	ComponentContainer<Mesh*> meshPtrs;
-	ComponentContainer<RenderRequest> renderRequests;
+	ComponentContainer<Mesh*, SparseEntityIndex> meshPtrs;
+	ComponentContainer<RenderRequest, SparseEntityIndex> renderRequests;
 	ComponentContainer<ScreenState> screenStates;
 	ComponentContainer<Eatable> eatables;
 	ComponentContainer<Deadly> deadlys;
 	ComponentContainer<DebugComponent> debugComponents;
 	ComponentContainer<vec3> colors;
 	// MAP / ENVIRONMENT
-	ComponentContainer<Floor> floors;
-	ComponentContainer<Wall> walls;
+	ComponentContainer<Floor, SparseEntityIndex> floors;
+	ComponentContainer<Wall, SparseEntityIndex> walls;
 	ComponentContainer<Chest> chests;
 	ComponentContainer<Room> rooms;
 	// IMPORTANT: Add any new CC's below to the registry_list
 	ComponentContainer<Tower> towers;
 	ComponentContainer<GridLine> gridLines; 
-	ComponentContainer<Enemy*> enemies; // Enemies identification 
-	ComponentContainer<Projectile> projectiles;
-	ComponentContainer<Timer> timers;
-	ComponentContainer<AnimationManager> animation_managers;
-	ComponentContainer<ParticleEmitterContainer> particle_emitter_containers;
+	ComponentContainer<Enemy*, SparseEntityIndex> enemies; // Enemies identification 
+	ComponentContainer<Projectile, SparseEntityIndex> projectiles;
+	ComponentContainer<AnimationManager, SparseEntityIndex> animation_managers;
+	ComponentContainer<ParticleEmitterContainer, SparseEntityIndex> particle_emitter_containers;
 
 
 	// New ones
 	ComponentContainer<SpellSlot> spellSlots;
-	ComponentContainer<Hitbox> hitboxes;
+	ComponentContainer<Hitbox, SparseEntityIndex> hitboxes;
 	ComponentContainer<Camera> cameras;
 	ComponentContainer<SpellSlotContainer> spellSlotContainers;
-	ComponentContainer<Health> healths;
+	ComponentContainer<Health, SparseEntityIndex> healths;
 	ComponentContainer<Boss> bosses;
-	ComponentContainer<Tile> tiles;
-	ComponentContainer<WallCollision> wallCollisions;
+	ComponentContainer<Tile, SparseEntityIndex> tiles;
+	ComponentContainer<WallCollision, SparseEntityIndex> wallCollisions;
+	ComponentContainer<StaticCollider, SparseEntityIndex> staticColliders;
 	ComponentContainer<Interactable> interactables;
 	ComponentContainer<Seeking> seekings;
 	ComponentContainer<Lootable> lootables;
@@ -81,7 +85,6 @@ public:
 		registry_list.push_back(&deathTimers);
 		registry_list.push_back(&motions);
 		registry_list.push_back(&transforms);
-		registry_list.push_back(&collisions);
 		registry_list.push_back(&players);
 		registry_list.push_back(&meshPtrs);
 		registry_list.push_back(&renderRequests);
@@ -101,7 +104,6 @@ public:
 		registry_list.push_back(&enemies);
 		registry_list.push_back(&projectiles);
 		
-		registry_list.push_back(&timers);
 		registry_list.push_back(&animation_managers);
 		registry_list.push_back(&particle_emitter_containers);
 
@@ -116,6 +118,7 @@ public:
 		registry_list.push_back(&tiles);
 
 		registry_list.push_back(&wallCollisions);
+		registry_list.push_back(&staticColliders);
 		registry_list.push_back(&interactables);
 		registry_list.push_back(&seekings);
 		registry_list.push_back(&lootables);
@@ -161,7 +164,89 @@ public:
 	void remove_all_components_of(Entity e) {
 		for (ContainerInterface* reg : registry_list)
 			reg->remove(e);
+		// The entity is gone, its index can be handed out again
+		Entity::release(e);
+	}
+
+	// Sync point, runs the recorded creations and then removes the entities marked for destruction. Commands recorded
+	// while doing so (eg. a creation callback destroying something) are applied in the same call
+	void apply_commands() {
+		std::vector<std::function<void()>> creations;
+		std::vector<Entity> destructions;
+		while (!commands.empty()) {
+			commands.take(creations, destructions);
+			for (std::function<void()>& create : creations)
+				create();
+			// Handles can go stale between recording and now (eg. the level was unloaded)
+			for (Entity e : destructions)
+				if (is_alive(e))
+					remove_all_components_of(e);
+		}
+	}
+
+	// Cheap check for handles kept around (targets, owners, captured in timers) whose entity may have been removed since
+	bool is_alive(Entity e) {
+		return Entity::is_alive(e);
+	}
+
+	// Joined iteration over every entity that has all the given components, e.g.
+	//   registry.view<Transformation, Motion>().each([](Entity e, Transformation& transform, Motion& motion) { ... });
+	template <typename... Components>
+	auto view() {
+		return ComponentView<std::remove_reference_t<decltype(container_of(ComponentTag<Components>()))>...>(container_of(ComponentTag<Components>())...);
 	}
+
+private:
+	// Component type -> its container, so view can be templated on component types
+	template <typename Component> struct ComponentTag {};
+	auto& container_of(ComponentTag<DeathTimer>) { return deathTimers; }
+	auto& container_of(ComponentTag<Motion>) { return motions; }
+	auto& container_of(ComponentTag<Transformation>) { return transforms; }
+	auto& container_of(ComponentTag<Player>) { return players; }
+	auto& container_of(ComponentTag<Mesh*>) { return meshPtrs; }
+	auto& container_of(ComponentTag<RenderRequest>) { return renderRequests; }
+	auto& container_of(ComponentTag<ScreenState>) { return screenStates; }
+	auto& container_of(ComponentTag<Eatable>) { return eatables; }
+	auto& container_of(ComponentTag<Deadly>) { return deadlys; }
+	auto& container_of(ComponentTag<DebugComponent>) { return debugComponents; }
+	auto& container_of(ComponentTag<vec3>) { return colors; }
+	auto& container_of(ComponentTag<Floor>) { return floors; }
+	auto& container_of(ComponentTag<Wall>) { return walls; }
+	auto& container_of(ComponentTag<Chest>) { return chests; }
+	auto& container_of(ComponentTag<Room>) { return rooms; }
+	auto& container_of(ComponentTag<Tower>) { return towers; }
+	auto& container_of(ComponentTag<GridLine>) { return gridLines; }
+	auto& container_of(ComponentTag<Enemy*>) { return enemies; }
+	auto& container_of(ComponentTag<Projectile>) { return projectiles; }
+	auto& container_of(ComponentTag<AnimationManager>) { return animation_managers; }
+	auto& container_of(ComponentTag<ParticleEmitterContainer>) { return particle_emitter_containers; }
+	auto& container_of(ComponentTag<SpellSlot>) { return spellSlots; }
+	auto& container_of(ComponentTag<Hitbox>) { return hitboxes; }
+	auto& container_of(ComponentTag<Camera>) { return cameras; }
+	auto& container_of(ComponentTag<SpellSlotContainer>) { return spellSlotContainers; }
+	auto& container_of(ComponentTag<Health>) { return healths; }
+	auto& container_of(ComponentTag<Boss>) { return bosses; }
+	auto& container_of(ComponentTag<Tile>) { return tiles; }
+	auto& container_of(ComponentTag<WallCollision>) { return wallCollisions; }
+	auto& container_of(ComponentTag<StaticCollider>) { return staticColliders; }
+	auto& container_of(ComponentTag<Interactable>) { return interactables; }
+	auto& container_of(ComponentTag<Seeking>) { return seekings; }
+	auto& container_of(ComponentTag<Lootable>) { return lootables; }
+	auto& container_of(ComponentTag<CollisionMesh>) { return collisionMeshes; }
+	auto& container_of(ComponentTag<TutorialUse>) { return tutorialUses; }
+	auto& container_of(ComponentTag<FloorDecor>) { return floorDecors; }
+	auto& container_of(ComponentTag<Tween>) { return tweens; }
+	auto& container_of(ComponentTag<EnemyRoomManager>) { return enemyRoomManagers; }
+	auto& container_of(ComponentTag<EnvironmentObject>) { return environmentObjects; }
+	auto& container_of(ComponentTag<GoalManager>) { return goalManagers; }
+	auto& container_of(ComponentTag<Text>) { return texts; }
+	auto& container_of(ComponentTag<TextPopup>) { return textPopups; }
+	auto& container_of(ComponentTag<NPC>) { return npcs; }
+	auto& container_of(ComponentTag<Minimap>) { return minimaps; }
+	auto& container_of(ComponentTag<BackgroundImage>) { return backgroundImages; }
+	auto& container_of(ComponentTag<DialogueBox>) { return dialogueBoxes; }
+	auto& container_of(ComponentTag<Slide_Bar>) { return slideBars; }
+	auto& container_of(ComponentTag<Slide_Block>) { return slideBlocks; }
 };
 
 extern ECSRegistry registry;
\ No newline at end of file
@@ -7,6 +7,11 @@
 #include <functional>
 #include <typeindex>
 #include <assert.h>
+#include <memory>
+#include <climits>
+#include <tuple>
+#include <utility>
+#include <cstdint>
 
 #include "entity.hpp"
 
@@ -20,13 +25,72 @@ struct ContainerInterface
 	virtual bool has(Entity entity) = 0;
 };
 
+// Entity -> array index lookups used by ComponentContainer. Both have the same interface, so a container can pick
+// whichever suits it: the hash map is compact for components only a handful of entities have, the sparse set is a
+// plain array index (no hashing) for components that are looked up many times per entity per frame.
+// find() returns NOT_FOUND for entities that were never set (or erased).
+const unsigned int NOT_FOUND = UINT_MAX;
+
+// The hash map from Entity -> array index.
+class HashEntityIndex
+{
+	std::unordered_map<unsigned int, unsigned int> map_entity_componentID; // the entity is cast to uint to be hashable.
+public:
+	unsigned int find(unsigned int e) const {
+		auto it = map_entity_componentID.find(e);
+		return it != map_entity_componentID.end() ? it->second : NOT_FOUND;
+	}
+	void set(unsigned int e, unsigned int i) { map_entity_componentID[e] = i; }
+	void erase(unsigned int e) { map_entity_componentID.erase(e); }
+};
+
+// Paged sparse set, Entity -> array index is a direct lookup into fixed size pages.
+// Pages are only allocated once an entity id in their range is inserted, so sparse id ranges stay cheap.
+// Keyed by the index part of the entity only, ComponentContainer::has checks the generation.
+class SparseEntityIndex
+{
+	static const unsigned int PAGE_BITS = 12;
+	static const unsigned int PAGE_SIZE = 1 << PAGE_BITS;
+
+	std::vector<std::unique_ptr<unsigned int[]>> pages;
+
+	unsigned int* slot(unsigned int e) const {
+		e &= Entity::INDEX_MASK;
+		unsigned int page = e >> PAGE_BITS;
+		if (page >= pages.size() || !pages[page])
+			return nullptr;
+		return &pages[page][e & (PAGE_SIZE - 1)];
+	}
+public:
+	unsigned int find(unsigned int e) const {
+		unsigned int* s = slot(e);
+		return s != nullptr ? *s : NOT_FOUND;
+	}
+	void set(unsigned int e, unsigned int i) {
+		e &= Entity::INDEX_MASK;
+		unsigned int page = e >> PAGE_BITS;
+		if (page >= pages.size())
+			pages.resize(page + 1);
+		if (!pages[page]) {
+			pages[page].reset(new unsigned int[PAGE_SIZE]);
+			std::fill(pages[page].get(), pages[page].get() + PAGE_SIZE, NOT_FOUND);
+		}
+		pages[page][e & (PAGE_SIZE - 1)] = i;
+	}
+	void erase(unsigned int e) {
+		unsigned int* s = slot(e);
+		if (s != nullptr)
+			*s = NOT_FOUND;
+	}
+};
+
 // A container that stores components of type 'Component' and associated entities
-template <typename Component> // A component can be any class
+template <typename Component, typename EntityIndex = HashEntityIndex> // A component can be any class
 class ComponentContainer : public ContainerInterface
 {
 private:
-	// The hash map from Entity -> array index.
-	std::unordered_map<unsigned int, unsigned int> map_entity_componentID; // the entity is cast to uint to be hashable.
+	// Entity -> array index
+	EntityIndex map_entity_componentID;
 	bool registered = false;
 public:
 	// Container of all components of type 'Component'
@@ -46,7 +110,7 @@ public:
 		// Usually, every entity should only have one instance of each component type
 		assert(!(check_for_duplicates && has(e)) && "Entity already contained in ECS registry");
 
-		map_entity_componentID[e] = (unsigned int)components.size();
+		map_entity_componentID.set(e, (unsigned int)components.size());
 		components.push_back(std::move(c)); // the move enforces move instead of copy constructor
 		entities.push_back(e);
 		return components.back();
@@ -65,12 +129,22 @@ public:
 	// A wrapper to return the component of an entity
 	Component& get(Entity e) {
 		assert(has(e) && "Entity not contained in ECS registry");
-		return components[map_entity_componentID[e]];
+		unsigned int cID = map_entity_componentID.find(e);
+		return components[cID != NOT_FOUND ? cID : 0];
+	}
+
+	// The component of an entity, or nullptr if it doesn't have one. Same as has() followed by get(), with a single lookup
+	Component* try_get(Entity e) {
+		unsigned int cID = map_entity_componentID.find(e);
+		// The stored entity also has to match, a stale handle shares its index with whatever entity reuses it
+		if (cID == NOT_FOUND || entities[cID] != e)
+			return nullptr;
+		return &components[cID];
 	}
 
 	// Check if entity has a component of type 'Component'
 	bool has(Entity entity) {
-		return map_entity_componentID.count(entity) > 0;
+		return try_get(entity) != nullptr;
 	}
 
 	// Remove an component and pack the container to re-use the empty space
@@ -79,13 +153,13 @@ public:
 		if (has(e))
 		{
 			// Get the current position
-			int cID = map_entity_componentID[e];
+			int cID = map_entity_componentID.find(e);
 
 			// Move the last element to position cID using the move operator
 			// Note, components[cID] = components.back() would trigger the copy instead of move operator
 			components[cID] = std::move(components.back());
 			entities[cID] = entities.back(); // the entity is only a single index, copy it.
-			map_entity_componentID[entities.back()] = cID;
+			map_entity_componentID.set(entities.back(), cID);
 
 			// Erase the old component and free its memory
 			map_entity_componentID.erase(e);
@@ -98,7 +172,9 @@ public:
 	// Remove all components of type 'Component'
 	void clear()
 	{
-		map_entity_componentID.clear();
+		// Erase entity by entity, so clearing costs the number of components rather than the range of entity ids
+		for (Entity e : entities)
+			map_entity_componentID.erase(e);
 		components.clear();
 		entities.clear();
 	}
@@ -109,6 +185,13 @@ public:
 		return components.size();
 	}
 
+	// Make room for count more components, so inserting a batch of them doesn't grow the arrays again and again
+	void reserve_more(size_t count)
+	{
+		components.reserve(components.size() + count);
+		entities.reserve(entities.size() + count);
+	}
+
 	// Sort the components and associated entity assignment structures by the comparisonFunction, see std::sort
 	template <class Compare>
 	void sort(Compare comparisonFunction)
@@ -117,10 +200,91 @@ public:
 		std::sort(entities.begin(), entities.end(), comparisonFunction);
 		// Now re-arrange the components (Note, creates a new vector, which may be slow! Not sure if in-place could be faster: https://stackoverflow.com/questions/63703637/how-to-efficiently-permute-an-array-in-place-using-stdswap)
 		std::vector<Component> components_new; components_new.reserve(components.size());
-		std::transform(entities.begin(), entities.end(), std::back_inserter(components_new), [&](Entity e) { return std::move(get(e)); }); // note, the get still uses the old hash map (on purpose!)
+		std::transform(entities.begin(), entities.end(), std::back_inserter(components_new), [&](Entity e) { return std::move(components[map_entity_componentID.find(e)]); }); // note, this still uses the old index (on purpose!), get() would fail its check since the entities are already sorted
 		components = std::move(components_new); // note, we use move operations to not create unneccesary copies of objects, but memory is still allocated for the new vector
 		// Fill the new hashmap
 		for (unsigned int i = 0; i < entities.size(); i++)
-			map_entity_componentID[entities[i]] = i;
+			map_entity_componentID.set(entities[i], i);
+	}
+};
+
+// Joins several containers, walking the entities of the smallest one and handing the callback the components of
+// every container for each entity that has all of them. Get one through ECSRegistry::view.
+// Don't add or remove components of the viewed types from inside the callback.
+template <typename... Containers>
+class ComponentView
+{
+	std::tuple<Containers&...> containers;
+public:
+	ComponentView(Containers&... containers) : containers(containers...) {}
+
+	// func(Entity, Component&...) in the order the component types were given
+	template <typename Func>
+	void each(Func func)
+	{
+		each_in_range(0, size(), func);
+	}
+
+	// Number of entities each() walks (the size of the smallest container), some of them may be skipped
+	size_t size()
+	{
+		size_t smallest_size;
+		smallest_index(smallest_size);
+		return smallest_size;
+	}
+
+	// Same as each, but only over [begin, end) of the smallest container. Disjoint ranges touch disjoint entities,
+	// so they can run on different threads (see JobSystem::parallel_for)
+	template <typename Func>
+	void each_in_range(size_t begin, size_t end, Func func)
+	{
+		// Pick the loop for the smallest container once, so the per entity work is the same as a hand written loop
+		size_t smallest_size;
+		each_in_range_by(smallest_index(smallest_size), begin, end, func, std::index_sequence_for<Containers...>());
+	}
+
+private:
+	template <typename Func, size_t... I>
+	void each_in_range_by(size_t driver, size_t begin, size_t end, Func& func, std::index_sequence<I...>)
+	{
+		((driver == I ? each_driven_by<I>(begin, end, func, std::index_sequence<I...>()) : void()), ...);
+	}
+
+	// Walk the container at Driver, its component is at i already, every other container gets a single lookup
+	template <size_t Driver, typename Func, size_t... I>
+	void each_driven_by(size_t begin, size_t end, Func& func, std::index_sequence<I...>)
+	{
+		auto& driver = std::get<Driver>(containers);
+		for (size_t i = begin; i < end; i++) {
+			Entity e = driver.entities[i];
+			auto components = std::make_tuple(component_at<I, Driver>(e, i)...);
+			if (!((std::get<I>(components) != nullptr) && ...)) {
+				continue;
+			}
+			func(e, *std::get<I>(components)...);
+		}
+	}
+
+	template <size_t I, size_t Driver>
+	auto* component_at(Entity e, size_t i)
+	{
+		if constexpr (I == Driver) {
+			return &std::get<I>(containers).components[i];
+		}
+		else {
+			return std::get<I>(containers).try_get(e);
+		}
+	}
+
+	// Iterate the smallest container, every other container only has to answer a single lookup per entity
+	size_t smallest_index(size_t& out_size)
+	{
+		size_t smallest = 0;
+		size_t i = 0;
+		out_size = SIZE_MAX;
+		std::apply([&](auto&... container) {
+			((container.entities.size() < out_size ? (smallest = i, out_size = container.entities.size()) : 0, i++), ...);
+		}, containers);
+		return smallest;
 	}
 };
@@ -6,18 +6,16 @@
 
 void TweenSystem::step(float elapsed_ms) {
 
-	std::vector<Entity> to_be_destroyed;
-
-	for (Entity tween_entity : registry.tweens.entities) {
-		if (!registry.tweens.has(tween_entity)) {
-			continue;
-		}
-		Tween& tween = registry.tweens.get(tween_entity);
+	// Go by index, a callback can create tweens (they start next frame) or load another scene
+	size_t num_tweens = registry.tweens.size();
+	for (size_t i = 0; i < num_tweens && i < registry.tweens.size(); i++) {
+		Entity tween_entity = registry.tweens.entities[i];
+		Tween& tween = registry.tweens.components[i];
 
 		float stepSeconds = elapsed_ms / 1000.0f;
 
 		if (!tween.is_active) {
-			to_be_destroyed.push_back(tween_entity);
+			registry.commands.destroy(tween_entity);
 			continue;
 		}
 
@@ -56,8 +54,4 @@ void TweenSystem::step(float elapsed_ms) {
 			tweenCallback();
 		}
 	}
-
-	for (Entity entity : to_be_destroyed) {
-		registry.remove_all_components_of(entity);
-	}
 }
\ No newline at end of file
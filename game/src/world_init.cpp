@@ -120,23 +120,9 @@ Entity createPlayer(RenderSystem* renderer, vec2 position)
 	health.maxHealth = PLAYER_MAX_HEALTH;
 	health.currentHealth = PLAYER_MAX_HEALTH;
 
-	ParticleEmitter footstep_particle_emitter = ParticleEmitter();
-	footstep_particle_emitter.setNumParticles(4);
-	footstep_particle_emitter.setParentEntity(entity);
-	footstep_particle_emitter.setInitialPosition(vec2(0, 10 * PIXEL_SCALE_FACTOR));
-	footstep_particle_emitter.setRandomPositionRange(vec2(-3 * PIXEL_SCALE_FACTOR, 0), vec2(3 * PIXEL_SCALE_FACTOR, 0));
-	footstep_particle_emitter.setInitialColor(vec4(1, 1, 1, 1));
-	
-
-	ParticleEmitter dash_particle_emitter = ParticleEmitter();
-	dash_particle_emitter.setNumParticles(8);
-	dash_particle_emitter.setParentEntity(entity);
-	dash_particle_emitter.setInitialColor(vec4(0.75, 0.75, 1, 0.25));
-	dash_particle_emitter.setTextureAssetId(TEXTURE_ASSET_ID::PLAYER_DASH_PARTICLES);
-
 	ParticleEmitterContainer& particle_emitter_container = registry.particle_emitter_containers.emplace(entity);
-	particle_emitter_container.particle_emitter_map.insert(std::pair<PARTICLE_EMITTER_ID, ParticleEmitter>(PARTICLE_EMITTER_ID::PLAYER_FOOTSTEPS, footstep_particle_emitter));
-	particle_emitter_container.particle_emitter_map.insert(std::pair<PARTICLE_EMITTER_ID, ParticleEmitter>(PARTICLE_EMITTER_ID::DASH_TRAIL, dash_particle_emitter));
+	particle_emitter_container.add(PARTICLE_EMITTER_ID::PLAYER_FOOTSTEPS, footstep_particles);
+	particle_emitter_container.add(PARTICLE_EMITTER_ID::DASH_TRAIL, dash_particles);
 
 
 	// // Store the mesh based scale of player
@@ -250,7 +236,7 @@ Entity createEnemy(RenderSystem* renderer, vec2 position, ENEMY_TYPE type)
 }
 
 
-Entity createProjectile(RenderSystem* renderer, vec2 spawn_position, vec2 direction, float speed, PROJECTILE_SPELL_ID spell_id, Entity entity_type, ParticleEmitter particle_emitter) {
+Entity createProjectile(RenderSystem* renderer, vec2 spawn_position, vec2 direction, float speed, PROJECTILE_SPELL_ID spell_id, Entity entity_type, const ParticleEmitterDescriptor& particle_emitter) {
 	// reserve an entity
 	auto entity = Entity();
 
@@ -302,11 +288,8 @@ Entity createProjectile(RenderSystem* renderer, vec2 spawn_position, vec2 direct
 	//projectile_hitbox.hitbox_scale = dimension;
 	registry.hitboxes.emplace(entity, projectile_hitbox);
 
-	particle_emitter.setParentEntity(entity);
-	particle_emitter.start_emitting();
-
 	ParticleEmitterContainer& particle_emitter_container = registry.particle_emitter_containers.emplace(entity);
-	particle_emitter_container.particle_emitter_map.insert(std::pair<PARTICLE_EMITTER_ID, ParticleEmitter>(PARTICLE_EMITTER_ID::PROJECTILE_TRAIL, particle_emitter));
+	particle_emitter_container.add(PARTICLE_EMITTER_ID::PROJECTILE_TRAIL, particle_emitter).start_emitting();
 
 
 CollisionMesh& cm = registry.collisionMeshes.emplace(entity);
@@ -330,20 +313,6 @@ cm.local_points = {
 }
 
 
-Entity createTimer(float duration, std::function<void()> callable, bool is_looping) {
-	auto entity = Entity();
-
-	Timer& timer = registry.timers.emplace(entity);
-
-	timer.duration = duration;		// in seconds
-	timer.current_time = duration;
-	timer.is_active = true;
-	timer.timeout = callable;
-	timer.is_looping = is_looping;
-
-	return entity;
-} 
-
 Entity createTween(float duration, std::function<void()> callable, float* f_value, float from, float to, std::function<float(float, float, float)> interp_func) {
 	auto entity = Entity();
 
@@ -719,12 +688,12 @@ Entity createEnemySpawnIndicator(RenderSystem* renderer, vec2 position, ENEMY_TY
 
 	registry.floorDecors.emplace(entity);
 
-	std::function<void()> spawnEnemy = [renderer, position, entity, enemy_type]() { // pass in motion as a reference 
+	auto spawnEnemy = [renderer, position, entity, enemy_type]() { // pass in motion as a reference 
 		// Create entity 
 		createEnemy(renderer, position, enemy_type);
 
 		// Remove indicator
-		registry.remove_all_components_of(entity);
+		registry.commands.destroy(entity);
 	};
 
 	createTimer(SPAWN_INDICATOR_DURATION, spawnEnemy);
@@ -749,7 +718,7 @@ Entity createBossMinionSpawnIndicator(RenderSystem* renderer, vec2 position) {
 
 	registry.floorDecors.emplace(entity);
 
-	std::function<void()> spawnEnemy = [renderer, position, entity]() { // pass in motion as a reference 
+	auto spawnEnemy = [renderer, position, entity]() { // pass in motion as a reference 
 		// Create entity
 		Entity enemy = createRandomEnemy(renderer, position);
 
@@ -761,7 +730,7 @@ Entity createBossMinionSpawnIndicator(RenderSystem* renderer, vec2 position) {
 		}
 
 		// Remove indicator
-		registry.remove_all_components_of(entity);
+		registry.commands.destroy(entity);
 	};
 
 	createTimer(SPAWN_INDICATOR_DURATION, spawnEnemy);
@@ -1055,7 +1024,7 @@ Entity createAnnouncement(std::string text, vec3 color, float alpha) {
 		delete text_popup.translation;
 		registry.remove_all_components_of(entity);
 		};
-	std::function<void()> wait_timeout = [remove_timeout, entity]() {
+	auto wait_timeout = [remove_timeout, entity]() {
 		if (!registry.textPopups.has(entity)) {
 			return;
 		}
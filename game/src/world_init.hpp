@@ -5,6 +5,7 @@
 #include "render_system.hpp"
 #include "spells.hpp"
 #include <functional> // for function callbacks
+#include "timer_wheel.hpp"
 #include "enemy_types/enemy_components.hpp"
 
 
@@ -14,11 +15,16 @@ Entity createRandomEnemy(RenderSystem* renderer, vec2 position);
 
 Entity createEnemy(RenderSystem* renderer, vec2 position, ENEMY_TYPE type);
 
-Entity createProjectile(RenderSystem* renderer, vec2 spawn_position, vec2 direction, float speed, PROJECTILE_SPELL_ID spell_id, Entity entity_type, ParticleEmitter particle_emitter);
+Entity createProjectile(RenderSystem* renderer, vec2 spawn_position, vec2 direction, float speed, PROJECTILE_SPELL_ID spell_id, Entity entity_type, const ParticleEmitterDescriptor& particle_emitter);
  
 Entity createCamera(RenderSystem* renderer, vec2 position);
 
-Entity createTimer(float duration, std::function<void()> callable, bool is_looping = false);
+// Call callable after duration seconds (every duration seconds if is_looping), see TimerWheel. Pass lambdas as they are,
+// wrapping them in a std::function first still works but puts their captures on the heap
+template <typename Func>
+TimerHandle createTimer(float duration, Func&& callable, bool is_looping = false) {
+	return timer_wheel.schedule(duration, std::forward<Func>(callable), is_looping);
+}
 
 Entity createTween(float duration, std::function<void()> callable, float* f_value, float from, float to, std::function<float(float, float, float)> interp_func = lerp);
 
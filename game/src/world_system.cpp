@@ -18,6 +18,8 @@
 
 #include "dialogue/dialogue.hpp"
 
+#include "profiler.hpp"
+
 
 float mouse_pos_x = 0.0f;
 float mouse_pos_y = 0.0f;
@@ -46,6 +48,7 @@ WorldSystem::~WorldSystem() {
 
 	// Destroy all created components
 	registry.clear_all_components();
+	timer_wheel.clear();
 
 	// Close the window
 	glfwDestroyWindow(window);
@@ -273,8 +276,22 @@ void WorldSystem::pause_off() {
 	screen_state.pause_state = "";
 }
 
+// Start generating the floor the player goes to next, unless there already is one in the works or waiting
+void WorldSystem::prepareNextFloor() {
+	if (!is_next_floor_prepared || next_floor_ready.valid()) {
+		return;
+	}
+	// Seeded here on the main thread, the game's rng isn't safe to use from the worker
+	unsigned int seed = (unsigned int)rng();
+	next_floor_ready = std::async(std::launch::async, [this, seed]() { prepareFloor(next_floor, seed, vec2(0, 0)); });
+}
+
 // Mark: Function for load level
 void WorldSystem::loadLevel() {
+	PROFILE_SCOPE("loadLevel");
+
+	// Projectiles cast this frame would otherwise spawn into the new level at the next sync point
+	registry.commands.discard_creations();
 
 	for (Entity enemy_room_entity : registry.enemyRoomManagers.entities) {
 		registry.remove_all_components_of(enemy_room_entity);
@@ -382,7 +399,14 @@ void WorldSystem::loadLevel() {
 	else if (game_screen == GAME_SCREEN_ID::LEVEL_1) 
 	{
 		current_floor++; 
-		createMap(renderer, vec2(0, 0));  // Default LEVEL_1
+		if (next_floor_ready.valid()) {
+			// Usually long done, the player spent a while in the hub or the shop
+			{ PROFILE_SCOPE("waitForNextFloor"); next_floor_ready.get(); }
+			createMap(renderer, next_floor);
+		}
+		else {
+			createMap(renderer, vec2(0, 0));  // Default LEVEL_1
+		}
 		resetGoalManagerStats(); 
 		createFloorGoals();
 		goal_manager.timer_active = true;
@@ -406,6 +430,7 @@ void WorldSystem::loadLevel() {
 		current_floor = 0;
 		reset_player_spells();
 		createHubMap(renderer, vec2(0, 0));
+		prepareNextFloor();
 		resetGoalManagerStats();
 		goal_manager.timer_active = false;
 
@@ -422,6 +447,7 @@ void WorldSystem::loadLevel() {
 
 
 		createInbetweenRoom(renderer, vec2(0, 0));
+		prepareNextFloor();
 		goal_manager.timer_active = false;
 		createAnnouncement("The Shop", vec3(1.0), 1.0);
 	}
@@ -498,6 +524,14 @@ void WorldSystem::loadLevel() {
 
 	if (registry.transforms.has(player_entity)) registry.transforms.get(player_entity).position = vec2(128);
 	if (registry.transforms.has(camera_entity)) registry.transforms.get(camera_entity).position = vec2(128);*/
+
+	// The level walls are all created now, bake them for the physics system
+	if (physics != nullptr) {
+		physics->rebuildStaticGeometry();
+	}
+
+	// Same for the tile instance buffers of the renderer
+	renderer->invalidateTileLayers();
 }
 
 void WorldSystem::update_record()
@@ -533,17 +567,20 @@ void WorldSystem::update_volume() {
 void WorldSystem::init(RenderSystem* renderer_arg) {
 
 	this->renderer = renderer_arg;
+	initCollisionHandlers();
 
 	setting.init();
 	setting.load_setting();
 
 	// start playing background music indefinitely
-	std::cout << "Starting music..." << std::endl;
-	Mix_PlayMusic(background_music, -1);
-	Mix_VolumeMusic(35); // Munn: 0 means silent, 128 is max volume https://wiki.libsdl.org/SDL2_mixer/Mix_VolumeMusic
-	//Mix_VolumeMusic(setting.audio); // Munn: 0 means silent, 128 is max volume https://wiki.libsdl.org/SDL2_mixer/Mix_VolumeMusic
+	if (!is_headless) {
+		std::cout << "Starting music..." << std::endl;
+		Mix_PlayMusic(background_music, -1);
+		Mix_VolumeMusic(35); // Munn: 0 means silent, 128 is max volume https://wiki.libsdl.org/SDL2_mixer/Mix_VolumeMusic
+		//Mix_VolumeMusic(setting.audio); // Munn: 0 means silent, 128 is max volume https://wiki.libsdl.org/SDL2_mixer/Mix_VolumeMusic
 
-	update_volume();
+		update_volume();
+	}
 
 	// Set all states to default
 	restart_game();
@@ -563,7 +600,9 @@ void WorldSystem::init(RenderSystem* renderer_arg) {
 
 // Update our game world
 bool WorldSystem::step(float elapsed_ms) {
-	update_window_caption();
+	if (!is_headless) {
+		update_window_caption();
+	}
 	// PLAYER MOVEMENT
 	// Munn: this definitely should NOT be here, probably move it into some sort of player_controller_system at some point?
 	vec2 move_direction = vec2(0, 0);
@@ -799,7 +838,7 @@ void WorldSystem::update_player_animations(Entity player_entity) {
 
 void WorldSystem::update_player_particles(Entity player_entity, Motion& playerMotion) {
 	ParticleEmitterContainer& particle_emitter_container = registry.particle_emitter_containers.get(player_entity);
-	ParticleEmitter& particle_emitter = particle_emitter_container.particle_emitter_map[PARTICLE_EMITTER_ID::PLAYER_FOOTSTEPS];
+	ParticleEmitter& particle_emitter = particle_emitter_container.get(PARTICLE_EMITTER_ID::PLAYER_FOOTSTEPS);
 
 	if (glm::length(playerMotion.velocity) > 0) {
 		particle_emitter.start_emitting();
@@ -901,91 +940,104 @@ void WorldSystem::restart_game() {
 // walls - enemies players
 // enemies - players -- 2/15 meeting: No collisions for now
 void WorldSystem::handle_collisions() {
-	/*ComponentContainer<Collision>& collision_container = registry.collisions;*/
-	for (Entity collision_entity : registry.collisions.entities) {
-		if (!registry.collisions.has(collision_entity))
+	PROFILE_SCOPE("handle_collisions");
+	for (const CollisionEvent& event : physics->collision_events.getEvents()) {
+		// Removed since the physics step (the events aren't components, so they don't go with the entity)
+		if (!registry.is_alive(event.a) || !registry.is_alive(event.b)) {
 			continue;
-		Entity other_entity = registry.collisions.get(collision_entity).other;
+		}
 
 		// If either entity is "destroyed", do not calculate new collisions
-		if (std::find(to_be_destroyed.begin(), to_be_destroyed.end(), (int)collision_entity) != to_be_destroyed.end() || 
-			std::find(to_be_destroyed.begin(), to_be_destroyed.end(), (int)other_entity) != to_be_destroyed.end() || 
-			std::find(already_collided.begin(), already_collided.end(), (int)collision_entity) != already_collided.end() ||
-			std::find(already_collided.begin(), already_collided.end(), (int)other_entity) != already_collided.end()) {
+		if (registry.commands.is_destroyed(event.a) || registry.commands.is_destroyed(event.b) ||
+			already_collided.contains(event.a) || already_collided.contains(event.b)) {
+			continue;
+		}
+
+		const CollisionDispatch& dispatch = collision_handlers[collisionLayerIndex(event.layer_a)][collisionLayerIndex(event.layer_b)];
+		if (dispatch.handler == nullptr) {
 			continue;
 		}
 
-		// projectile collisions -- GUO: ik very ugly gotta figure out an optimization
-		if (registry.projectiles.has(collision_entity) && registry.enemies.has(other_entity))
-			handle_projectile_enemy_collision(collision_entity, other_entity);
-		else if (registry.enemies.has(collision_entity) && registry.projectiles.has(other_entity))
-			handle_projectile_enemy_collision(other_entity, collision_entity);
-		else if (registry.projectiles.has(collision_entity) && registry.players.has(other_entity))
-			handle_projectile_player_collision(collision_entity, other_entity);
-		else if (registry.players.has(collision_entity) && registry.projectiles.has(other_entity))
-			handle_projectile_player_collision(other_entity, collision_entity);
-		else if (registry.projectiles.has(collision_entity) && registry.wallCollisions.has(other_entity))
-			handle_projectile_wall_collision(collision_entity, other_entity);
-		else if (registry.wallCollisions.has(collision_entity) && registry.projectiles.has(other_entity))
-			handle_projectile_wall_collision(other_entity, collision_entity);
-		else if (registry.projectiles.has(collision_entity) && registry.chests.has(other_entity))
-			handle_projectile_chest_collision(collision_entity, other_entity);
-		else if (registry.chests.has(collision_entity) && registry.projectiles.has(other_entity))
-			handle_projectile_chest_collision(other_entity, collision_entity);
-		// wall collisions
-		else if (registry.wallCollisions.has(collision_entity) && registry.enemies.has(other_entity))
-			handle_wall_enemy_collision(collision_entity, other_entity);
-		else if (registry.enemies.has(collision_entity) && registry.wallCollisions.has(other_entity))
-			handle_wall_enemy_collision(other_entity, collision_entity);
-		else if (registry.wallCollisions.has(collision_entity) && registry.players.has(other_entity))
-			handle_wall_player_collision(collision_entity, other_entity);
-		else if (registry.players.has(collision_entity) && registry.wallCollisions.has(other_entity))
-			handle_wall_player_collision(other_entity, collision_entity);
-		// enemy - player
-		else if (registry.players.has(collision_entity) && registry.enemies.has(other_entity))
-			handle_player_enemy_collision(collision_entity, other_entity);
-		else if (registry.enemies.has(collision_entity) && registry.players.has(other_entity))
-			handle_player_enemy_collision(other_entity, collision_entity);
-		else if (registry.players.has(collision_entity) && registry.enemyRoomManagers.has(other_entity))
-			handle_player_enemy_room_collision(collision_entity, other_entity);
-		else if (registry.players.has(other_entity) && registry.enemyRoomManagers.has(collision_entity))
-			handle_player_enemy_room_collision(other_entity, collision_entity);
-
-		else if (registry.projectiles.has(other_entity) && registry.environmentObjects.has(collision_entity))
-			handle_projectile_environment_object_collision(other_entity, collision_entity);
-		else if (registry.projectiles.has(collision_entity) && registry.environmentObjects.has(other_entity))
-			handle_projectile_environment_object_collision(collision_entity, other_entity);
-
-		else if (registry.players.has(collision_entity) && registry.environmentObjects.has(other_entity))
-			handle_wall_player_collision(other_entity, collision_entity);
-		else if (registry.players.has(other_entity) && registry.environmentObjects.has(collision_entity))
-			handle_wall_player_collision(collision_entity, other_entity);
-
-		else if (registry.enemies.has(collision_entity) && registry.environmentObjects.has(other_entity))
-			handle_wall_enemy_collision(other_entity, collision_entity);
-		else if (registry.enemies.has(other_entity) && registry.environmentObjects.has(collision_entity))
-			handle_wall_enemy_collision(collision_entity, other_entity);
-	}
-
-	for (std::vector<Entity>::iterator it = to_be_destroyed.begin(); it != to_be_destroyed.end();)
+		if (dispatch.is_swapped)
+			(this->*dispatch.handler)(event.b, event.a);
+		else
+			(this->*dispatch.handler)(event.a, event.b);
+	}
+
+	// The dead are removed at the sync point after this system, drop their loot while they still have a position
+	for (Entity entity : registry.commands.get_destroyed())
 	{
-		if (registry.lootables.has(*it)) {
-			Lootable& l = registry.lootables.get(*it);
-			if (registry.transforms.has(*it)) {
-				Transformation t = registry.transforms.get(*it);
+		if (registry.lootables.has(entity)) {
+			Lootable& l = registry.lootables.get(entity);
+			if (registry.transforms.has(entity)) {
+				Transformation t = registry.transforms.get(entity);
 				createInteractableDrop(renderer, t.position, l.drop);
 
 				std::cout << "LOOT DROPPED" << std::endl;
 			}
 		}
-		registry.remove_all_components_of(*it);
-		it++;
 	}
 
 	already_collided.clear();
-	to_be_destroyed.clear();
+}
+
+void WorldSystem::setCollisionHandler(COLLISION_LAYER first_layer, COLLISION_LAYER second_layer, CollisionHandler handler)
+{
+	setCollisionHandler(collisionLayerIndex((int)first_layer), collisionLayerIndex((int)second_layer), handler);
+}
+
+void WorldSystem::setCollisionHandler(int first_layer_index, int second_layer_index, CollisionHandler handler)
+{
+	collision_handlers[first_layer_index][second_layer_index] = { handler, false };
+	if (first_layer_index != second_layer_index) {
+		collision_handlers[second_layer_index][first_layer_index] = { handler, true };
+	}
+}
+
+// Layer pairs that nothing happens for (eg. projectile - projectile) are left empty
+void WorldSystem::initCollisionHandlers()
+{
+	for (COLLISION_LAYER projectile_layer : { COLLISION_LAYER::P_PROJECTILE, COLLISION_LAYER::E_PROJECTILE }) {
+		setCollisionHandler(projectile_layer, COLLISION_LAYER::ENEMY, &WorldSystem::handle_projectile_enemy_layer_collision);
+		setCollisionHandler(projectile_layer, COLLISION_LAYER::PLAYER, &WorldSystem::handle_projectile_player_collision);
+		setCollisionHandler(projectile_layer, COLLISION_LAYER::WALL, &WorldSystem::handle_projectile_wall_layer_collision);
+	}
+
+	setCollisionHandler(COLLISION_LAYER::WALL, COLLISION_LAYER::ENEMY, &WorldSystem::handle_wall_enemy_layer_collision);
+	setCollisionHandler(COLLISION_LAYER::WALL, COLLISION_LAYER::PLAYER, &WorldSystem::handle_wall_player_collision);
+	setCollisionHandler(COLLISION_LAYER::PLAYER, COLLISION_LAYER::ENEMY, &WorldSystem::handle_player_enemy_layer_collision);
+	setCollisionHandler(COLLISION_LAYER::PLAYER, COLLISION_LAYER::ENEMY_ROOM_TRIGGER, &WorldSystem::handle_player_enemy_room_collision);
+
+	// The boss_2 segment that can't be hit has no layer, but still gets pushed out of walls
+	setCollisionHandler(collisionLayerIndex((int)COLLISION_LAYER::WALL), NO_COLLISION_LAYER, &WorldSystem::handle_wall_enemy_layer_collision);
+}
+
+void WorldSystem::handle_projectile_enemy_layer_collision(Entity projectile_entity, Entity other_entity)
+{
+	if (registry.enemies.has(other_entity))
+		handle_projectile_enemy_collision(projectile_entity, other_entity);
+	else if (registry.chests.has(other_entity))
+		handle_projectile_chest_collision(projectile_entity, other_entity);
+}
 
-	registry.collisions.clear();
+void WorldSystem::handle_projectile_wall_layer_collision(Entity projectile_entity, Entity other_entity)
+{
+	if (registry.wallCollisions.has(other_entity))
+		handle_projectile_wall_collision(projectile_entity, other_entity);
+	else if (registry.environmentObjects.has(other_entity))
+		handle_projectile_environment_object_collision(projectile_entity, other_entity);
+}
+
+void WorldSystem::handle_wall_enemy_layer_collision(Entity wall_entity, Entity other_entity)
+{
+	if (registry.enemies.has(other_entity))
+		handle_wall_enemy_collision(wall_entity, other_entity);
+}
+
+void WorldSystem::handle_player_enemy_layer_collision(Entity player_entity, Entity other_entity)
+{
+	if (registry.enemies.has(other_entity))
+		handle_player_enemy_collision(player_entity, other_entity);
 }
 
 void WorldSystem::handle_projectile_enemy_collision(Entity projectile_entity, Entity enemy_entity)
@@ -1000,7 +1052,7 @@ void WorldSystem::handle_projectile_enemy_collision(Entity projectile_entity, En
 	if (projectile.damage != 0)
 		createTextPopup(std::to_string((int)projectile.damage), DAMAGE_NUMBER_COLOR, 1.0, vec2(0.5), 0, enemy_transform.position, false);
 	if (enemyHP <= 0) {
-		to_be_destroyed.push_back(enemy_entity);
+		registry.commands.destroy(enemy_entity);
 		current_kills++;
 		GoalManager& goal_manager = registry.goalManagers.components[0];
 		goal_manager.current_kills++;
@@ -1010,7 +1062,7 @@ void WorldSystem::handle_projectile_enemy_collision(Entity projectile_entity, En
 		RenderRequest& rr = registry.renderRequests.get(enemy_entity);
 		rr.is_hitflash = true;
 
-		std::function<void()> timeout = [enemy_entity]() {
+		auto timeout = [enemy_entity]() {
 			if (!registry.renderRequests.has(enemy_entity)) {
 				return;
 			}
@@ -1025,7 +1077,7 @@ void WorldSystem::handle_projectile_enemy_collision(Entity projectile_entity, En
 
 	spell->onDeath(renderer, projectile_entity);
 
-	already_collided.push_back(projectile_entity);
+	already_collided.insert(projectile_entity);
 }
 
 void WorldSystem::notify_room_manager() {
@@ -1062,14 +1114,14 @@ void WorldSystem::handle_projectile_chest_collision(Entity projectile_entity, En
 	Transformation transform = registry.transforms.get(chest_entity);
 	createTextPopup(std::to_string((int)projectile.damage), DAMAGE_NUMBER_COLOR, 1.0, vec2(0.5), 0, transform.position, false);
 	if (chestHP <= 0) {
-		to_be_destroyed.push_back(chest_entity);
+		registry.commands.destroy(chest_entity);
 		//std::cout << "Enemy killed" << std::endl;
 	} else if (registry.renderRequests.has(chest_entity)) { // Only hitflash if enemy is not dead
 
 		RenderRequest& rr = registry.renderRequests.get(chest_entity);
 		rr.is_hitflash = true;
 
-		std::function<void()> timeout = [chest_entity]() {
+		auto timeout = [chest_entity]() {
 			if (!registry.renderRequests.has(chest_entity)) {
 				return;
 			}
@@ -1082,7 +1134,7 @@ void WorldSystem::handle_projectile_chest_collision(Entity projectile_entity, En
 
 	spell->onDeath(renderer, projectile_entity);
 
-	already_collided.push_back(projectile_entity);
+	already_collided.insert(projectile_entity);
 }
 
 void WorldSystem::handle_projectile_player_collision(Entity projectile_entity, Entity player_entity)
@@ -1092,7 +1144,7 @@ void WorldSystem::handle_projectile_player_collision(Entity projectile_entity, E
 	auto& player = registry.players.get(player_entity);
 	
 	if (projectile.owner == player_entity) {
-		// already_collided.push_back(projectile_entity);
+		// already_collided.insert(projectile_entity);
 		return;
 	}
 
@@ -1112,7 +1164,7 @@ void WorldSystem::handle_projectile_player_collision(Entity projectile_entity, E
 	RenderRequest& rr = registry.renderRequests.get(player_entity);
 	rr.is_hitflash = true;
 
-	std::function<void()> timeout = [player_entity]() {
+	auto timeout = [player_entity]() {
 		if (!registry.renderRequests.has(player_entity)) {
 			return;
 		}
@@ -1130,7 +1182,7 @@ void WorldSystem::handle_projectile_player_collision(Entity projectile_entity, E
 
 	spell->onDeath(renderer, projectile_entity);
 
-	already_collided.push_back(projectile_entity);
+	already_collided.insert(projectile_entity);
 
 	GoalManager& goal_manager = registry.goalManagers.components[0];
 	goal_manager.current_times_hit++;
@@ -1192,7 +1244,7 @@ void WorldSystem::handle_projectile_wall_collision(Entity projectile_entity, Ent
 	else 
 	{
 		spell->onDeath(renderer, projectile_entity);
-		already_collided.push_back(projectile_entity);
+		already_collided.insert(projectile_entity);
 	}
 	
 }
@@ -1372,7 +1424,7 @@ void WorldSystem::removeWallsFromRoom(Entity room_manager_entity) {
 	EnemyRoomManager& room_manager = registry.enemyRoomManagers.get(room_manager_entity);
 
 	for (int entity : room_manager.wall_entities) {
-		registry.remove_all_components_of(entity);
+		registry.commands.destroy(entity);
 	}
 }
 
@@ -1381,7 +1433,7 @@ void WorldSystem::handle_projectile_environment_object_collision(Entity projecti
 	ProjectileSpell* spell = projectile_spells[(int)projectile.spell_id];
 	spell->onDeath(renderer, projectile_entity);
 
-	already_collided.push_back(projectile_entity);
+	already_collided.insert(projectile_entity);
 
 	if (!registry.healths.has(environment_object_entity)) {
 		return;
@@ -1391,14 +1443,14 @@ void WorldSystem::handle_projectile_environment_object_collision(Entity projecti
 	health.currentHealth -= projectile.damage;
 
 	if (health.currentHealth <= 0) {
-		to_be_destroyed.push_back(environment_object_entity);
+		registry.commands.destroy(environment_object_entity);
 	}
 	else if (registry.renderRequests.has(environment_object_entity)) { // Only hitflash if enemy is not dead
 
 		RenderRequest& rr = registry.renderRequests.get(environment_object_entity);
 		rr.is_hitflash = true;
 
-		std::function<void()> timeout = [environment_object_entity]() {
+		auto timeout = [environment_object_entity]() {
 			if (!registry.renderRequests.has(environment_object_entity)) {
 				return;
 			}
@@ -1437,6 +1489,22 @@ void WorldSystem::update_key_held_map() {
 // on key callback
 void WorldSystem::on_key(int key, int, int action, int mod) {
 
+	// Profiler keys work on every screen: F3 shows the overlay, F4 dumps the last seconds as a chrome trace
+	if (action == GLFW_PRESS && key == GLFW_KEY_F3) {
+		profiler.is_overlay_enabled = !profiler.is_overlay_enabled;
+		return;
+	}
+	if (action == GLFW_PRESS && key == GLFW_KEY_F4) {
+		std::string trace_path = profiler.dumpChromeTrace(profiler.dump_seconds);
+		if (trace_path.empty()) {
+			std::cerr << "ERROR: Failed to write the profiler trace" << std::endl;
+		}
+		else {
+			std::cout << "Wrote the last " << profiler.dump_seconds << " seconds to " << trace_path << std::endl;
+		}
+		return;
+	}
+
 	// If you are in a cutscene, go to the next cutscene
 	if ((int)game_screen >= (int)GAME_SCREEN_ID::CUTSCENE_INTRO && action == GLFW_PRESS) {
 
@@ -1605,6 +1673,11 @@ void WorldSystem::on_interact_pressed(int key, int mods) {
 	for (Entity entity : registry.interactables.entities) {
 		Interactable& interactable = registry.interactables.get(entity);
 
+		// Picked up already, it's only removed at the next sync point
+		if (registry.commands.is_destroyed(entity)) {
+			continue;
+		}
+
 		if (interactable.can_interact && !interactable.disabled) {
 
 			switch (interactable.interactable_id) {
@@ -1978,6 +2051,12 @@ void WorldSystem::update_window_caption() {
 
 	title_ss << "FPS: " << fps << " / ";
 
+	title_ss << "Tiles: " << renderer->tile_chunks_drawn << " chunks, " << renderer->tile_instances_drawn << " instances / ";
+
+	title_ss << "Sprites: " << renderer->sprites_drawn << " in " << renderer->sprite_draw_calls << " draws / ";
+
+	title_ss << "Particles: " << renderer->particles_drawn << " in " << renderer->particle_draw_calls << " draws / ";
+
 	glfwSetWindowTitle(window, title_ss.str().c_str());
 	
 }
@@ -2036,7 +2115,7 @@ void WorldSystem::startPlayerDeathSequence() {
 	hitbox.mask = 0;
 
 	// Fade screen to black
-	std::function<void()> timeout = [this, player_entity]() {
+	auto timeout = [this, player_entity]() {
 		Entity screen_state_entity = registry.screenStates.entities[0];
 		ScreenState& screen_state = registry.screenStates.get(screen_state_entity);
 		screen_state.darken_screen_factor = 0.0;
@@ -2062,7 +2141,7 @@ void WorldSystem::startPlayerDeathSequence() {
 				AnimationManager& animation_manager = registry.animation_managers.get(player_entity);
 				animation_manager.current_animation.play();
 
-				std::function<void()> timeout = [this, player_entity]() {
+				auto timeout = [this, player_entity]() {
 					AnimationManager& animation_manager = registry.animation_managers.get(player_entity);
 					animation_manager.transition_to(TEXTURE_ASSET_ID::PLAYER_IDLE, true);
 					is_player_input_enabled = true;
@@ -6,14 +6,20 @@
 // stlib
 #include <vector>
 #include <random>
+#include <future>
 
 #define SDL_MAIN_HANDLED
 #include <SDL.h>
 #include <SDL_mixer.h>
 
 #include "render_system.hpp"
+#include "tinyECS/command_buffer.hpp"
+#include "collision_events.hpp"
 
 #include "reloadability.hpp"
+#include "map_gen/map_gen.hpp"
+
+class PhysicsSystem;
  
 void createFloorGoals(); 
 void resetGoalManagerStats();
@@ -71,6 +77,15 @@ public:
 
 	Setting setting = Setting();
 
+	// Needed so loadLevel can rebake the static level collisions
+	PhysicsSystem* physics = nullptr;
+
+	// Running without a window or audio (see headless_runner.hpp), set before init
+	bool is_headless = false;
+	// Off generates every floor when it is entered, the way it was before. Only there to time both (headless runner
+	// --no-floor-prep)
+	bool is_next_floor_prepared = true;
+
 private:
 
 	// A map to keep track of whether a key is currently being held
@@ -92,10 +107,10 @@ private:
 	void restart_game();
 
 	// OpenGL window handle
-	GLFWwindow* window;
+	GLFWwindow* window = nullptr;
 
-	std::vector<Entity> to_be_destroyed;
-	std::vector<Entity> already_collided;
+	// Projectiles that already hit something this frame, entities that died go to registry.commands
+	EntitySet already_collided;
 
 	void handle_projectile_enemy_collision(Entity projectile_entity, Entity enemy_entity);
 	void handle_projectile_chest_collision(Entity projectile_entity, Entity chest_entity);
@@ -106,6 +121,23 @@ private:
 	void handle_player_enemy_collision(Entity player_entity, Entity enemy_entity);
 	void handle_player_enemy_room_collision(Entity player_entity, Entity enemy_room_entity);
 	void handle_projectile_environment_object_collision(Entity projectile_entity, Entity environment_object_entity);
+
+	// Which handler a collision goes to, by the layers of the two entities. Filled in by initCollisionHandlers
+	typedef void (WorldSystem::*CollisionHandler)(Entity first_entity, Entity second_entity);
+	struct CollisionDispatch {
+		CollisionHandler handler = nullptr;
+		bool is_swapped = false;	// the handler takes the two entities the other way round
+	};
+	CollisionDispatch collision_handlers[NUM_COLLISION_LAYER_SLOTS][NUM_COLLISION_LAYER_SLOTS];
+	void initCollisionHandlers();
+	void setCollisionHandler(COLLISION_LAYER first_layer, COLLISION_LAYER second_layer, CollisionHandler handler);
+	void setCollisionHandler(int first_layer_index, int second_layer_index, CollisionHandler handler);
+
+	// Chests share the enemy layer and breakable objects share the wall layer, these pick the handler by component
+	void handle_projectile_enemy_layer_collision(Entity projectile_entity, Entity other_entity);
+	void handle_projectile_wall_layer_collision(Entity projectile_entity, Entity other_entity);
+	void handle_wall_enemy_layer_collision(Entity wall_entity, Entity other_entity);
+	void handle_player_enemy_layer_collision(Entity player_entity, Entity other_entity);
 	void on_interact_pressed(int key, int mods);
 
 	void notify_room_manager();
@@ -144,11 +176,11 @@ private:
 	std::vector<Entity> grid_lines;
 
 	// music references
-	Mix_Music* background_music;
-	Mix_Chunk* pipe;
-	Mix_Chunk* player_hurt;
-	Mix_Chunk* enemy_spawned;
-	Mix_Chunk* enemy_hurt;
+	Mix_Music* background_music = nullptr;
+	Mix_Chunk* pipe = nullptr;
+	Mix_Chunk* player_hurt = nullptr;
+	Mix_Chunk* enemy_spawned = nullptr;
+	Mix_Chunk* enemy_hurt = nullptr;
 
 
 	// Munn: some private helpers for movement and key presses
@@ -167,6 +199,13 @@ private:
 
 	int current_kills = 0;
 	int current_floor;
+
+	// The next floor, prepared on a worker thread while the player is in the hub or the shop, so entering it only has
+	// to create its entities. next_floor belongs to the worker until next_floor_ready is ready (declared after it, so
+	// it is waited on before next_floor is destroyed)
+	FloorBlueprint next_floor;
+	std::future<void> next_floor_ready;
+	void prepareNextFloor();
 	bool is_in_combat = false;
 
 	std::vector<int> keys;